@@ -96,10 +96,59 @@ void bench_mp_sqrt()
     _bench_mp_sqrt(4);
 }
 
+void _bench_sieve(const unsigned limit)
+{
+    std::vector<unsigned> primes;
+    cout << "Sieve::generate_primes(primes, " << limit << "): ";
+    auto t1 = std::chrono::high_resolution_clock::now();
+    SymEngine::Sieve::generate_primes(primes, limit);
+    auto t2 = std::chrono::high_resolution_clock::now();
+    cout << std::chrono::duration_cast<std::chrono::milliseconds>(t2 - t1)
+                .count()
+         << "ms (" << primes.size() << " primes)" << endl;
+}
+void bench_sieve()
+{
+    _bench_sieve(10000000);
+    _bench_sieve(100000000);
+    _bench_sieve(1000000000);
+    // Largest limit of the unsigned API
+    _bench_sieve(4294967295u);
+    cout << endl;
+}
+
+void _bench_factor(const char *n)
+{
+    SymEngine::map_integer_uint primes_mul;
+    cout << "prime_factor_multiplicities(primes_mul, " << n << "): ";
+    auto t1 = std::chrono::high_resolution_clock::now();
+    prime_factor_multiplicities(primes_mul,
+                                *integer(SymEngine::integer_class(n)));
+    auto t2 = std::chrono::high_resolution_clock::now();
+    cout << std::chrono::duration_cast<std::chrono::milliseconds>(t2 - t1)
+                .count()
+         << "ms" << endl;
+}
+void bench_factor()
+{
+    // Semiprimes with balanced factors of 10 to 30 digits
+    _bench_factor("8969607293875213171");
+    _bench_factor("177414629690814939579005302357");
+    _bench_factor("929729977027117934816387551280601340919");
+    _bench_factor("59386268140072006381981271087056632346446798031903");
+    _bench_factor("221927294824746732722945081421646"
+                  "119174123194284789179349373");
+    // A 15 digit factor of a 55 digit number, found by ECM
+    _bench_factor("2619588152883247709729824161373193335644047127125501611");
+    cout << endl;
+}
+
 int main()
 {
     bench_mertens();
     bench_mobius();
     bench_prime_factor_multiplicities();
     bench_mp_sqrt();
+    bench_sieve();
+    bench_factor();
 }
\ No newline at end of file
@@ -83,8 +83,8 @@ public:
                              const Ptr<RCP<const Basic>> &term);
     //! \return `true` if a given dictionary and a coefficient is in canonical
     //! form
-    bool is_canonical(const RCP<const Number> &coef,
-                      const umap_basic_num &dict) const;
+    static bool is_canonical(const RCP<const Number> &coef,
+                             const umap_basic_num &dict);
 
     /*!
         Returns the arguments of the Add.
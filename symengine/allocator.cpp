@@ -0,0 +1,288 @@
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <vector>
+
+#include <symengine/allocator.h>
+
+#ifdef WITH_SYMENGINE_THREAD_SAFE
+#include <atomic>
+#include <mutex>
+#define SYMENGINE_THREAD_LOCAL thread_local
+#else
+#define SYMENGINE_THREAD_LOCAL
+#endif
+
+namespace SymEngine
+{
+
+namespace
+{
+
+// All blocks are multiples of `granularity` bytes, which also gives the
+// alignment of the nodes.
+const std::size_t granularity = 16;
+const std::size_t num_classes = node_pool_max_size / granularity;
+// Pools and arenas carve their blocks out of chunks aligned to their size,
+// so the chunk owning a block is found by masking the address.
+const std::size_t chunk_size = std::size_t(1) << 18;
+const std::size_t chunk_header_size = granularity;
+
+struct ChunkHeader {
+    // The arena owning the chunk, nullptr for pool chunks.
+    NodeArena *arena;
+};
+
+struct FreeBlock {
+    FreeBlock *next;
+};
+
+inline std::size_t size_class(std::size_t size)
+{
+    return (size + granularity - 1) / granularity - 1;
+}
+
+inline ChunkHeader *chunk_of(void *p)
+{
+    return reinterpret_cast<ChunkHeader *>(reinterpret_cast<std::uintptr_t>(p)
+                                           & ~(chunk_size - 1));
+}
+
+void *allocate_chunk(NodeArena *owner)
+{
+    void *p;
+#ifdef _WIN32
+    p = _aligned_malloc(chunk_size, chunk_size);
+    if (p == nullptr)
+        throw std::bad_alloc();
+#else
+    if (posix_memalign(&p, chunk_size, chunk_size) != 0)
+        throw std::bad_alloc();
+#endif
+    static_cast<ChunkHeader *>(p)->arena = owner;
+    return p;
+}
+
+void free_chunk(void *p)
+{
+#ifdef _WIN32
+    _aligned_free(p);
+#else
+    std::free(p);
+#endif
+}
+
+// Splits a new chunk into blocks of size class `cls`.
+FreeBlock *carve_chunk(std::size_t cls)
+{
+    const std::size_t block_size = (cls + 1) * granularity;
+    char *chunk = static_cast<char *>(allocate_chunk(nullptr));
+    char *end = chunk + chunk_size;
+    FreeBlock *head = nullptr;
+    for (char *p = chunk + chunk_header_size; p + block_size <= end;
+         p += block_size) {
+        FreeBlock *b = reinterpret_cast<FreeBlock *>(p);
+        b->next = head;
+        head = b;
+    }
+    return head;
+}
+
+// Pool chunks are never returned to the system, the free blocks are reused
+// for the lifetime of the process. `PoolState` is a POD so that it is still
+// usable while static (or thread local) objects are being destroyed.
+struct PoolState {
+    FreeBlock *free[num_classes];
+    bool retired;
+};
+
+SYMENGINE_THREAD_LOCAL PoolState pool_state;
+SYMENGINE_THREAD_LOCAL NodeArena *current_arena = nullptr;
+
+#ifdef WITH_SYMENGINE_THREAD_SAFE
+// Free blocks of the threads that have exited
+FreeBlock *depot_free[num_classes];
+
+std::mutex &depot_mutex()
+{
+    static std::mutex *m = new std::mutex();
+    return *m;
+}
+
+void depot_push(std::size_t cls, FreeBlock *head)
+{
+    if (head == nullptr)
+        return;
+    FreeBlock *tail = head;
+    while (tail->next != nullptr)
+        tail = tail->next;
+    std::lock_guard<std::mutex> lock(depot_mutex());
+    tail->next = depot_free[cls];
+    depot_free[cls] = head;
+}
+
+FreeBlock *depot_take(std::size_t cls)
+{
+    std::lock_guard<std::mutex> lock(depot_mutex());
+    FreeBlock *head = depot_free[cls];
+    depot_free[cls] = nullptr;
+    return head;
+}
+
+// Hands the free lists of an exiting thread over to the depot. Nodes freed
+// by the thread after this point go straight to the depot.
+struct PoolGuard {
+    ~PoolGuard()
+    {
+        for (std::size_t cls = 0; cls < num_classes; cls++) {
+            depot_push(cls, pool_state.free[cls]);
+            pool_state.free[cls] = nullptr;
+        }
+        pool_state.retired = true;
+    }
+};
+
+void register_thread()
+{
+    static thread_local PoolGuard guard;
+    (void)guard;
+}
+#endif
+
+void *pool_refill(std::size_t cls)
+{
+    FreeBlock *head = nullptr;
+#ifdef WITH_SYMENGINE_THREAD_SAFE
+    if (pool_state.retired) {
+        std::lock_guard<std::mutex> lock(depot_mutex());
+        head = depot_free[cls];
+        if (head == nullptr)
+            head = carve_chunk(cls);
+        depot_free[cls] = head->next;
+        return head;
+    }
+    register_thread();
+    head = depot_take(cls);
+#endif
+    if (head == nullptr)
+        head = carve_chunk(cls);
+    pool_state.free[cls] = head->next;
+    return head;
+}
+
+} // namespace
+
+class NodeArena
+{
+private:
+    std::vector<void *> chunks_;
+    char *cur_;
+    char *end_;
+    std::size_t allocated_;
+// One reference for the scope plus one for every live node.
+#ifdef WITH_SYMENGINE_THREAD_SAFE
+    std::atomic<std::size_t> refs_;
+#else
+    std::size_t refs_;
+#endif
+
+public:
+    NodeArena() : cur_(nullptr), end_(nullptr), allocated_(0), refs_(1)
+    {
+    }
+
+    ~NodeArena()
+    {
+        for (void *c : chunks_)
+            free_chunk(c);
+    }
+
+    void *allocate(std::size_t size)
+    {
+        size = (size + granularity - 1) / granularity * granularity;
+        if (cur_ == nullptr or cur_ + size > end_) {
+            char *chunk = static_cast<char *>(allocate_chunk(this));
+            chunks_.push_back(chunk);
+            cur_ = chunk + chunk_header_size;
+            end_ = chunk + chunk_size;
+        }
+        void *p = cur_;
+        cur_ += size;
+        allocated_ += size;
+        ++refs_;
+        return p;
+    }
+
+    void release()
+    {
+        if (--refs_ == 0)
+            delete this;
+    }
+
+    std::size_t allocated_bytes() const
+    {
+        return allocated_;
+    }
+};
+
+void *node_allocate(std::size_t size)
+{
+    if (size > node_pool_max_size)
+        return ::operator new(size);
+    if (current_arena != nullptr)
+        return current_arena->allocate(size);
+    const std::size_t cls = size_class(size);
+    FreeBlock *b = pool_state.free[cls];
+    if (b == nullptr)
+        return pool_refill(cls);
+    pool_state.free[cls] = b->next;
+    return b;
+}
+
+void node_deallocate(void *p, std::size_t size)
+{
+    if (p == nullptr)
+        return;
+    if (size > node_pool_max_size) {
+        ::operator delete(p);
+        return;
+    }
+    ChunkHeader *chunk = chunk_of(p);
+    if (chunk->arena != nullptr) {
+        chunk->arena->release();
+        return;
+    }
+    const std::size_t cls = size_class(size);
+    FreeBlock *b = static_cast<FreeBlock *>(p);
+#ifdef WITH_SYMENGINE_THREAD_SAFE
+    if (pool_state.retired) {
+        b->next = nullptr;
+        depot_push(cls, b);
+        return;
+    }
+    // A thread that only frees nodes allocated by others must also hand its
+    // free lists over when it exits
+    if (pool_state.free[cls] == nullptr)
+        register_thread();
+#endif
+    b->next = pool_state.free[cls];
+    pool_state.free[cls] = b;
+}
+
+ArenaScope::ArenaScope() : arena_(new NodeArena()), previous_(current_arena)
+{
+    current_arena = arena_;
+}
+
+ArenaScope::~ArenaScope()
+{
+    current_arena = previous_;
+    arena_->release();
+}
+
+std::size_t ArenaScope::allocated_bytes() const
+{
+    return arena_->allocated_bytes();
+}
+
+} // namespace SymEngine
@@ -0,0 +1,75 @@
+/**
+ *  \file allocator.h
+ *  Pool and arena allocation of expression nodes
+ *
+ **/
+
+#ifndef SYMENGINE_ALLOCATOR_H
+#define SYMENGINE_ALLOCATOR_H
+
+#include <cstddef>
+
+#include <symengine/symengine_config.h>
+
+namespace SymEngine
+{
+
+/*! Allocation policy for the nodes created through `make_rcp`.
+
+    When SymEngine is built with WITH_SYMENGINE_POOL_ALLOCATOR, `Basic`
+    overrides `operator new` and `operator delete` to call
+    `node_allocate()` and `node_deallocate()`. Requests of up to
+    `node_pool_max_size` bytes (this covers `Symbol`, `Integer`, `Add`,
+    `Mul`, `Pow` and the one argument functions) are served from size-class
+    free lists that are carved out of large chunks, larger requests go to the
+    global `operator new`.
+
+    The free lists are thread local when WITH_SYMENGINE_THREAD_SAFE is
+    enabled, a node can be freed by a thread different from the one that
+    allocated it. The free lists of a thread that exits are handed over to
+    the other threads.
+*/
+const std::size_t node_pool_max_size = 256;
+
+//! Allocates `size` bytes for an expression node
+void *node_allocate(std::size_t size);
+//! Frees a block obtained from `node_allocate` with the same `size`
+void node_deallocate(void *p, std::size_t size);
+
+class NodeArena;
+
+/*! While an `ArenaScope` is alive, the nodes allocated by the current thread
+    are bump allocated from an arena instead of the pools. Freeing an arena
+    node is a no-op and the whole arena is released at once as soon as the
+    scope has ended and none of its nodes is referenced anymore. Results that
+    outlive the scope therefore keep the whole arena alive; use it for
+    computations whose intermediate expressions die together.
+
+        {
+            ArenaScope scope;
+            RCP<const Basic> e = expand(pow(add(x, y), integer(20)));
+            r = coeff(e, x, integer(5));
+        }
+        // the arena is released together with `e` and `r`
+
+    Scopes can be nested, the innermost one is active.
+*/
+class ArenaScope
+{
+private:
+    NodeArena *arena_;
+    NodeArena *previous_;
+
+public:
+    ArenaScope();
+    ~ArenaScope();
+    ArenaScope(const ArenaScope &) = delete;
+    ArenaScope &operator=(const ArenaScope &) = delete;
+
+    //! Number of bytes handed out by this arena so far
+    std::size_t allocated_bytes() const;
+};
+
+} // namespace SymEngine
+
+#endif // SYMENGINE_ALLOCATOR_H
@@ -26,6 +26,10 @@
 #include <symengine/symengine_config.h>
 #include <symengine/symengine_exception.h>
 
+#ifdef WITH_SYMENGINE_POOL_ALLOCATOR
+#include <symengine/allocator.h>
+#endif
+
 #ifdef WITH_SYMENGINE_THREAD_SAFE
 #include <atomic>
 #endif
@@ -128,6 +132,21 @@ public:
     //! Assignment operator in continuation with above
     Basic &operator=(Basic &&) = delete;
 
+#ifdef WITH_SYMENGINE_POOL_ALLOCATOR
+    //! Nodes are allocated from the pools (or the active arena), see
+    //! allocator.h
+    static void *operator new(std::size_t size)
+    {
+        return node_allocate(size);
+    }
+    //! `size` is the size of the dynamic type because the destructor is
+    //! virtual
+    static void operator delete(void *p, std::size_t size)
+    {
+        node_deallocate(p, size);
+    }
+#endif
+
     /*!
         Calculates the hash of the given SymEngine class.
         Use Basic.hash() which gives a cached version of the hash.
@@ -169,6 +188,19 @@ public:
      */
     std::string __str__() const;
 
+    /*! Returns a compact binary representation of `self` that is read back
+        by `loads`. Shared subexpressions are stored once and the integers
+        as machine words, see serialize.cpp for the format. A `Dummy` is
+        loaded as a new dummy, one for each `Dummy` of `self`.
+     */
+    std::string dumps() const;
+
+    /*! Creates the expression serialized by `dumps`. Throws
+        SymEngineException if `serialized` is malformed or was written with
+        another version of the format.
+     */
+    static RCP<const Basic> loads(const std::string &serialized);
+
     //! Substitutes 'subs_dict' into 'self'.
     RCP<const Basic> subs(const map_basic_basic &subs_dict) const;
 
@@ -248,6 +280,12 @@ bool is_same_type(const Basic &a, const Basic &b);
 
 //! Expands `self`
 RCP<const Basic> expand(const RCP<const Basic> &self, bool deep = true);
+/*! Sets the number of threads used by `expand` for large products and
+    powers of sums, 0 (the default) uses the OpenMP default. Only has an
+    effect when SymEngine is built with WITH_OPENMP.
+*/
+void set_expand_num_threads(unsigned n);
+unsigned get_expand_num_threads();
 void as_numer_denom(const RCP<const Basic> &x,
                     const Ptr<RCP<const Basic>> &numer,
                     const Ptr<RCP<const Basic>> &denom);
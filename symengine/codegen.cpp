@@ -0,0 +1,89 @@
+#include <algorithm>
+
+#include <symengine/codegen.h>
+#include <symengine/subs.h>
+
+namespace SymEngine
+{
+
+std::string ccode_function(const std::string &name, const vec_basic &args,
+                           const vec_basic &exprs)
+{
+    // The inputs are read from `in` directly
+    map_basic_basic in;
+    for (size_t i = 0; i < args.size(); i++) {
+        if (not is_a<Symbol>(*args[i])) {
+            throw SymEngineException("'args' must contain Symbols only");
+        }
+        in[args[i]] = symbol("in[" + to_string(i) + "]");
+    }
+    vec_basic outputs;
+    outputs.reserve(exprs.size());
+    for (const auto &e : exprs) {
+        outputs.push_back(e->subs(in));
+    }
+
+    vec_pair replacements;
+    vec_basic reduced;
+    cse(replacements, reduced, outputs);
+
+    // The temporaries used by each temporary and output
+    std::unordered_map<RCP<const Basic>, unsigned, RCPBasicHash, RCPBasicKeyEq>
+        index;
+    for (unsigned i = 0; i < replacements.size(); i++) {
+        index[replacements[i].first] = i;
+    }
+    auto dependencies = [&](const Basic &b) {
+        std::vector<unsigned> deps;
+        for (const auto &s : free_symbols(b)) {
+            auto it = index.find(s);
+            if (it != index.end()) {
+                deps.push_back(it->second);
+            }
+        }
+        std::sort(deps.begin(), deps.end());
+        return deps;
+    };
+    std::vector<std::vector<unsigned>> deps(replacements.size());
+    for (unsigned i = 0; i < replacements.size(); i++) {
+        deps[i] = dependencies(*replacements[i].second);
+    }
+
+    C99CodePrinter printer;
+    std::ostringstream o;
+    o << "void " << name << "(double *out, const double *in)\n{\n";
+    // Each temporary is defined right before the first output using it, so
+    // that it is live for as short as possible.
+    std::vector<bool> emitted(replacements.size(), false);
+    std::vector<std::pair<unsigned, size_t>> stack;
+    for (size_t k = 0; k < reduced.size(); k++) {
+        std::vector<unsigned> roots = dependencies(*reduced[k]);
+        for (unsigned root : roots) {
+            if (emitted[root]) {
+                continue;
+            }
+            emitted[root] = true;
+            stack.push_back({root, 0});
+            while (not stack.empty()) {
+                unsigned i = stack.back().first;
+                size_t &next = stack.back().second;
+                if (next < deps[i].size()) {
+                    unsigned j = deps[i][next++];
+                    if (not emitted[j]) {
+                        emitted[j] = true;
+                        stack.push_back({j, 0});
+                    }
+                    continue;
+                }
+                o << "    const double " << printer.apply(replacements[i].first)
+                  << " = " << printer.apply(replacements[i].second) << ";\n";
+                stack.pop_back();
+            }
+        }
+        o << "    out[" << k << "] = " << printer.apply(reduced[k]) << ";\n";
+    }
+    o << "}\n";
+    return o.str();
+}
+
+} // namespace SymEngine
@@ -366,6 +366,15 @@ std::string inline jscode(const Basic &x)
     JSCodePrinter p;
     return p.apply(x);
 }
+
+/*! Prints a C function `void name(double *out, const double *in)` that
+    evaluates `exprs` into `out`, `in[i]` being the value of the symbol
+    `args[i]`. The common subexpressions of all the outputs are computed once
+    into `const double` temporaries, each defined right before the first
+    output that needs it.
+*/
+std::string ccode_function(const std::string &name, const vec_basic &args,
+                           const vec_basic &exprs);
 }
 
 #endif // SYMENGINE_CODEGEN_H
@@ -3,6 +3,7 @@
 #include <symengine/mul.h>
 #include <symengine/functions.h>
 #include <symengine/visitor.h>
+#include <symengine/logic.h>
 
 #include <queue>
 
@@ -12,6 +13,63 @@ umap_basic_basic opt_cse(const vec_basic &exprs);
 void tree_cse(vec_pair &replacements, vec_basic &reduced_exprs,
               const vec_basic &exprs, umap_basic_basic &opt_subs);
 
+/*
+   The passes below walk expressions with millions of nodes, so they use an
+   explicit stack instead of recursion and do not call `get_args()` on every
+   node. `push_args` appends the same arguments as `b.get_args()` to `stack`
+   in reverse order, so that they are popped in order. Returns the number of
+   arguments.
+*/
+size_t push_args(const Basic &b, vec_basic &stack)
+{
+    const size_t start = stack.size();
+    if (is_a<Add>(b)) {
+        const Add &x = down_cast<const Add &>(b);
+        if (not x.get_coef()->is_zero()) {
+            stack.push_back(x.get_coef());
+        }
+        for (const auto &p : x.get_dict()) {
+            if (eq(*p.second, *one)) {
+                stack.push_back(p.first);
+            } else {
+                stack.push_back(Add::from_dict(zero, {{p.first, p.second}}));
+            }
+        }
+    } else if (is_a<Mul>(b)) {
+        const Mul &x = down_cast<const Mul &>(b);
+        if (not x.get_coef()->is_one()) {
+            stack.push_back(x.get_coef());
+        }
+        for (const auto &p : x.get_dict()) {
+            if (eq(*p.second, *one)) {
+                stack.push_back(p.first);
+            } else {
+                stack.push_back(make_rcp<const Pow>(p.first, p.second));
+            }
+        }
+    } else if (is_a<Pow>(b)) {
+        const Pow &x = down_cast<const Pow &>(b);
+        stack.push_back(x.get_base());
+        stack.push_back(x.get_exp());
+    } else if (is_a_Atom(b)) {
+        return 0;
+    } else if (is_a_sub<OneArgFunction>(b)) {
+        stack.push_back(down_cast<const OneArgFunction &>(b).get_arg());
+    } else if (is_a_sub<MultiArgFunction>(b)) {
+        const vec_basic &v = down_cast<const MultiArgFunction &>(b).get_vec();
+        stack.insert(stack.end(), v.begin(), v.end());
+    } else if (is_a_sub<TwoArgFunction>(b)) {
+        const TwoArgFunction &x = down_cast<const TwoArgFunction &>(b);
+        stack.push_back(x.get_arg1());
+        stack.push_back(x.get_arg2());
+    } else {
+        vec_basic v = b.get_args();
+        stack.insert(stack.end(), v.begin(), v.end());
+    }
+    std::reverse(stack.begin() + start, stack.end());
+    return stack.size() - start;
+}
+
 class FuncArgTracker
 {
 
@@ -74,60 +132,54 @@ public:
        are the number of arguments said function has in common with `argset`.
        Entries have at least 2 items in common.
     */
-    std::map<unsigned, unsigned>
+    std::unordered_map<unsigned, unsigned>
     get_common_arg_candidates(std::set<unsigned> &argset, unsigned min_func_i)
     {
-        std::map<unsigned, unsigned> count_map;
-        std::vector<std::set<unsigned>> funcsets;
+        std::unordered_map<unsigned, unsigned> count_map;
+        std::vector<const std::set<unsigned> *> funcsets;
         for (unsigned arg : argset) {
-            funcsets.push_back(arg_to_funcset[arg]);
+            funcsets.push_back(&arg_to_funcset[arg]);
         }
-        // Sorted by size to make best use of the performance hack below.
-        std::sort(funcsets.begin(), funcsets.end(),
-                  [](const std::set<unsigned> &a, const std::set<unsigned> &b) {
-                      return a.size() < b.size();
-                  });
-
-        for (unsigned i = 0; i < funcsets.size(); i++) {
-            auto &funcset = funcsets[i];
-            for (unsigned func_i : funcset) {
+        if (funcsets.empty()) {
+            return count_map;
+        }
+        // A function only in the largest set has a single argument in common,
+        // so the largest set is only used to update the other counts. This
+        // keeps arguments shared by most functions from making the pass
+        // quadratic.
+        auto largest = std::max_element(
+            funcsets.begin(), funcsets.end(),
+            [](const std::set<unsigned> *a, const std::set<unsigned> *b) {
+                return a->size() < b->size();
+            });
+        const std::set<unsigned> &largest_funcset = **largest;
+        funcsets.erase(largest);
+        for (const std::set<unsigned> *funcset : funcsets) {
+            for (unsigned func_i : *funcset) {
                 if (func_i >= min_func_i) {
                     count_map[func_i] += 1;
                 }
             }
         }
-
-        /*auto &largest_funcset = funcsets[funcsets.size() - 1];
-
-        // We pick the smaller of the two containers to iterate over to
-        // reduce the number of items we have to look at.
-
         if (largest_funcset.size() < count_map.size()) {
             for (unsigned func_i : largest_funcset) {
-                if (count_map[func_i] < 1) {
-                    continue;
-                }
-                if (count_map.find(func_i) != count_map.end()) {
-                    count_map[func_i] += 1;
+                auto iter = count_map.find(func_i);
+                if (iter != count_map.end()) {
+                    iter->second += 1;
                 }
             }
         } else {
-            for (auto &count_map_pair : count_map) {
-                unsigned func_i = count_map_pair.first;
-                if (count_map[func_i] < 1) {
-                    continue;
-                }
-                if (largest_funcset.find(func_i) != largest_funcset.end()) {
-                    count_map[func_i] += 1;
+            for (auto &p : count_map) {
+                if (largest_funcset.find(p.first) != largest_funcset.end()) {
+                    p.second += 1;
                 }
             }
-        }*/
-        auto iter = count_map.begin();
-        for (; iter != count_map.end();) {
+        }
+        for (auto iter = count_map.begin(); iter != count_map.end();) {
             if (iter->second >= 2) {
                 ++iter;
             } else {
-                count_map.erase(iter++);
+                iter = count_map.erase(iter);
             }
         }
         return count_map;
@@ -215,7 +267,7 @@ void match_common_args(const std::string &func_class, const vec_basic &funcs_,
     auto arg_tracker = FuncArgTracker(funcs);
 
     std::set<unsigned> changed;
-    std::map<unsigned, unsigned> common_arg_candidates_counts;
+    std::unordered_map<unsigned, unsigned> common_arg_candidates_counts;
 
     for (unsigned i = 0; i < funcs.size(); i++) {
         common_arg_candidates_counts = arg_tracker.get_common_arg_candidates(
@@ -299,7 +351,7 @@ void match_common_args(const std::string &func_class, const vec_basic &funcs_,
                 changed.insert(k);
             }
         }
-        if (std::find(changed.begin(), changed.end(), i) != changed.end()) {
+        if (changed.find(i) != changed.end()) {
             opt_subs[funcs[i].first] = function_symbol(
                 func_class, arg_tracker.get_args_in_value_order(
                                 arg_tracker.func_to_argset[i]));
@@ -308,46 +360,52 @@ void match_common_args(const std::string &func_class, const vec_basic &funcs_,
     }
 }
 
-class OptsCSEVisitor : public BaseVisitor<OptsCSEVisitor>
+class OptsCSEFinder
 {
 public:
     umap_basic_basic &opt_subs;
-    set_basic adds;
-    set_basic muls;
-    set_basic seen_subexp;
-    OptsCSEVisitor(umap_basic_basic &opt_subs_) : opt_subs(opt_subs_)
+    vec_basic adds;
+    vec_basic muls;
+    uset_basic seen_subexp;
+    OptsCSEFinder(umap_basic_basic &opt_subs_) : opt_subs(opt_subs_)
     {
     }
-    bool is_seen(const Basic &expr)
+    void apply(const RCP<const Basic> &root)
     {
-        return (seen_subexp.find(expr.rcp_from_this()) != seen_subexp.end());
-    }
-    void bvisit(const Derivative &x)
-    {
-        return;
-    }
-    void bvisit(const Subs &x)
-    {
-        return;
-    }
-    void bvisit(const Add &x)
-    {
-        if (not is_seen(x)) {
-            seen_subexp.insert(x.rcp_from_this());
-            for (const auto &p : x.get_args()) {
-                p->accept(*this);
+        // The nodes are popped twice: first to push their arguments, then
+        // (with `post` set) once the arguments have been visited.
+        std::vector<std::pair<RCP<const Basic>, bool>> stack;
+        vec_basic args;
+        stack.push_back({root, false});
+        while (not stack.empty()) {
+            RCP<const Basic> expr = std::move(stack.back().first);
+            bool post = stack.back().second;
+            stack.pop_back();
+            if (post) {
+                visit_post(expr);
+                continue;
             }
-            adds.insert(x.rcp_from_this());
+            if (is_a<Derivative>(*expr) or is_a<Subs>(*expr)
+                or seen_subexp.find(expr) != seen_subexp.end()) {
+                continue;
+            }
+            if (push_args(*expr, args) == 0) {
+                continue;
+            }
+            seen_subexp.insert(expr);
+            stack.push_back({expr, true});
+            for (auto &arg : args) {
+                stack.push_back({std::move(arg), false});
+            }
+            args.clear();
         }
     }
-    void bvisit(const Pow &x)
+    void visit_post(const RCP<const Basic> &expr)
     {
-        if (not is_seen(x)) {
-            auto expr = x.rcp_from_this();
-            seen_subexp.insert(expr);
-            for (const auto &p : x.get_args()) {
-                p->accept(*this);
-            }
+        if (is_a<Add>(*expr)) {
+            adds.push_back(expr);
+        } else if (is_a<Pow>(*expr)) {
+            const Pow &x = down_cast<const Pow &>(*expr);
             auto ex = x.get_exp();
             if (is_a<Mul>(*ex)) {
                 ex = static_cast<const Mul &>(*ex).get_coef();
@@ -357,50 +415,34 @@ public:
                 vec_basic v({pow(x.get_base(), neg(x.get_exp())), integer(-1)});
                 opt_subs[expr] = function_symbol("pow", v);
             }
-        }
-    }
-    void bvisit(const Mul &x)
-    {
-        if (not is_seen(x)) {
-            auto expr = x.rcp_from_this();
-            seen_subexp.insert(expr);
-            for (const auto &p : x.get_args()) {
-                p->accept(*this);
-            }
+        } else if (is_a<Mul>(*expr)) {
+            const Mul &x = down_cast<const Mul &>(*expr);
             if (x.get_coef()->is_negative()) {
-                auto neg_expr = neg(x.rcp_from_this());
+                auto neg_expr = neg(expr);
                 if (not is_a<Symbol>(*neg_expr)) {
                     opt_subs[expr]
                         = function_symbol("mul", {integer(-1), neg_expr});
                     seen_subexp.insert(neg_expr);
-                    expr = neg_expr;
+                    if (is_a<Mul>(*neg_expr)) {
+                        muls.push_back(neg_expr);
+                    }
+                    return;
                 }
             }
-            if (is_a<Mul>(*expr)) {
-                muls.insert(expr);
-            }
-        }
-    }
-    void bvisit(const Basic &x)
-    {
-        auto v = x.get_args();
-        if (v.size() > 0 and not is_seen(x)) {
-            auto expr = x.rcp_from_this();
-            seen_subexp.insert(expr);
-            for (const auto &p : v) {
-                p->accept(*this);
-            }
+            muls.push_back(expr);
         }
     }
 };
 
-vec_basic set_as_vec(const set_basic &s)
+// Sorts `v` in the order of `set_basic` and removes the duplicates
+const vec_basic &sorted_unique(vec_basic &v)
 {
-    vec_basic result;
-    for (auto &u : s) {
-        result.push_back(u);
-    }
-    return result;
+    std::sort(v.begin(), v.end(), RCPBasicKeyLess());
+    v.erase(std::unique(v.begin(), v.end(),
+                        [](const RCP<const Basic> &a,
+                           const RCP<const Basic> &b) { return eq(*a, *b); }),
+            v.end());
+    return v;
 }
 
 umap_basic_basic opt_cse(const vec_basic &exprs)
@@ -408,54 +450,97 @@ umap_basic_basic opt_cse(const vec_basic &exprs)
     // Find optimization opportunities in Adds, Muls, Pows and negative
     // coefficient Muls
     umap_basic_basic opt_subs;
-    OptsCSEVisitor visitor(opt_subs);
+    OptsCSEFinder finder(opt_subs);
     for (auto &e : exprs) {
-        e->accept(visitor);
+        finder.apply(e);
     }
 
-    match_common_args("add", set_as_vec(visitor.adds), opt_subs);
-    match_common_args("mul", set_as_vec(visitor.muls), opt_subs);
+    match_common_args("add", sorted_unique(finder.adds), opt_subs);
+    match_common_args("mul", sorted_unique(finder.muls), opt_subs);
 
     return opt_subs;
 }
 
-class RebuildVisitor : public BaseVisitor<RebuildVisitor, TransformVisitor>
+/*
+   Rebuilds the expressions, replacing the subexpressions in `to_eliminate`
+   by new symbols and the ones in `opt_subs` by their optimized form. The
+   nodes are rebuilt bottom up from an explicit stack; the `FunctionSymbol`s
+   "add", "mul" and "pow" created by `opt_cse` are evaluated.
+*/
+class Rebuilder
 {
 private:
     umap_basic_basic &subs;
     umap_basic_basic &opt_subs;
-    set_basic &to_eliminate;
-    set_basic &excluded_symbols;
+    uset_basic &to_eliminate;
+    uset_basic &excluded_symbols;
     vec_pair &replacements;
     unsigned next_symbol_index = 0;
 
-public:
-    using TransformVisitor::result_;
-    using TransformVisitor::bvisit;
-    RebuildVisitor(umap_basic_basic &subs_, umap_basic_basic &opt_subs_,
-                   set_basic &to_eliminate_, set_basic &excluded_symbols_,
-                   vec_pair &replacements_)
-        : subs(subs_), opt_subs(opt_subs_), to_eliminate(to_eliminate_),
-          excluded_symbols(excluded_symbols_), replacements(replacements_)
+    struct Frame {
+        RCP<const Basic> orig_expr;
+        // `orig_expr` after `opt_subs`
+        RCP<const Basic> expr;
+        // Number of arguments, or -1 if they are not visited yet
+        int nargs;
+    };
+
+    // The nodes rebuilt from new arguments, the other ones are kept as is
+    static bool is_rebuilt(const Basic &b)
     {
+        return is_a<Add>(b) or is_a<Mul>(b) or is_a<Pow>(b)
+               or is_a_sub<OneArgFunction>(b) or is_a_sub<TwoArgFunction>(b)
+               or is_a_sub<Relational>(b) or is_a_sub<MultiArgFunction>(b);
     }
-    virtual RCP<const Basic> apply(const RCP<const Basic> &orig_expr)
+
+    static RCP<const Basic> rebuild_node(const RCP<const Basic> &expr,
+                                         const vec_basic &newargs)
     {
-        RCP<const Basic> expr = orig_expr;
-        if (is_a_Atom(*expr)) {
+        if (is_a<Add>(*expr)) {
+            return add(newargs);
+        } else if (is_a<Mul>(*expr)) {
+            return mul(newargs);
+        } else if (is_a<Pow>(*expr)) {
+            const Pow &x = down_cast<const Pow &>(*expr);
+            if (x.get_base() != newargs[0] or x.get_exp() != newargs[1]) {
+                return pow(newargs[0], newargs[1]);
+            }
             return expr;
+        } else if (is_a_sub<OneArgFunction>(*expr)) {
+            const OneArgFunction &x = down_cast<const OneArgFunction &>(*expr);
+            if (eq(*newargs[0], *x.get_arg())) {
+                return expr;
+            }
+            return x.create(newargs[0]);
+        } else if (is_a_sub<TwoArgFunction>(*expr)) {
+            const TwoArgFunction &x = down_cast<const TwoArgFunction &>(*expr);
+            if (x.get_arg1() != newargs[0] or x.get_arg2() != newargs[1]) {
+                return x.create(newargs[0], newargs[1]);
+            }
+            return expr;
+        } else if (is_a_sub<Relational>(*expr)) {
+            const Relational &x = down_cast<const Relational &>(*expr);
+            if (x.get_arg1() != newargs[0] or x.get_arg2() != newargs[1]) {
+                return x.create(newargs[0], newargs[1]);
+            }
+            return expr;
+        } else if (is_a_sub<FunctionSymbol>(*expr)) {
+            const FunctionSymbol &x = down_cast<const FunctionSymbol &>(*expr);
+            if (x.get_name() == "add") {
+                return add(newargs);
+            } else if (x.get_name() == "mul") {
+                return mul(newargs);
+            } else if (x.get_name() == "pow") {
+                return pow(newargs[0], newargs[1]);
+            }
+            return x.create(newargs);
         }
+        return down_cast<const MultiArgFunction &>(*expr).create(newargs);
+    }
 
-        auto iter = subs.find(expr);
-        if (iter != subs.end()) {
-            return iter->second;
-        }
-        auto iter2 = opt_subs.find(expr);
-        if (iter2 != opt_subs.end()) {
-            expr = iter2->second;
-        }
-        expr->accept(*this);
-        auto new_expr = result_;
+    RCP<const Basic> finish(const RCP<const Basic> &orig_expr,
+                            const RCP<const Basic> &new_expr)
+    {
         if (to_eliminate.find(orig_expr) != to_eliminate.end()) {
             auto sym = next_symbol();
             subs[orig_expr] = sym;
@@ -465,6 +550,79 @@ public:
         }
         return new_expr;
     }
+
+public:
+    Rebuilder(umap_basic_basic &subs_, umap_basic_basic &opt_subs_,
+              uset_basic &to_eliminate_, uset_basic &excluded_symbols_,
+              vec_pair &replacements_)
+        : subs(subs_), opt_subs(opt_subs_), to_eliminate(to_eliminate_),
+          excluded_symbols(excluded_symbols_), replacements(replacements_)
+    {
+    }
+    RCP<const Basic> apply(const RCP<const Basic> &root)
+    {
+        std::vector<Frame> stack;
+        vec_basic args;
+        // The rebuilt arguments of the frames on the stack. The unchanged
+        // subexpressions are kept (instead of being recreated), so that
+        // comparing them with the original ones is cheap.
+        vec_basic values;
+        std::vector<bool> unchanged;
+        auto push_value = [&](const RCP<const Basic> &orig_expr,
+                              const RCP<const Basic> &value) {
+            values.push_back(value);
+            unchanged.push_back(value.get() == orig_expr.get());
+        };
+        stack.push_back({root, root, -1});
+        while (not stack.empty()) {
+            Frame &f = stack.back();
+            if (f.nargs >= 0) {
+                const size_t start = values.size() - f.nargs;
+                RCP<const Basic> new_expr = f.orig_expr;
+                // The `FunctionSymbol`s are always rebuilt, to evaluate the
+                // ones created by `opt_cse`
+                if (f.expr != f.orig_expr or is_a_sub<FunctionSymbol>(*f.expr)
+                    or std::find(unchanged.begin() + start, unchanged.end(),
+                                 false)
+                           != unchanged.end()) {
+                    vec_basic newargs(values.begin() + start, values.end());
+                    new_expr = rebuild_node(f.expr, newargs);
+                }
+                values.resize(start);
+                unchanged.resize(start);
+                push_value(f.orig_expr, finish(f.orig_expr, new_expr));
+                stack.pop_back();
+                continue;
+            }
+            if (is_a_Atom(*f.orig_expr)) {
+                push_value(f.orig_expr, f.orig_expr);
+                stack.pop_back();
+                continue;
+            }
+            auto iter = subs.find(f.orig_expr);
+            if (iter != subs.end()) {
+                push_value(f.orig_expr, iter->second);
+                stack.pop_back();
+                continue;
+            }
+            auto iter2 = opt_subs.find(f.orig_expr);
+            if (iter2 != opt_subs.end()) {
+                f.expr = iter2->second;
+            }
+            if (not is_rebuilt(*f.expr)) {
+                push_value(f.orig_expr, finish(f.orig_expr, f.expr));
+                stack.pop_back();
+                continue;
+            }
+            f.nargs = static_cast<int>(push_args(*f.expr, args));
+            // The arguments are pushed in reverse order, `f` is invalidated
+            for (auto &arg : args) {
+                stack.push_back({arg, arg, -1});
+            }
+            args.clear();
+        }
+        return values.back();
+    }
     RCP<const Basic> next_symbol()
     {
         RCP<const Basic> sym = symbol("x" + to_string(next_symbol_index));
@@ -475,73 +633,53 @@ public:
             return next_symbol();
         }
     };
-    void bvisit(const FunctionSymbol &x)
-    {
-        auto &fargs = x.get_vec();
-        vec_basic newargs;
-        for (const auto &a : fargs) {
-            newargs.push_back(apply(a));
-        }
-        if (x.get_name() == "add") {
-            result_ = add(newargs);
-        } else if (x.get_name() == "mul") {
-            result_ = mul(newargs);
-        } else if (x.get_name() == "pow") {
-            result_ = pow(newargs[0], newargs[1]);
-        } else {
-            result_ = x.create(newargs);
-        }
-    }
 };
 
 void tree_cse(vec_pair &replacements, vec_basic &reduced_exprs,
               const vec_basic &exprs, umap_basic_basic &opt_subs)
 {
-    set_basic to_eliminate;
-    set_basic seen_subexp;
-    set_basic excluded_symbols;
-
-    std::function<void(RCP<const Basic> & expr)> find_repeated;
-    find_repeated = [&](RCP<const Basic> expr) -> void {
+    uset_basic to_eliminate;
+    uset_basic seen_subexp;
+    uset_basic excluded_symbols;
+
+    // Find the subexpressions seen more than once, the arguments of a
+    // subexpression are only visited the first time it is seen.
+    vec_basic stack;
+    for (auto it = exprs.rbegin(); it != exprs.rend(); ++it) {
+        stack.push_back(*it);
+    }
+    while (not stack.empty()) {
+        RCP<const Basic> expr = std::move(stack.back());
+        stack.pop_back();
 
         if (is_a_Number(*expr)) {
-            return;
+            continue;
         }
 
         if (is_a<Symbol>(*expr)) {
             excluded_symbols.insert(expr);
         }
 
-        if (seen_subexp.find(expr) != seen_subexp.end()) {
+        if (not seen_subexp.insert(expr).second) {
             to_eliminate.insert(expr);
-            return;
+            continue;
         }
 
-        seen_subexp.insert(expr);
-
         auto iter = opt_subs.find(expr);
         if (iter != opt_subs.end()) {
-            expr = iter->second;
-        }
-
-        vec_basic args = expr->get_args();
-
-        for (auto &arg : args) {
-            find_repeated(arg);
+            push_args(*iter->second, stack);
+        } else {
+            push_args(*expr, stack);
         }
-    };
-
-    for (auto e : exprs) {
-        find_repeated(e);
     }
 
     umap_basic_basic subs;
 
-    RebuildVisitor rebuild_visitor(subs, opt_subs, to_eliminate,
-                                   excluded_symbols, replacements);
+    Rebuilder rebuilder(subs, opt_subs, to_eliminate, excluded_symbols,
+                        replacements);
 
     for (auto &e : exprs) {
-        auto reduced_e = rebuild_visitor.apply(e);
+        auto reduced_e = rebuilder.apply(e);
         reduced_exprs.push_back(reduced_e);
     }
 }
@@ -509,6 +509,27 @@ CWRAPPER_OUTPUT_TYPE basic_parse2(basic b, const char *str, int convert_xor)
     CWRAPPER_END
 }
 
+CWRAPPER_OUTPUT_TYPE basic_dumps(char **c, unsigned long *size,
+                                 const basic s)
+{
+    *c = nullptr;
+    *size = 0;
+    CWRAPPER_BEGIN
+    std::string str = s->m->dumps();
+    auto cc = new char[str.length()];
+    std::memcpy(cc, str.data(), str.length());
+    *c = cc;
+    *size = str.length();
+    CWRAPPER_END
+}
+
+CWRAPPER_OUTPUT_TYPE basic_loads(basic s, const char *c, unsigned long size)
+{
+    CWRAPPER_BEGIN
+    s->m = Basic::loads(std::string(c, size));
+    CWRAPPER_END
+}
+
 CWRAPPER_OUTPUT_TYPE basic_add(basic s, const basic a, const basic b)
 {
     CWRAPPER_BEGIN
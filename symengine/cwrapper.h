@@ -144,6 +144,14 @@ CWRAPPER_OUTPUT_TYPE basic_parse(basic b, const char *str);
 //! <= 0 otherwise.
 CWRAPPER_OUTPUT_TYPE basic_parse2(basic b, const char *str, int convert_xor);
 
+//! Stores in c a new char pointer to the binary serialization of s and its
+//! length in size. On success the caller is responsible to free c using
+//! 'basic_str_free', on failure c is set to NULL.
+CWRAPPER_OUTPUT_TYPE basic_dumps(char **c, unsigned long *size,
+                                 const basic s);
+//! Assigns to s the expression serialized in the size bytes at c.
+CWRAPPER_OUTPUT_TYPE basic_loads(basic s, const char *c, unsigned long size);
+
 //! Returns the typeID of the basic struct
 TypeID basic_get_type(const basic s);
 //! Returns the typeID of the class with the name c
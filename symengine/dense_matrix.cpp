@@ -1,3 +1,4 @@
+#include <cmath>
 #include <symengine/matrix.h>
 #include <symengine/add.h>
 #include <symengine/pow.h>
@@ -5,6 +6,7 @@
 #include <symengine/symengine_exception.h>
 #include <symengine/polys/uexprpoly.h>
 #include <symengine/solve.h>
+#include <symengine/mod_word.h>
 
 namespace SymEngine
 {
@@ -204,25 +206,24 @@ void jacobian(const DenseMatrix &A, const DenseMatrix &x, DenseMatrix &result)
     SYMENGINE_ASSERT(A.col_ == 1);
     SYMENGINE_ASSERT(x.col_ == 1);
     SYMENGINE_ASSERT(A.row_ == result.nrows() and x.row_ == result.ncols());
-    bool error = false;
+    vec_sym syms;
+    for (unsigned j = 0; j < result.col_; j++) {
+        if (not is_a<Symbol>(*(x.m_[j]))) {
+            throw SymEngineException(
+                "'x' must contain Symbols only. "
+                "Use sjacobian for SymPy style differentiation");
+        }
+        syms.push_back(rcp_static_cast<const Symbol>(x.m_[j]));
+    }
+    // Each row is differentiated w.r.t. all the symbols at once in reverse
+    // mode
 #pragma omp parallel for
     for (unsigned i = 0; i < result.row_; i++) {
+        vec_basic row = gradient(A.m_[i], syms);
         for (unsigned j = 0; j < result.col_; j++) {
-            if (is_a<Symbol>(*(x.m_[j]))) {
-                const RCP<const Symbol> x_
-                    = rcp_static_cast<const Symbol>(x.m_[j]);
-                result.m_[i * result.col_ + j] = A.m_[i]->diff(x_);
-            } else {
-                error = true;
-                break;
-            }
+            result.m_[i * result.col_ + j] = row[j];
         }
     }
-    if (error) {
-        throw SymEngineException(
-            "'x' must contain Symbols only. "
-            "Use sjacobian for SymPy style differentiation");
-    }
 }
 
 void sjacobian(const DenseMatrix &A, const DenseMatrix &x, DenseMatrix &result)
@@ -281,6 +282,16 @@ void sdiff(const DenseMatrix &A, const RCP<const Basic> &x, DenseMatrix &result)
     }
 }
 
+// ---------------------------- Subs -------------------------------------//
+
+void subs(const DenseMatrix &A, const map_basic_basic &subs_dict,
+          DenseMatrix &result)
+{
+    SYMENGINE_ASSERT(A.row_ == result.nrows() and A.col_ == result.ncols());
+    SubsPlan plan(subs_dict);
+    result.m_ = plan.apply(A.m_);
+}
+
 // ----------------------------- Matrix Transpose ----------------------------//
 void transpose_dense(const DenseMatrix &A, DenseMatrix &B)
 {
@@ -339,21 +350,108 @@ void add_dense_scalar(const DenseMatrix &A, const RCP<const Basic> &k,
 }
 
 // ------------------------------- Matrix Multiplication ---------------------//
+namespace
+{
+
+// Side of the square tiles of C computed by one thread
+const unsigned mul_tile_size = 16;
+
+// Returns a[0] * b[0] + a[sa] * b[sb] + ... with `n` terms, built as a single
+// `Add`. The products of integers are accumulated without creating any
+// intermediate `Integer`.
+RCP<const Basic> dot_product(const RCP<const Basic> *a, size_t sa,
+                             const RCP<const Basic> *b, size_t sb, unsigned n)
+{
+    umap_basic_num d;
+    RCP<const Number> coef = zero;
+    integer_class acc(0);
+    for (unsigned k = 0; k < n; k++, a += sa, b += sb) {
+        if (is_a<Integer>(**a) and is_a<Integer>(**b)) {
+            mp_addmul(acc, down_cast<const Integer &>(**a).as_integer_class(),
+                      down_cast<const Integer &>(**b).as_integer_class());
+        } else if (is_a<Integer>(**a) or is_a<Rational>(**a)) {
+            if (not down_cast<const Number &>(**a).is_zero())
+                Add::coef_dict_add_term(outArg(coef), d,
+                                        rcp_static_cast<const Number>(*a), *b);
+        } else if (is_a<Integer>(**b) or is_a<Rational>(**b)) {
+            if (not down_cast<const Number &>(**b).is_zero())
+                Add::coef_dict_add_term(outArg(coef), d,
+                                        rcp_static_cast<const Number>(*b), *a);
+        } else {
+            Add::coef_dict_add_term(outArg(coef), d, one, mul(*a, *b));
+        }
+    }
+    if (acc != 0) {
+        iaddnum(outArg(coef), integer(std::move(acc)));
+    }
+    return Add::from_dict(coef, std::move(d));
+}
+
+// One step of the fraction free (Bareiss) elimination: returns
+// (p * a - b * c) / prev, or p * a - b * c if `prev` is null. The division
+// is exact for integer entries, which are then handled without creating
+// intermediate `Integer`s.
+RCP<const Basic> bareiss_update(const RCP<const Basic> &p,
+                                const RCP<const Basic> &a,
+                                const RCP<const Basic> &b,
+                                const RCP<const Basic> &c,
+                                const RCP<const Basic> &prev)
+{
+    if (is_a<Integer>(*p) and is_a<Integer>(*a) and is_a<Integer>(*b)
+        and is_a<Integer>(*c)
+        and (prev.is_null()
+             or (is_a<Integer>(*prev)
+                 and not down_cast<const Integer &>(*prev).is_zero()))) {
+        integer_class r = down_cast<const Integer &>(*p).as_integer_class()
+                          * down_cast<const Integer &>(*a).as_integer_class();
+        r -= down_cast<const Integer &>(*b).as_integer_class()
+             * down_cast<const Integer &>(*c).as_integer_class();
+        if (prev.is_null()) {
+            return integer(std::move(r));
+        }
+        integer_class q, rem;
+        mp_tdiv_qr(q, rem, r,
+                   down_cast<const Integer &>(*prev).as_integer_class());
+        if (rem == 0) {
+            return integer(std::move(q));
+        }
+    }
+    RCP<const Basic> d = sub(mul(p, a), mul(b, c));
+    if (not prev.is_null())
+        d = div(d, prev);
+    return d;
+}
+
+} // namespace
+
 void mul_dense_dense(const DenseMatrix &A, const DenseMatrix &B, DenseMatrix &C)
 {
     SYMENGINE_ASSERT(A.col_ == B.row_ and C.row_ == A.row_
                      and C.col_ == B.col_);
 
-    unsigned row = A.row_, col = B.col_;
+    unsigned row = A.row_, col = B.col_, inner = A.col_;
 
     if (&A != &C and &B != &C) {
-        for (unsigned r = 0; r < row; r++) {
-            for (unsigned c = 0; c < col; c++) {
-                C.m_[r * col + c] = zero; // Integer Zero
-                for (unsigned k = 0; k < A.col_; k++)
-                    C.m_[r * col + c]
-                        = add(C.m_[r * col + c],
-                              mul(A.m_[r * A.col_ + k], B.m_[k * col + c]));
+        // The columns of B are made contiguous
+        vec_basic Bt(B.m_.size());
+        for (unsigned k = 0; k < inner; k++) {
+            for (unsigned c = 0; c < col; c++)
+                Bt[c * inner + k] = B.m_[k * col + c];
+        }
+        const unsigned row_tiles = (row + mul_tile_size - 1) / mul_tile_size;
+        const unsigned col_tiles = (col + mul_tile_size - 1) / mul_tile_size;
+#pragma omp parallel for schedule(dynamic)
+        for (unsigned t = 0; t < row_tiles * col_tiles; t++) {
+            const unsigned r0 = (t / col_tiles) * mul_tile_size;
+            const unsigned c0 = (t % col_tiles) * mul_tile_size;
+            const unsigned r1 = std::min(r0 + mul_tile_size, row);
+            const unsigned c1 = std::min(c0 + mul_tile_size, col);
+            for (unsigned r = r0; r < r1; r++) {
+                for (unsigned c = c0; c < c1; c++) {
+                    C.m_[r * col + c] = dot_product(
+                        A.m_.data() + r * inner, 1, Bt.data() + c * inner, 1,
+                        inner);
+                }
             }
         }
     } else {
@@ -518,6 +616,307 @@ void column_exchange_dense(DenseMatrix &A, unsigned i, unsigned j)
         std::swap(A.m_[k * col + i], A.m_[k * col + j]);
 }
 
+// ------------------------- Multimodular Algorithms -------------------------//
+namespace
+{
+
+// The primes are just above 2^30, so that products of residues fit in 64 bits
+// and the primes themselves fit in an unsigned long, even where it has 32 bits
+class ModularPrimes
+{
+private:
+    integer_class last_;
+
+public:
+    ModularPrimes() : last_(1ul << 30)
+    {
+    }
+    uint64_t next()
+    {
+        mp_nextprime(last_, last_);
+        return mp_get_ui(last_);
+    }
+};
+
+inline integer_class to_integer_class(uint64_t p)
+{
+    return integer_class(static_cast<unsigned long>(p));
+}
+
+inline uint64_t reduce(const integer_class &a, uint64_t p)
+{
+    integer_class r;
+    mp_fdiv_r(r, a, to_integer_class(p));
+    return mp_get_ui(r);
+}
+
+inline uint64_t invmod(uint64_t a, uint64_t p)
+{
+    uint64_t r = 0;
+    invmod_u64(r, a, p);
+    return r;
+}
+
+// Upper bound on log2 |a|
+double log2_bound(const integer_class &a)
+{
+    if (a == 0)
+        return 0;
+    double d = mp_get_d(mp_abs(a));
+    if (std::isfinite(d))
+        return std::log2(d) + 1;
+    integer_class q = mp_abs(a);
+    double bits = 0;
+    const integer_class base = integer_class(1ul) << 1000;
+    while (q >= base) {
+        mp_fdiv_q(q, q, base);
+        bits += 1000;
+    }
+    return bits + std::log2(mp_get_d(q)) + 1;
+}
+
+bool is_rational_matrix(const DenseMatrix &A)
+{
+    for (unsigned i = 0; i < A.nrows(); i++) {
+        for (unsigned j = 0; j < A.ncols(); j++) {
+            const Basic &e = *A.get(i, j);
+            if (not is_a<Integer>(e) and not is_a<Rational>(e))
+                return false;
+        }
+    }
+    return true;
+}
+
+// The rows of [A | B] multiplied by the lcm of the denominators of their
+// entries, the product of the multipliers is returned in `scale`
+std::vector<integer_class> clear_denominators(const DenseMatrix &A,
+                                              const DenseMatrix *B,
+                                              integer_class &scale)
+{
+    const unsigned n = A.nrows(), m = B ? B->ncols() : 0;
+    const unsigned cols = A.ncols() + m;
+    std::vector<integer_class> M(static_cast<size_t>(n) * cols);
+    std::vector<rational_class> row(cols);
+    scale = 1;
+    for (unsigned i = 0; i < n; i++) {
+        integer_class l(1);
+        for (unsigned j = 0; j < cols; j++) {
+            const Basic &e = j < A.ncols() ? *A.get(i, j)
+                                           : *B->get(i, j - A.ncols());
+            if (is_a<Integer>(e)) {
+                row[j] = down_cast<const Integer &>(e).as_integer_class();
+            } else if (is_a<Rational>(e)) {
+                row[j] = down_cast<const Rational &>(e).as_rational_class();
+                mp_lcm(l, l, get_den(row[j]));
+            } else {
+                throw SymEngineException(
+                    "Matrix entries must be Integers or Rationals");
+            }
+        }
+        for (unsigned j = 0; j < cols; j++) {
+            M[static_cast<size_t>(i) * cols + j]
+                = get_num(row[j]) * (l / get_den(row[j]));
+        }
+        scale *= l;
+    }
+    return M;
+}
+
+// Determinant of the n x n row major matrix `a` modulo `p`
+uint64_t det_mod(std::vector<uint64_t> &a, unsigned n, uint64_t p)
+{
+    uint64_t d = 1;
+    for (unsigned k = 0; k < n; k++) {
+        unsigned r = k;
+        while (r < n and a[r * n + k] == 0)
+            r++;
+        if (r == n)
+            return 0;
+        if (r != k) {
+            std::swap_ranges(&a[r * n + k], &a[r * n + n], &a[k * n + k]);
+            d = p - d;
+        }
+        d = d * a[k * n + k] % p;
+        const uint64_t inv = invmod(a[k * n + k], p);
+        for (unsigned i = k + 1; i < n; i++) {
+            const uint64_t f = a[i * n + k] * inv % p;
+            if (f == 0)
+                continue;
+            for (unsigned j = k + 1; j < n; j++)
+                a[i * n + j] = (a[i * n + j] + (p - f) * a[k * n + j]) % p;
+        }
+    }
+    return d;
+}
+
+// Gauss-Jordan elimination of the n x (n + m) row major matrix [A | B]
+// modulo `p`, which then holds the solution of A x = B in its last m
+// columns. Returns false if A is singular modulo `p`.
+bool solve_mod(std::vector<uint64_t> &a, unsigned n, unsigned m, uint64_t p)
+{
+    const unsigned w = n + m;
+    for (unsigned k = 0; k < n; k++) {
+        unsigned r = k;
+        while (r < n and a[r * w + k] == 0)
+            r++;
+        if (r == n)
+            return false;
+        if (r != k)
+            std::swap_ranges(&a[r * w + k], &a[r * w + w], &a[k * w + k]);
+        const uint64_t inv = invmod(a[k * w + k], p);
+        for (unsigned j = k; j < w; j++)
+            a[k * w + j] = a[k * w + j] * inv % p;
+        for (unsigned i = 0; i < n; i++) {
+            const uint64_t f = a[i * w + k];
+            if (i == k or f == 0)
+                continue;
+            for (unsigned j = k; j < w; j++)
+                a[i * w + j] = (a[i * w + j] + (p - f) * a[k * w + j]) % p;
+        }
+    }
+    return true;
+}
+
+// Combines x mod m with r mod p into x mod m p, 0 <= x < m p
+void crt_update(integer_class &x, const integer_class &m, uint64_t r,
+                uint64_t p)
+{
+    const uint64_t xr = reduce(x, p);
+    if (xr == r)
+        return;
+    const uint64_t t = (r + p - xr) * invmod(reduce(m, p), p) % p;
+    x += m * to_integer_class(t);
+}
+
+// Finds n / d = u mod m with |n|, d <= sqrt(m / 2)
+bool rational_reconstruction(rational_class &q, const integer_class &u,
+                             const integer_class &m)
+{
+    integer_class bound = mp_sqrt(m / 2u);
+    integer_class r0 = m, r1 = u, t0 = 0, t1 = 1, qt, tmp;
+    while (r1 > bound) {
+        mp_fdiv_q(qt, r0, r1);
+        tmp = r0 - qt * r1;
+        r0 = r1;
+        r1 = tmp;
+        tmp = t0 - qt * t1;
+        t0 = t1;
+        t1 = tmp;
+    }
+    if (mp_abs(t1) > bound or t1 == 0)
+        return false;
+    integer_class g;
+    mp_gcd(g, r1, t1);
+    if (g != 1)
+        return false;
+    if (t1 < 0) {
+        r1 = -r1;
+        t1 = -t1;
+    }
+    q = rational_class(r1, t1);
+    return true;
+}
+
+} // namespace
+
+RCP<const Basic> det_multimodular(const DenseMatrix &A)
+{
+    SYMENGINE_ASSERT(A.nrows() == A.ncols());
+    const unsigned n = A.nrows();
+    integer_class scale;
+    const std::vector<integer_class> M = clear_denominators(A, nullptr, scale);
+
+    // Hadamard's bound on log2 |det|
+    double hadamard = 0;
+    for (unsigned i = 0; i < n; i++) {
+        double row = 0;
+        for (unsigned j = 0; j < n; j++)
+            row = std::max(row, log2_bound(M[i * n + j]));
+        hadamard += row + 0.5 * std::log2(static_cast<double>(n));
+    }
+
+    ModularPrimes primes;
+    std::vector<uint64_t> a(M.size());
+    integer_class x(0), m(1);
+    double mbits = 0;
+    // The primes are deterministic, so agreement between a few of them proves
+    // nothing; the symmetric residue is only exact once m exceeds 2 |det|
+    while (mbits <= hadamard + 1) {
+        const uint64_t p = primes.next();
+        for (size_t k = 0; k < M.size(); k++)
+            a[k] = reduce(M[k], p);
+        crt_update(x, m, det_mod(a, n, p), p);
+        m *= to_integer_class(p);
+        mbits += std::log2(static_cast<double>(p));
+    }
+    if (x > m / 2u)
+        x -= m;
+    return Rational::from_two_ints(*integer(std::move(x)),
+                                   *integer(std::move(scale)));
+}
+
+bool multimodular_solve(const DenseMatrix &A, const DenseMatrix &b,
+                        DenseMatrix &x)
+{
+    SYMENGINE_ASSERT(A.nrows() == A.ncols() and b.nrows() == A.nrows());
+    SYMENGINE_ASSERT(x.nrows() == A.nrows() and x.ncols() == b.ncols());
+    const unsigned n = A.nrows(), m = b.ncols(), w = n + m;
+    integer_class scale;
+    const std::vector<integer_class> M = clear_denominators(A, &b, scale);
+
+    ModularPrimes primes;
+    std::vector<uint64_t> a(M.size());
+    std::vector<integer_class> X(static_cast<size_t>(n) * m);
+    std::vector<rational_class> q(X.size());
+    integer_class mod(1);
+    unsigned good = 0, bad = 0, next_check = 1;
+    while (true) {
+        const uint64_t p = primes.next();
+        for (size_t k = 0; k < M.size(); k++)
+            a[k] = reduce(M[k], p);
+        if (not solve_mod(a, n, m, p)) {
+            // A singular matrix is singular modulo every prime
+            if (good == 0 and ++bad == 3)
+                return false;
+            continue;
+        }
+        for (unsigned i = 0; i < n; i++) {
+            for (unsigned k = 0; k < m; k++)
+                crt_update(X[i * m + k], mod, a[i * w + n + k], p);
+        }
+        mod *= to_integer_class(p);
+        if (++good < next_check)
+            continue;
+        next_check *= 2;
+
+        bool ok = true;
+        for (size_t k = 0; k < X.size() and ok; k++)
+            ok = rational_reconstruction(q[k], X[k], mod);
+        // The candidate is accepted once it satisfies the system exactly
+        for (unsigned k = 0; k < m and ok; k++) {
+            integer_class den(1);
+            for (unsigned j = 0; j < n; j++)
+                mp_lcm(den, den, get_den(q[j * m + k]));
+            std::vector<integer_class> num(n);
+            for (unsigned j = 0; j < n; j++)
+                num[j] = get_num(q[j * m + k]) * (den / get_den(q[j * m + k]));
+            for (unsigned i = 0; i < n and ok; i++) {
+                integer_class s(0);
+                for (unsigned j = 0; j < n; j++)
+                    mp_addmul(s, M[i * w + j], num[j]);
+                ok = (s == den * M[i * w + n + k]);
+            }
+        }
+        if (ok)
+            break;
+    }
+    for (unsigned i = 0; i < n; i++) {
+        for (unsigned k = 0; k < m; k++)
+            x.set(i, k, Rational::from_mpq(std::move(q[i * m + k])));
+    }
+    return true;
+}
+
 // ------------------------------ Gaussian Elimination -----------------------//
 void pivoted_gaussian_elimination(const DenseMatrix &A, DenseMatrix &B,
                                   permutelist &pl)
@@ -525,7 +924,7 @@ void pivoted_gaussian_elimination(const DenseMatrix &A, DenseMatrix &B,
     SYMENGINE_ASSERT(A.row_ == B.row_ and A.col_ == B.col_);
 
     unsigned row = A.row_, col = A.col_;
-    unsigned index = 0, i, j, k;
+    unsigned index = 0, i, k;
     B.m_ = A.m_;
 
     RCP<const Basic> scale;
@@ -545,12 +944,14 @@ void pivoted_gaussian_elimination(const DenseMatrix &A, DenseMatrix &B,
         scale = div(one, B.m_[index * col + i]);
         row_mul_scalar_dense(B, index, scale);
 
-        for (j = i + 1; j < row; j++) {
-            for (k = i + 1; k < col; k++)
-                B.m_[j * col + k]
-                    = sub(B.m_[j * col + k],
-                          mul(B.m_[j * col + i], B.m_[i * col + k]));
-            B.m_[j * col + i] = zero;
+        // The rows are updated independently of each other
+#pragma omp parallel for
+        for (unsigned r = i + 1; r < row; r++) {
+            for (unsigned c = i + 1; c < col; c++)
+                B.m_[r * col + c]
+                    = sub(B.m_[r * col + c],
+                          mul(B.m_[r * col + i], B.m_[i * col + c]));
+            B.m_[r * col + i] = zero;
         }
 
         index++;
@@ -567,18 +968,20 @@ void fraction_free_gaussian_elimination(const DenseMatrix &A, DenseMatrix &B)
     unsigned col = A.col_;
     B.m_ = A.m_;
 
-    for (unsigned i = 0; i < col - 1; i++)
+    for (unsigned i = 0; i < col - 1; i++) {
+        const RCP<const Basic> prev
+            = i > 0 ? B.m_[i * col - col + i - 1] : RCP<const Basic>();
+#pragma omp parallel for
         for (unsigned j = i + 1; j < A.row_; j++) {
             for (unsigned k = i + 1; k < col; k++) {
                 B.m_[j * col + k]
-                    = sub(mul(B.m_[i * col + i], B.m_[j * col + k]),
-                          mul(B.m_[j * col + i], B.m_[i * col + k]));
-                if (i > 0)
-                    B.m_[j * col + k]
-                        = div(B.m_[j * col + k], B.m_[i * col - col + i - 1]);
+                    = bareiss_update(B.m_[i * col + i], B.m_[j * col + k],
+                                     B.m_[j * col + i], B.m_[i * col + k],
+                                     prev);
             }
             B.m_[j * col + i] = zero;
         }
+    }
 }
 
 // Pivoted version of `fraction_free_gaussian_elimination`
@@ -588,7 +991,7 @@ void pivoted_fraction_free_gaussian_elimination(const DenseMatrix &A,
     SYMENGINE_ASSERT(A.row_ == B.row_ and A.col_ == B.col_);
 
     unsigned col = A.col_, row = A.row_;
-    unsigned index = 0, i, k, j;
+    unsigned index = 0, i, k;
     B.m_ = A.m_;
 
     for (i = 0; i < col - 1; i++) {
@@ -603,16 +1006,17 @@ void pivoted_fraction_free_gaussian_elimination(const DenseMatrix &A,
             pl.push_back({k, index});
         }
 
-        for (j = i + 1; j < row; j++) {
-            for (k = i + 1; k < col; k++) {
-                B.m_[j * col + k]
-                    = sub(mul(B.m_[i * col + i], B.m_[j * col + k]),
-                          mul(B.m_[j * col + i], B.m_[i * col + k]));
-                if (i > 0)
-                    B.m_[j * col + k]
-                        = div(B.m_[j * col + k], B.m_[i * col - col + i - 1]);
+        const RCP<const Basic> prev
+            = i > 0 ? B.m_[i * col - col + i - 1] : RCP<const Basic>();
+#pragma omp parallel for
+        for (unsigned r = i + 1; r < row; r++) {
+            for (unsigned c = i + 1; c < col; c++) {
+                B.m_[r * col + c]
+                    = bareiss_update(B.m_[i * col + i], B.m_[r * col + c],
+                                     B.m_[r * col + i], B.m_[i * col + c],
+                                     prev);
             }
-            B.m_[j * col + i] = zero;
+            B.m_[r * col + i] = zero;
         }
 
         index++;
@@ -844,6 +1248,11 @@ void fraction_free_gaussian_elimination_solve(const DenseMatrix &A,
     SYMENGINE_ASSERT(b.row_ == A.row_ and x.row_ == A.row_);
     SYMENGINE_ASSERT(x.col_ == b.col_);
 
+    if (is_rational_matrix(A) and is_rational_matrix(b)
+        and multimodular_solve(A, b, x)) {
+        return;
+    }
+
     int i, j, k, col = A.col_, bcol = b.col_;
     DenseMatrix A_ = DenseMatrix(A.row_, A.col_, A.m_);
     DenseMatrix b_ = DenseMatrix(b.row_, b.col_, b.m_);
@@ -997,19 +1406,20 @@ void fraction_free_LU(const DenseMatrix &A, DenseMatrix &LU)
                      and A.row_ == LU.row_);
 
     unsigned n = A.row_;
-    unsigned i, j, k;
 
     LU.m_ = A.m_;
 
-    for (i = 0; i < n - 1; i++)
-        for (j = i + 1; j < n; j++)
-            for (k = i + 1; k < n; k++) {
-                LU.m_[j * n + k] = sub(mul(LU.m_[i * n + i], LU.m_[j * n + k]),
-                                       mul(LU.m_[j * n + i], LU.m_[i * n + k]));
-                if (i)
-                    LU.m_[j * n + k]
-                        = div(LU.m_[j * n + k], LU.m_[i * n - n + i - 1]);
+    for (unsigned i = 0; i + 1 < n; i++) {
+        const RCP<const Basic> prev
+            = i > 0 ? LU.m_[i * n - n + i - 1] : RCP<const Basic>();
+#pragma omp parallel for
+        for (unsigned j = i + 1; j < n; j++)
+            for (unsigned k = i + 1; k < n; k++) {
+                LU.m_[j * n + k]
+                    = bareiss_update(LU.m_[i * n + i], LU.m_[j * n + k],
+                                     LU.m_[j * n + i], LU.m_[i * n + k], prev);
             }
+    }
 }
 
 // SymPy LUDecomposition algorithm, in
@@ -1337,10 +1747,11 @@ RCP<const Basic> det_bareis(const DenseMatrix &A)
                    add(add(mul(mul(A.m_[2], A.m_[4]), A.m_[6]),
                            mul(mul(A.m_[1], A.m_[3]), A.m_[8])),
                        mul(mul(A.m_[0], A.m_[5]), A.m_[7])));
+    } else if (is_rational_matrix(A)) {
+        return det_multimodular(A);
     } else {
         DenseMatrix B = DenseMatrix(n, n, A.m_);
         unsigned i, sign = 1;
-        RCP<const Basic> d;
 
         for (unsigned k = 0; k < n - 1; k++) {
             if (eq(*(B.m_[k * n + k]), *zero)) {
@@ -1354,13 +1765,16 @@ RCP<const Basic> det_bareis(const DenseMatrix &A)
                     return zero;
             }
 
-            for (i = k + 1; i < n; i++) {
+            const RCP<const Basic> prev
+                = k > 0 ? B.m_[(k - 1) * n + k - 1] : RCP<const Basic>();
+            // The rows below the pivot are updated independently
+#pragma omp parallel for
+            for (unsigned r = k + 1; r < n; r++) {
                 for (unsigned j = k + 1; j < n; j++) {
-                    d = sub(mul(B.m_[k * n + k], B.m_[i * n + j]),
-                            mul(B.m_[i * n + k], B.m_[k * n + j]));
-                    if (k > 0)
-                        d = div(d, B.m_[(k - 1) * n + k - 1]);
-                    B.m_[i * n + j] = d;
+                    B.m_[r * n + j]
+                        = bareiss_update(B.m_[k * n + k], B.m_[r * n + j],
+                                         B.m_[r * n + k], B.m_[k * n + j],
+                                         prev);
                 }
             }
         }
@@ -1,7 +1,15 @@
+#include <unordered_map>
+
 #include <symengine/visitor.h>
 #include <symengine/subs.h>
 #include <symengine/symengine_casts.h>
 
+#ifdef WITH_SYMENGINE_THREAD_SAFE
+#define SYMENGINE_THREAD_LOCAL thread_local
+#else
+#define SYMENGINE_THREAD_LOCAL
+#endif
+
 namespace SymEngine
 {
 
@@ -688,10 +696,66 @@ public:
     }
 };
 
+namespace
+{
+
+// The derivatives w.r.t. `x` computed during the current top level call of
+// `diff`, so that the subexpressions shared in a DAG are differentiated
+// once. The nodes are kept alive by the table, their addresses can then not
+// be reused by the temporaries created while differentiating.
+class DiffMemo
+{
+public:
+    const RCP<const Symbol> x;
+    std::unordered_map<const Basic *,
+                       std::pair<RCP<const Basic>, RCP<const Basic>>>
+        results;
+    DiffMemo *const previous;
+    static SYMENGINE_THREAD_LOCAL DiffMemo *current;
+
+    DiffMemo(const RCP<const Symbol> &x) : x(x), previous(current)
+    {
+        current = this;
+    }
+    ~DiffMemo()
+    {
+        current = previous;
+    }
+    DiffMemo(const DiffMemo &) = delete;
+    DiffMemo &operator=(const DiffMemo &) = delete;
+};
+
+SYMENGINE_THREAD_LOCAL DiffMemo *DiffMemo::current = nullptr;
+
+template <typename T>
+RCP<const Basic> memoized_diff(const T &self, const RCP<const Symbol> &x)
+{
+    if (is_a_Number(self) or is_a<Symbol>(self) or is_a<Constant>(self)) {
+        return DiffImplementation::diff(self, x);
+    }
+    DiffMemo *memo = DiffMemo::current;
+    if (memo == nullptr or memo->x.get() != x.get()) {
+        // A new top level call, or a derivative w.r.t. another symbol
+        // nested in the current one
+        DiffMemo nested(x);
+        RCP<const Basic> r = DiffImplementation::diff(self, x);
+        return r;
+    }
+    auto it = memo->results.find(&self);
+    if (it != memo->results.end()) {
+        return it->second.second;
+    }
+    RCP<const Basic> r = DiffImplementation::diff(self, x);
+    memo->results.emplace(&self, std::make_pair(self.rcp_from_this(), r));
+    return r;
+}
+
+} // namespace
+
 #define IMPLEMENT_DIFF(CLASS)                                                  \
     RCP<const Basic> CLASS::diff(const RCP<const Symbol> &x) const             \
     {                                                                          \
-        return DiffImplementation::diff(*this, x);                             \
+        return memoized_diff(*this, x);                                        \
     }
 
 #define SYMENGINE_ENUM(TypeID, Class) IMPLEMENT_DIFF(Class)
@@ -703,6 +767,200 @@ RCP<const Basic> diff(const RCP<const Basic> &arg, const RCP<const Symbol> &x)
     return arg->diff(x);
 }
 
+namespace
+{
+
+/*
+   Reverse mode differentiation: the nodes of the DAG of `f` that depend on
+   the symbols are sorted topologically, then the adjoint of every node
+   (the derivative of `f` w.r.t. the node) is propagated from `f` to the
+   children of the node, multiplied by the partial derivative of the node
+   w.r.t. the child. The adjoints of the symbols are the gradient.
+
+   Add, Mul, Pow and the one argument functions are differentiated this way.
+   The other nodes are differentiated in forward mode w.r.t. each symbol and
+   their contributions go to the gradient directly.
+*/
+class GradientBuilder
+{
+private:
+    const vec_sym &x_;
+    std::unordered_map<RCP<const Basic>, unsigned, RCPBasicHash, RCPBasicKeyEq>
+        symbol_index_;
+    // Topologically sorted nodes depending on the symbols, children first
+    vec_basic nodes_;
+    // Index in `nodes_`, or -1 for the nodes that do not depend on the
+    // symbols. The keys keep the nodes alive, as `get_args()` may return
+    // temporaries.
+    std::unordered_map<RCP<const Basic>, int, RCPBasicHash, RCPBasicKeyEq>
+        node_index_;
+    std::vector<vec_basic> adjoints_;
+    std::vector<vec_basic> gradient_;
+    // The derivatives of the one argument functions at `dummy_`. It is a
+    // Symbol and not a Dummy, as `Derivative` only accepts symbols; the probe
+    // `f(dummy_)` has no other free symbol, so its name cannot clash.
+    std::unordered_map<int, RCP<const Basic>> fdiffs_;
+    RCP<const Symbol> dummy_;
+
+    static bool is_reverse_node(const Basic &b)
+    {
+        return is_a<Add>(b) or is_a<Mul>(b) or is_a<Pow>(b)
+               or is_a_sub<OneArgFunction>(b);
+    }
+
+    // Sorts the nodes below `b`, returns whether `b` depends on the symbols
+    bool sort(const RCP<const Basic> &b)
+    {
+        if (is_a<Symbol>(*b)) {
+            return symbol_index_.find(b) != symbol_index_.end();
+        }
+        if (is_a_Number(*b) or is_a<Constant>(*b)) {
+            return false;
+        }
+        auto it = node_index_.find(b);
+        if (it != node_index_.end()) {
+            return it->second >= 0;
+        }
+        bool depends = false;
+        if (is_reverse_node(*b)) {
+            for (const auto &arg : b->get_args()) {
+                depends = sort(arg) or depends;
+            }
+        } else {
+            for (const auto &s : free_symbols(*b)) {
+                if (symbol_index_.find(s) != symbol_index_.end()) {
+                    depends = true;
+                    break;
+                }
+            }
+        }
+        if (depends) {
+            node_index_[b] = static_cast<int>(nodes_.size());
+            nodes_.push_back(b);
+        } else {
+            node_index_[b] = -1;
+        }
+        return depends;
+    }
+
+    // Adds `d`, the adjoint of `b` times the partial derivative w.r.t. `b`
+    void propagate(const RCP<const Basic> &b, const RCP<const Basic> &d)
+    {
+        if (is_a<Symbol>(*b)) {
+            auto it = symbol_index_.find(b);
+            if (it != symbol_index_.end()) {
+                gradient_[it->second].push_back(d);
+            }
+            return;
+        }
+        auto it = node_index_.find(b);
+        if (it != node_index_.end() and it->second >= 0) {
+            adjoints_[it->second].push_back(d);
+        }
+    }
+
+    // The derivative of the function `f` w.r.t. its argument, or null if it
+    // is not known
+    RCP<const Basic> fdiff(const OneArgFunction &f)
+    {
+        int id = static_cast<int>(f.get_type_code());
+        auto it = fdiffs_.find(id);
+        if (it == fdiffs_.end()) {
+            if (dummy_.is_null()) {
+                dummy_ = symbol("_xi");
+            }
+            RCP<const Basic> d = f.create(dummy_)->diff(dummy_);
+            if (not atoms<Derivative, Subs>(*d).empty()) {
+                d = null;
+            }
+            it = fdiffs_.emplace(id, d).first;
+        }
+        if (it->second.is_null()) {
+            return null;
+        }
+        return it->second->subs({{dummy_, f.get_arg()}});
+    }
+
+    void backward(const RCP<const Basic> &b, const RCP<const Basic> &adj)
+    {
+        if (is_a<Add>(*b)) {
+            for (const auto &p : down_cast<const Add &>(*b).get_dict()) {
+                propagate(p.first, mul(adj, p.second));
+            }
+        } else if (is_a<Mul>(*b)) {
+            for (const auto &p : down_cast<const Mul &>(*b).get_dict()) {
+                // d(b**e) = b**e * (e / b * db + log(b) * de)
+                RCP<const Basic> ab = mul(adj, b);
+                propagate(p.first, mul(ab, div(p.second, p.first)));
+                if (not is_a_Number(*p.second)) {
+                    propagate(p.second, mul(ab, log(p.first)));
+                }
+            }
+        } else if (is_a<Pow>(*b)) {
+            const Pow &x = down_cast<const Pow &>(*b);
+            propagate(x.get_base(),
+                      mul(adj, mul(x.get_exp(),
+                                   pow(x.get_base(), sub(x.get_exp(), one)))));
+            if (not is_a_Number(*x.get_exp())) {
+                propagate(x.get_exp(), mul(adj, mul(b, log(x.get_base()))));
+            }
+        } else {
+            if (is_a_sub<OneArgFunction>(*b)) {
+                const OneArgFunction &f = down_cast<const OneArgFunction &>(*b);
+                RCP<const Basic> d = fdiff(f);
+                if (not d.is_null()) {
+                    propagate(f.get_arg(), mul(adj, d));
+                    return;
+                }
+            }
+            for (unsigned j = 0; j < x_.size(); j++) {
+                RCP<const Basic> d = b->diff(x_[j]);
+                if (neq(*d, *zero)) {
+                    gradient_[j].push_back(mul(adj, d));
+                }
+            }
+        }
+    }
+
+public:
+    GradientBuilder(const vec_sym &x) : x_(x), gradient_(x.size())
+    {
+        for (unsigned j = 0; j < x.size(); j++) {
+            symbol_index_.emplace(x[j], j);
+        }
+    }
+
+    vec_basic apply(const RCP<const Basic> &f)
+    {
+        if (sort(f) and not is_a<Symbol>(*f)) {
+            adjoints_.resize(nodes_.size());
+            adjoints_.back().push_back(one);
+            // Every node is visited after all the nodes using it
+            for (size_t i = nodes_.size(); i-- > 0;) {
+                vec_basic &a = adjoints_[i];
+                RCP<const Basic> adj = a.size() == 1 ? a[0] : add(a);
+                a.clear();
+                backward(nodes_[i], adj);
+            }
+        } else if (is_a<Symbol>(*f)) {
+            propagate(f, one);
+        }
+        vec_basic result(x_.size());
+        for (unsigned j = 0; j < x_.size(); j++) {
+            result[j] = add(gradient_[j]);
+        }
+        return result;
+    }
+};
+
+} // namespace
+
+vec_basic gradient(const RCP<const Basic> &f, const vec_sym &x)
+{
+    GradientBuilder g(x);
+    return g.apply(f);
+}
+
 //! SymPy style differentiation for non-symbol variables
 // Since SymPy's differentiation makes no sense mathematically, it is
 // defined separately here for compatibility
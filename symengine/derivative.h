@@ -15,6 +15,14 @@ namespace SymEngine
 //! Differentiation w.r.t symbols
 RCP<const Basic> diff(const RCP<const Basic> &arg, const RCP<const Symbol> &x);
 
+/*! Gradient of `f` w.r.t. the symbols `x`. All the partial derivatives are
+    computed by one backward sweep (reverse mode) over the DAG of `f`, which
+    is faster than calling `diff` for each symbol when `f` has many shared
+    subexpressions or there are many symbols. The results are equal to the
+    ones of `diff`, but not always in the same form.
+*/
+vec_basic gradient(const RCP<const Basic> &f, const vec_sym &x);
+
 //! SymPy style differentiation w.r.t non-symbols and symbols
 RCP<const Basic> sdiff(const RCP<const Basic> &arg, const RCP<const Basic> &x);
 
@@ -1,4 +1,11 @@
+#include <algorithm>
+
 #include <symengine/visitor.h>
+#include <symengine/rings.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 namespace SymEngine
 {
@@ -19,6 +26,50 @@ inline void _imulnum(const Ptr<RCP<const Number>> &self,
     *self = _mulnum(*self, other);
 }
 
+namespace
+{
+
+// Products of two sums with at least this many pairs of terms are expanded
+// with the sparse polynomial multiplication of rings.h
+const size_t poly_mul_min_terms = 64;
+
+// Smallest amount of work (pairs of terms for products, terms of the
+// multinomial expansion for powers) that is split between threads
+const size_t poly_mul_min_work = 1 << 16;
+const size_t pow_expand_min_terms = 1 << 10;
+
+unsigned expand_num_threads = 0;
+
+// Number of threads to use for `work` items
+unsigned expand_threads(size_t work, size_t min_work)
+{
+#if defined(_OPENMP) && defined(WITH_SYMENGINE_THREAD_SAFE)
+    if (work < min_work)
+        return 1;
+    unsigned n = expand_num_threads;
+    if (n == 0)
+        n = numeric_cast<unsigned>(omp_get_max_threads());
+    // Leave at least `min_work` items to each thread
+    return std::max(1u, std::min<unsigned>(
+                            n, numeric_cast<unsigned>(work / min_work)));
+#else
+    return 1;
+#endif
+}
+
+bool is_exact_dict(const umap_basic_num &d)
+{
+    for (const auto &p : d) {
+        if (not p.second->is_exact()
+            or (is_a_Number(*p.first)
+                and not down_cast<const Number &>(*p.first).is_exact()))
+            return false;
+    }
+    return true;
+}
+
+} // namespace
+
 class ExpandVisitor : public BaseVisitor<ExpandVisitor>
 {
 private:
@@ -82,6 +133,12 @@ public:
     {
         // Both a and b are assumed to be expanded
         if (is_a<Add>(*a) && is_a<Add>(*b)) {
+            if ((down_cast<const Add &>(*a)).get_dict().size()
+                        * (down_cast<const Add &>(*b)).get_dict().size()
+                    >= poly_mul_min_terms
+                and poly_mul_expand(down_cast<const Add &>(*a),
+                                    down_cast<const Add &>(*b)))
+                return;
             iaddnum(outArg(coeff),
                     _mulnum(multiply,
                             _mulnum(down_cast<const Add &>(*a).get_coef(),
@@ -188,6 +245,40 @@ public:
         _coef_dict_add_term(multiply, mul(a, b));
     }
 
+    // Multiplies `a` and `b` as sparse polynomials with integer coefficients,
+    // which avoids creating a `Mul` for each pair of terms. Returns false if
+    // they are not polynomials in common generators.
+    bool poly_mul_expand(const Add &a, const Add &b)
+    {
+        umap_basic_num syms;
+        if (not poly_gens(a.rcp_from_this(), syms)
+            or not poly_gens(b.rcp_from_this(), syms))
+            return false;
+        vec_basic gens(syms.size());
+        for (const auto &p : syms)
+            gens[numeric_cast<size_t>(
+                down_cast<const Integer &>(*p.second).as_int())]
+                = p.first;
+        umap_vec_mpz A, B, C;
+        expr2poly(a.rcp_from_this(), syms, A);
+        expr2poly(b.rcp_from_this(), syms, B);
+        poly_mul(A, B, C,
+                 expand_threads(A.size() * B.size(), poly_mul_min_work));
+        RCP<const Basic> r = poly2expr(C, gens);
+        if (is_a<Add>(*r)) {
+            const Add &s = down_cast<const Add &>(*r);
+            iaddnum(outArg(coeff), _mulnum(multiply, s.get_coef()));
+#if defined(HAVE_SYMENGINE_RESERVE)
+            d_.reserve(d_.size() + s.get_dict().size());
+#endif
+            for (const auto &p : s.get_dict())
+                Add::dict_add_term(d_, _mulnum(multiply, p.second), p.first);
+        } else {
+            _coef_dict_add_term(multiply, r);
+        }
+        return true;
+    }
+
     void square_expand(umap_basic_num &base_dict)
     {
         long m = base_dict.size();
@@ -222,7 +313,36 @@ public:
 #if defined(HAVE_SYMENGINE_RESERVE)
         d_.reserve(d_.size() + 2 * r.size());
 #endif
-        for (auto &p : r) {
+        std::vector<map_vec_mpz::value_type *> terms;
+        terms.reserve(r.size());
+        for (auto &p : r)
+            terms.push_back(&p);
+        unsigned nt = expand_threads(terms.size(), pow_expand_min_terms);
+        if (nt > 1 and multiply->is_exact() and is_exact_dict(base_dict)) {
+            // Every thread expands a contiguous range of the terms into its
+            // own visitor. All coefficients are exact, so merging the
+            // partial sums in any order gives the serial result.
+            std::vector<ExpandVisitor> parts(nt, ExpandVisitor(deep));
+#pragma omp parallel for num_threads(nt) schedule(static, 1)
+            for (int k = 0; k < static_cast<int>(nt); k++) {
+                parts[k].multiply = multiply;
+                parts[k].pow_expand_terms(base_dict, terms,
+                                          terms.size() * k / nt,
+                                          terms.size() * (k + 1) / nt);
+            }
+            merge_parts(parts);
+            return;
+        }
+        pow_expand_terms(base_dict, terms, 0, terms.size());
+    }
+
+    // Expands the terms `terms[begin:end]` of the multinomial expansion
+    void pow_expand_terms(const umap_basic_num &base_dict,
+                          const std::vector<map_vec_mpz::value_type *> &terms,
+                          size_t begin, size_t end)
+    {
+        for (size_t i = begin; i < end; i++) {
+            auto &p = *terms[i];
             auto power = p.first.begin();
             auto i2 = base_dict.begin();
             map_basic_basic d;
@@ -288,6 +408,30 @@ public:
         }
     }
 
+    // Adds the partial sums of `parts` into this visitor, pairwise in a tree
+    // so that the merges of each level run in parallel.
+    void merge_parts(std::vector<ExpandVisitor> &parts)
+    {
+        int nt = static_cast<int>(parts.size());
+        for (int step = 1; step < nt; step *= 2) {
+#pragma omp parallel for num_threads(nt) schedule(static, 1)
+            for (int k = 0; k < nt - step; k += 2 * step) {
+                parts[k].merge(parts[k + step]);
+            }
+        }
+        merge(parts[0]);
+    }
+
+    void merge(ExpandVisitor &other)
+    {
+        if (d_.size() < other.d_.size())
+            std::swap(d_, other.d_);
+        for (const auto &p : other.d_)
+            Add::dict_add_term(d_, p.second, p.first);
+        iaddnum(outArg(coeff), other.coeff);
+        other.d_.clear();
+    }
+
     void bvisit(const Pow &self)
     {
         RCP<const Basic> _base = expand_if_deep(self.get_base());
@@ -366,6 +510,16 @@ private:
     }
 };
 
+void set_expand_num_threads(unsigned n)
+{
+    expand_num_threads = n;
+}
+
+unsigned get_expand_num_threads()
+{
+    return expand_num_threads;
+}
+
 //! Expands `self`
 RCP<const Basic> expand(const RCP<const Basic> &self, bool deep)
 {
@@ -1,4 +1,5 @@
 #include <symengine/fields.h>
+#include <symengine/mod_word.h>
 #include <symengine/add.h>
 #include <symengine/constants.h>
 #include <symengine/mul.h>
@@ -109,6 +110,94 @@ vec_basic GaloisField::get_args() const
     return args;
 }
 
+namespace
+{
+// Kernels on the Montgomery representations of the coefficients, for the
+// moduli accepted by GaloisFieldDict::has_word_modulo()
+std::vector<uint64_t> to_words(const std::vector<integer_class> &v,
+                               const MontgomeryWord &M)
+{
+    std::vector<uint64_t> w(v.size());
+    for (size_t i = 0; i < v.size(); i++)
+        w[i] = M.to_mont(mp_get_ui(v[i]));
+    return w;
+}
+
+std::vector<integer_class> from_words(const std::vector<uint64_t> &w,
+                                      const MontgomeryWord &M)
+{
+    std::vector<integer_class> v(w.size());
+    for (size_t i = 0; i < w.size(); i++)
+        v[i] = static_cast<unsigned long>(M.from_mont(w[i]));
+    return v;
+}
+
+void strip_words(std::vector<uint64_t> &w)
+{
+    while (not w.empty() and w.back() == 0)
+        w.pop_back();
+}
+
+// Divides `f` by `g` (of degree dg <= deg f) in place: f[0, dg) is left with
+// the remainder and f[dg, deg f] with the quotient
+void divmod_words(std::vector<uint64_t> &f, const std::vector<uint64_t> &g,
+                  const MontgomeryWord &M)
+{
+    const size_t dg = g.size() - 1;
+    uint64_t inv = 0;
+    invmod_u64(inv, M.from_mont(g[dg]), M.modulus());
+    inv = M.to_mont(inv);
+    for (size_t i = f.size(); i-- > dg;) {
+        const uint64_t q = M.mul(f[i], inv);
+        f[i] = q;
+        if (q == 0)
+            continue;
+        uint64_t *r = &f[i - dg];
+        for (size_t j = 0; j < dg; j++)
+            r[j] = M.sub(r[j], M.mul(q, g[j]));
+    }
+}
+
+void make_monic_words(std::vector<uint64_t> &f, const MontgomeryWord &M)
+{
+    if (f.empty())
+        return;
+    uint64_t inv = 0;
+    invmod_u64(inv, M.from_mont(f.back()), M.modulus());
+    inv = M.to_mont(inv);
+    for (auto &c : f)
+        c = M.mul(c, inv);
+}
+} // namespace
+
+bool GaloisFieldDict::has_word_modulo() const
+{
+    return is_word_modulus(modulo_) and mp_get_ui(modulo_) % 2 == 1;
+}
+
+void GaloisFieldDict::gf_divmod_word(const GaloisFieldDict &o,
+                                     GaloisFieldDict &quo,
+                                     GaloisFieldDict &rem) const
+{
+    const MontgomeryWord M(mp_get_ui(modulo_));
+    std::vector<uint64_t> f = to_words(dict_, M), r;
+    const std::vector<uint64_t> g = to_words(o.dict_, M);
+    const size_t dg = g.size() - 1;
+    if (f.size() > dg) {
+        divmod_words(f, g, M);
+        r.assign(f.begin(), f.begin() + dg);
+        f.erase(f.begin(), f.begin() + dg);
+    } else {
+        r.swap(f);
+    }
+    strip_words(r);
+    strip_words(f);
+    quo.modulo_ = modulo_;
+    rem.modulo_ = modulo_;
+    quo.dict_ = from_words(f, M);
+    rem.dict_ = from_words(r, M);
+}
+
 GaloisFieldDict::GaloisFieldDict(const int &i, const integer_class &mod)
     : modulo_(mod)
 {
@@ -189,8 +278,23 @@ GaloisFieldDict GaloisFieldDict::mul(const GaloisFieldDict &a,
         return b;
 
     GaloisFieldDict p;
-    p.dict_.resize(a.degree() + b.degree() + 1, integer_class(0));
     p.modulo_ = a.modulo_;
+    if (a.has_word_modulo()) {
+        const MontgomeryWord M(mp_get_ui(a.modulo_));
+        const std::vector<uint64_t> u = to_words(a.dict_, M),
+                                    v = to_words(b.dict_, M);
+        std::vector<uint64_t> w(u.size() + v.size() - 1, 0);
+        for (size_t i = 0; i < u.size(); i++) {
+            if (u[i] == 0)
+                continue;
+            for (size_t j = 0; j < v.size(); j++)
+                w[i + j] = M.add(w[i + j], M.mul(u[i], v[j]));
+        }
+        strip_words(w);
+        p.dict_ = from_words(w, M);
+        return p;
+    }
+    p.dict_.resize(a.degree() + b.degree() + 1, integer_class(0));
     for (unsigned int i = 0; i <= a.degree(); i++)
         for (unsigned int j = 0; j <= b.degree(); j++) {
             auto temp = a.dict_[i];
@@ -226,6 +330,8 @@ void GaloisFieldDict::gf_div(const GaloisFieldDict &o,
     if (deg_dividend < deg_divisor) {
         *quo = GaloisFieldDict::from_vec(dict_out, modulo_);
         *rem = GaloisFieldDict::from_vec(dict_, modulo_);
+    } else if (has_word_modulo()) {
+        gf_divmod_word(o, *quo, *rem);
     } else {
         dict_out = dict_;
         integer_class inv;
@@ -341,6 +447,24 @@ GaloisFieldDict GaloisFieldDict::gf_gcd(const GaloisFieldDict &o) const
 {
     if (modulo_ != o.modulo_)
         throw SymEngineException("Error: field must be same.");
+    if (has_word_modulo()) {
+        const MontgomeryWord M(mp_get_ui(modulo_));
+        std::vector<uint64_t> f = to_words(dict_, M), g = to_words(o.dict_, M);
+        while (not g.empty()) {
+            // f, g = f % g, g
+            if (f.size() >= g.size()) {
+                divmod_words(f, g, M);
+                f.resize(g.size() - 1);
+                strip_words(f);
+            }
+            f.swap(g);
+        }
+        make_monic_words(f, M);
+        GaloisFieldDict res;
+        res.modulo_ = modulo_;
+        res.dict_ = from_words(f, M);
+        return res;
+    }
     GaloisFieldDict f = down_cast<const GaloisFieldDict &>(*this);
     GaloisFieldDict g = o;
     GaloisFieldDict temp_out;
@@ -399,6 +523,27 @@ vec_integer_class
 GaloisFieldDict::gf_multi_eval(const vec_integer_class &v) const
 {
     vec_integer_class res(v.size());
+    if (has_word_modulo()) {
+        // Horner's scheme at four points at once
+        const MontgomeryWord M(mp_get_ui(modulo_));
+        const std::vector<uint64_t> c = to_words(dict_, M);
+        integer_class t;
+        for (size_t i = 0; i < v.size(); i += 4) {
+            uint64_t x[4] = {0, 0, 0, 0}, y[4] = {0, 0, 0, 0};
+            const size_t m = std::min<size_t>(4, v.size() - i);
+            for (size_t k = 0; k < m; k++) {
+                mp_fdiv_r(t, v[i + k], modulo_);
+                x[k] = M.to_mont(mp_get_ui(t));
+            }
+            for (auto it = c.rbegin(); it != c.rend(); ++it) {
+                for (size_t k = 0; k < 4; k++)
+                    y[k] = M.add(M.mul(y[k], x[k]), *it);
+            }
+            for (size_t k = 0; k < m; k++)
+                res[i + k] = static_cast<unsigned long>(M.from_mont(y[k]));
+        }
+        return res;
+    }
     for (unsigned int i = 0; i < v.size(); ++i)
         res[i] = gf_eval(v[i]);
     return res;
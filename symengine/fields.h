@@ -403,6 +403,11 @@ public:
             dict_.clear();
             return down_cast<GaloisFieldDict &>(*this);
         }
+        if (has_word_modulo()) {
+            GaloisFieldDict rem;
+            gf_divmod_word(other, *this, rem);
+            return down_cast<GaloisFieldDict &>(*this);
+        }
         dict_out.swap(dict_);
         dict_.resize(deg_dividend - deg_divisor + 1);
         integer_class coeff;
@@ -467,6 +472,11 @@ public:
         if (deg_dividend < deg_divisor) {
             return down_cast<GaloisFieldDict &>(*this);
         }
+        if (has_word_modulo()) {
+            GaloisFieldDict quo;
+            gf_divmod_word(other, quo, *this);
+            return down_cast<GaloisFieldDict &>(*this);
+        }
         dict_out.swap(dict_);
         dict_.resize(deg_divisor);
         integer_class coeff;
@@ -532,6 +542,14 @@ public:
 
     void gf_istrip();
 
+    //! True if `modulo_` is odd and below 2**63, then the division, gcd,
+    //! product and multipoint evaluation run on machine words in Montgomery
+    //! form (see mod_word.h)
+    bool has_word_modulo() const;
+    //! gf_div on machine words, `quo` and `rem` may be `*this`
+    void gf_divmod_word(const GaloisFieldDict &o, GaloisFieldDict &quo,
+                        GaloisFieldDict &rem) const;
+
     bool is_one() const
     {
         if (dict_.size() == 1)
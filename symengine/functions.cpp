@@ -1790,7 +1790,7 @@ Derivative::Derivative(const RCP<const Basic> &arg, const multiset_basic &x)
 }
 
 bool Derivative::is_canonical(const RCP<const Basic> &arg,
-                              const multiset_basic &x) const
+                              const multiset_basic &x)
 {
     // Check that 'x' are Symbols:
     for (const auto &a : x)
@@ -1890,7 +1890,7 @@ Subs::Subs(const RCP<const Basic> &arg, const map_basic_basic &dict)
 }
 
 bool Subs::is_canonical(const RCP<const Basic> &arg,
-                        const map_basic_basic &dict) const
+                        const map_basic_basic &dict)
 {
     if (is_a<Derivative>(*arg)) {
         return true;
@@ -712,8 +712,8 @@ public:
         args.insert(args.end(), x_.begin(), x_.end());
         return args;
     }
-    bool is_canonical(const RCP<const Basic> &arg,
-                      const multiset_basic &x) const;
+    static bool is_canonical(const RCP<const Basic> &arg,
+                             const multiset_basic &x);
 };
 
 /*! Subs operator
@@ -751,8 +751,8 @@ public:
     virtual vec_basic get_point() const;
     virtual vec_basic get_args() const;
 
-    bool is_canonical(const RCP<const Basic> &arg,
-                      const map_basic_basic &x) const;
+    static bool is_canonical(const RCP<const Basic> &arg,
+                             const map_basic_basic &x);
 };
 
 class HyperbolicBase : public OneArgFunction
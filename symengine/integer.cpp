@@ -6,6 +6,23 @@
 namespace SymEngine
 {
 
+const RCP<const Integer> &cached_integer(long i)
+{
+    // Constructed on first use, so that it can be used while other static
+    // objects are constructed. It is destroyed at exit after the globals
+    // initialized from it, so no Integer is left undestroyed.
+    static const std::vector<RCP<const Integer>> cache = []() {
+        std::vector<RCP<const Integer>> v;
+        v.reserve(integer_cache_max - integer_cache_min + 1);
+        for (long j = integer_cache_min; j <= integer_cache_max; j++) {
+            v.push_back(make_rcp<const Integer>(integer_class(j)));
+        }
+        return v;
+    }();
+    SYMENGINE_ASSERT(is_cached_integer(i))
+    return cache[i - integer_cache_min];
+}
+
 hash_t Integer::__hash__() const
 {
     // only the least significant bits that fit into "long long int" are
@@ -11,6 +11,8 @@
 #include <symengine/symengine_exception.h>
 #include <symengine/symengine_casts.h>
 
+#include <limits>
+
 namespace SymEngine
 {
 
@@ -85,20 +87,11 @@ public:
 
     /* These are very fast methods for add/sub/mul/div/pow on Integers only */
     //! Fast Integer Addition
-    inline RCP<const Integer> addint(const Integer &other) const
-    {
-        return make_rcp<const Integer>(this->i + other.i);
-    }
+    inline RCP<const Integer> addint(const Integer &other) const;
     //! Fast Integer Subtraction
-    inline RCP<const Integer> subint(const Integer &other) const
-    {
-        return make_rcp<const Integer>(this->i - other.i);
-    }
+    inline RCP<const Integer> subint(const Integer &other) const;
     //! Fast Integer Multiplication
-    inline RCP<const Integer> mulint(const Integer &other) const
-    {
-        return make_rcp<const Integer>(this->i * other.i);
-    }
+    inline RCP<const Integer> mulint(const Integer &other) const;
     //!  Integer Division
     RCP<const Number> divint(const Integer &other) const;
     //! Fast Negative Power Evaluation
@@ -118,10 +111,7 @@ public:
         return make_rcp<const Integer>(std::move(tmp));
     }
     //! \return negative of self.
-    inline RCP<const Integer> neg() const
-    {
-        return make_rcp<const Integer>(-i);
-    }
+    inline RCP<const Integer> neg() const;
 
     /* These are general methods, overriden from the Number class, that need to
      * check types to decide what operation to do, and so are a bit slower. */
@@ -195,21 +185,100 @@ struct RCPIntegerKeyLess {
         return a->as_integer_class() < b->as_integer_class();
     }
 };
+
+/*! Integers in the range [integer_cache_min, integer_cache_max] are
+    preallocated, `integer()` returns the shared instance for them instead of
+    allocating a new one.
+*/
+const long integer_cache_min = -256;
+const long integer_cache_max = 1024;
+
+//! \return the preallocated Integer `i`, `i` must be in the cache range
+const RCP<const Integer> &cached_integer(long i);
+
+template <typename T>
+inline typename std::enable_if<std::is_signed<T>::value, bool>::type
+is_cached_integer(T i)
+{
+    return i >= integer_cache_min and i <= integer_cache_max;
+}
+
+template <typename T>
+inline typename std::enable_if<std::is_unsigned<T>::value, bool>::type
+is_cached_integer(T i)
+{
+    return i <= static_cast<unsigned long>(integer_cache_max);
+}
+
 //! \return RCP<const Integer> from integral values
 template <typename T>
 inline typename std::enable_if<std::is_integral<T>::value,
                                RCP<const Integer>>::type
 integer(T i)
 {
+    if (is_cached_integer(i))
+        return cached_integer(static_cast<long>(i));
     return make_rcp<const Integer>(integer_class(i));
 }
 
 //! \return RCP<const Integer> from integer_class
 inline RCP<const Integer> integer(integer_class i)
 {
+    if (mp_fits_slong_p(i)) {
+        long l = mp_get_si(i);
+        if (is_cached_integer(l))
+            return cached_integer(l);
+    }
     return make_rcp<const Integer>(std::move(i));
 }
 
+/*! Sums and products of two `long`s smaller than `small_int_bound` in
+    absolute value cannot overflow, so the arithmetic on such Integers is done
+    in machine words and only the result is converted to `integer_class`.
+*/
+const long small_int_bound = 1L << (std::numeric_limits<long>::digits / 2);
+
+//! \return true and sets `r` if `i` is smaller than `small_int_bound`
+inline bool get_small_int(const integer_class &i, long &r)
+{
+    if (not mp_fits_slong_p(i))
+        return false;
+    r = mp_get_si(i);
+    return r < small_int_bound and r > -small_int_bound;
+}
+
+inline RCP<const Integer> Integer::addint(const Integer &other) const
+{
+    long a, b;
+    if (get_small_int(this->i, a) and get_small_int(other.i, b))
+        return integer(a + b);
+    return integer(this->i + other.i);
+}
+
+inline RCP<const Integer> Integer::subint(const Integer &other) const
+{
+    long a, b;
+    if (get_small_int(this->i, a) and get_small_int(other.i, b))
+        return integer(a - b);
+    return integer(this->i - other.i);
+}
+
+inline RCP<const Integer> Integer::mulint(const Integer &other) const
+{
+    long a, b;
+    if (get_small_int(this->i, a) and get_small_int(other.i, b))
+        return integer(a * b);
+    return integer(this->i * other.i);
+}
+
+inline RCP<const Integer> Integer::neg() const
+{
+    long a;
+    if (get_small_int(this->i, a))
+        return integer(-a);
+    return integer(-i);
+}
+
 //! Integer Square root
 RCP<const Integer> isqrt(const Integer &n);
 //! Integer nth root
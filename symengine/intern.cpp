@@ -0,0 +1,182 @@
+#include <symengine/intern.h>
+#include <symengine/visitor.h>
+
+namespace SymEngine
+{
+
+class InternVisitor : public BaseVisitor<InternVisitor>
+{
+private:
+    uset_basic &table_;
+    RCP<const Basic> result_;
+
+public:
+    InternVisitor(uset_basic &table) : table_(table)
+    {
+    }
+
+    void bvisit(const Basic &x)
+    {
+        result_ = x.rcp_from_this();
+    }
+
+    void bvisit(const Add &x)
+    {
+        bool changed = false;
+        umap_basic_num d;
+        RCP<const Number> coef
+            = rcp_static_cast<const Number>(apply(x.get_coef()));
+        changed = coef != x.get_coef();
+        for (const auto &p : x.get_dict()) {
+            RCP<const Basic> term = apply(p.first);
+            RCP<const Number> c
+                = rcp_static_cast<const Number>(apply(p.second));
+            changed = changed or term != p.first or c != p.second;
+            insert(d, term, c);
+        }
+        if (changed) {
+            result_ = make_rcp<const Add>(coef, std::move(d));
+        } else {
+            result_ = x.rcp_from_this();
+        }
+    }
+
+    void bvisit(const Mul &x)
+    {
+        bool changed = false;
+        map_basic_basic d;
+        RCP<const Number> coef
+            = rcp_static_cast<const Number>(apply(x.get_coef()));
+        changed = coef != x.get_coef();
+        for (const auto &p : x.get_dict()) {
+            RCP<const Basic> base = apply(p.first);
+            RCP<const Basic> exp = apply(p.second);
+            changed = changed or base != p.first or exp != p.second;
+            insert(d, base, exp);
+        }
+        if (changed) {
+            result_ = make_rcp<const Mul>(coef, std::move(d));
+        } else {
+            result_ = x.rcp_from_this();
+        }
+    }
+
+    void bvisit(const Pow &x)
+    {
+        RCP<const Basic> base = apply(x.get_base());
+        RCP<const Basic> exp = apply(x.get_exp());
+        if (base == x.get_base() and exp == x.get_exp()) {
+            result_ = x.rcp_from_this();
+        } else {
+            result_ = make_rcp<const Pow>(base, exp);
+        }
+    }
+
+    void bvisit(const OneArgFunction &x)
+    {
+        RCP<const Basic> arg = apply(x.get_arg());
+        if (arg == x.get_arg()) {
+            result_ = x.rcp_from_this();
+        } else {
+            result_ = x.create(arg);
+        }
+    }
+
+    template <class T>
+    void bvisit(const TwoArgBasic<T> &x)
+    {
+        RCP<const Basic> a = apply(x.get_arg1());
+        RCP<const Basic> b = apply(x.get_arg2());
+        if (a == x.get_arg1() and b == x.get_arg2()) {
+            result_ = x.rcp_from_this();
+        } else {
+            result_ = x.create(a, b);
+        }
+    }
+
+    void bvisit(const MultiArgFunction &x)
+    {
+        bool changed = false;
+        vec_basic v = x.get_args();
+        for (auto &elem : v) {
+            RCP<const Basic> a = apply(elem);
+            changed = changed or a != elem;
+            elem = a;
+        }
+        if (changed) {
+            result_ = x.create(v);
+        } else {
+            result_ = x.rcp_from_this();
+        }
+    }
+
+    RCP<const Basic> apply(const RCP<const Basic> &x)
+    {
+        auto it = table_.find(x);
+        if (it != table_.end()) {
+            return *it;
+        }
+        x->accept(*this);
+        // `result_` is structurally equal to `x`, but all its arguments are
+        // now the canonical instances.
+        RCP<const Basic> r = result_;
+        table_.insert(r);
+        return r;
+    }
+};
+
+RCP<const Basic> InternTable::intern(const RCP<const Basic> &x)
+{
+#ifdef WITH_SYMENGINE_THREAD_SAFE
+    std::lock_guard<std::mutex> lock(mutex_);
+#endif
+    InternVisitor v(table_);
+    return v.apply(x);
+}
+
+RCP<const Basic> InternTable::lookup(const RCP<const Basic> &x) const
+{
+#ifdef WITH_SYMENGINE_THREAD_SAFE
+    std::lock_guard<std::mutex> lock(mutex_);
+#endif
+    auto it = table_.find(x);
+    if (it != table_.end()) {
+        return *it;
+    }
+    return null;
+}
+
+bool InternTable::is_interned(const Basic &x) const
+{
+    RCP<const Basic> canonical = lookup(x.rcp_from_this());
+    return canonical.get() == &x;
+}
+
+size_t InternTable::size() const
+{
+#ifdef WITH_SYMENGINE_THREAD_SAFE
+    std::lock_guard<std::mutex> lock(mutex_);
+#endif
+    return table_.size();
+}
+
+void InternTable::clear()
+{
+#ifdef WITH_SYMENGINE_THREAD_SAFE
+    std::lock_guard<std::mutex> lock(mutex_);
+#endif
+    table_.clear();
+}
+
+InternTable &global_intern_table()
+{
+    static InternTable table;
+    return table;
+}
+
+RCP<const Basic> intern(const RCP<const Basic> &x)
+{
+    return global_intern_table().intern(x);
+}
+
+} // namespace SymEngine
@@ -0,0 +1,74 @@
+/**
+ *  \file intern.h
+ *  Hash-consing of expression trees
+ *
+ **/
+
+#ifndef SYMENGINE_INTERN_H
+#define SYMENGINE_INTERN_H
+
+#include <symengine/basic.h>
+
+#ifdef WITH_SYMENGINE_THREAD_SAFE
+#include <mutex>
+#endif
+
+namespace SymEngine
+{
+
+/*! Interning (hash-consing) table for expression trees.
+
+    `intern(x)` returns the canonical instance of `x`: the first expression
+    structurally equal to `x` that was interned into this table. All the
+    subexpressions of `x` are interned as well, so two interned expressions
+    share every common subtree. Once both operands are interned, `eq()`
+    reduces to a pointer comparison and dictionary lookups of their
+    subexpressions (for example in `Add::dict_add_term`) succeed on the
+    pointer check without walking the trees.
+
+    The table uses the cached `Basic::hash()` and keeps a reference to every
+    interned expression until `clear()` is called. Interning is opt-in;
+    expressions created by `add()`, `mul()` etc. are not interned unless
+    passed through a table.
+
+        InternTable t;
+        RCP<const Basic> a = t.intern(mul(x, y));
+        RCP<const Basic> b = t.intern(mul(y, x));
+        // a.get() == b.get()
+*/
+class InternTable
+{
+private:
+    uset_basic table_;
+#ifdef WITH_SYMENGINE_THREAD_SAFE
+    mutable std::mutex mutex_;
+#endif
+
+public:
+    InternTable()
+    {
+    }
+    InternTable(const InternTable &) = delete;
+    InternTable &operator=(const InternTable &) = delete;
+
+    //! \return the canonical instance of `x`, interning it if necessary
+    RCP<const Basic> intern(const RCP<const Basic> &x);
+    //! \return the canonical instance of `x` or null if it is not interned
+    RCP<const Basic> lookup(const RCP<const Basic> &x) const;
+    //! \return true if `x` is the canonical instance held by this table
+    bool is_interned(const Basic &x) const;
+    //! Number of distinct expressions held by the table
+    size_t size() const;
+    //! Release all the interned expressions
+    void clear();
+};
+
+//! \return the global interning table
+InternTable &global_intern_table();
+
+//! Interns `x` into the global table. \return the canonical instance of `x`
+RCP<const Basic> intern(const RCP<const Basic> &x);
+
+} // namespace SymEngine
+
+#endif // SYMENGINE_INTERN_H
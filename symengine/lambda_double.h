@@ -1,8 +1,10 @@
 #ifndef SYMENGINE_LAMBDA_DOUBLE_H
 #define SYMENGINE_LAMBDA_DOUBLE_H
 
+#include <algorithm>
 #include <cmath>
 #include <limits>
+#include <memory>
 #include <symengine/eval_double.h>
 #include <symengine/symengine_exception.h>
 #include <symengine/visitor.h>
@@ -533,6 +535,440 @@ public:
     }
 };
 
+/*! Evaluates real valued expressions at many points per call.
+
+    Every node of the expressions gets a buffer of `chunk_size` values and an
+    operation that fills it with a loop over the points, so the dispatch
+    through `std::function` is paid once per node and chunk of points
+    instead of once per node and point. The loops of the arithmetic
+    operations and elementary functions are simple enough to be vectorized
+    by the compiler. Nodes without such a kernel (Piecewise, relationals,
+    Max, ...) are evaluated point by point with a `LambdaRealDoubleVisitor`.
+    Common subexpressions are only evaluated once.
+
+        LambdaRealDoubleBatchVisitor v;
+        v.init({x, y}, {sin(x) * y, x + y});
+        // inps[j * n + i] is the input `j` at the point `i`
+        v.call(outs, inps, n);
+        // outs[k * n + i] is the output `k` at the point `i`
+*/
+class LambdaRealDoubleBatchVisitor
+    : public BaseVisitor<LambdaRealDoubleBatchVisitor>
+{
+public:
+    //! Number of points evaluated by each pass over the operations
+    static const size_t chunk_size = 256;
+
+protected:
+    // Computes the values of a node at `n` points, `w` holds `chunk_size`
+    // values for every node
+    typedef std::function<void(double *w, size_t n)> op;
+    std::vector<op> ops_;
+    std::vector<double> work_;
+    size_t num_slots_;
+    // Slots of the inputs and the outputs
+    std::vector<size_t> inputs_, outputs_;
+    // Symbols with a slot (the inputs and the cse replacements)
+    vec_basic symbols_;
+    std::vector<size_t> symbol_slots_;
+    std::map<RCP<const Basic>, size_t, RCPBasicKeyLess> slots_;
+    size_t result_;
+
+public:
+    void init(const vec_basic &x, const Basic &b, bool cse = false)
+    {
+        vec_basic outputs = {b.rcp_from_this()};
+        init(x, outputs, cse);
+    }
+
+    void init(const vec_basic &inputs, const vec_basic &outputs,
+              bool cse = false)
+    {
+        ops_.clear();
+        inputs_.clear();
+        outputs_.clear();
+        symbols_.clear();
+        symbol_slots_.clear();
+        slots_.clear();
+        num_slots_ = 0;
+        for (auto &p : inputs) {
+            inputs_.push_back(new_slot());
+            add_symbol(p, inputs_.back());
+        }
+        if (not cse) {
+            for (auto &p : outputs) {
+                outputs_.push_back(apply(*p));
+            }
+        } else {
+            vec_basic reduced_exprs;
+            vec_pair replacements;
+            SymEngine::cse(replacements, reduced_exprs, outputs);
+            for (auto &rep : replacements) {
+                add_symbol(rep.first, apply(*(rep.second)));
+            }
+            for (auto &p : reduced_exprs) {
+                outputs_.push_back(apply(*p));
+            }
+        }
+        slots_.clear();
+        work_.assign(num_slots_ * chunk_size, 0.0);
+    }
+
+    size_t apply(const Basic &b)
+    {
+        RCP<const Basic> key = b.rcp_from_this();
+        auto it = slots_.find(key);
+        if (it != slots_.end())
+            return it->second;
+        b.accept(*this);
+        slots_[key] = result_;
+        return result_;
+    }
+
+    //! Evaluates at `n` points, the inputs and outputs are stored by
+    //! variable: `inps[j * n + i]` is the input `j` at the point `i`
+    void call(double *outs, const double *inps, size_t n)
+    {
+        double *w = work_.data();
+        for (size_t k = 0; k < n; k += chunk_size) {
+            size_t m = n - k < chunk_size ? n - k : chunk_size;
+            for (size_t j = 0; j < inputs_.size(); j++) {
+                std::copy(inps + j * n + k, inps + j * n + k + m,
+                          w + inputs_[j] * chunk_size);
+            }
+            for (auto &f : ops_) {
+                f(w, m);
+            }
+            for (size_t j = 0; j < outputs_.size(); j++) {
+                const double *o = w + outputs_[j] * chunk_size;
+                std::copy(o, o + m, outs + j * n + k);
+            }
+        }
+    }
+
+    void bvisit(const Symbol &x)
+    {
+        throw SymEngineException("Symbol not in the symbols vector.");
+    }
+
+    void bvisit(const Number &x)
+    {
+        result_ = constant(eval_double(x));
+    }
+
+    void bvisit(const Constant &x)
+    {
+        result_ = constant(eval_double(x));
+    }
+
+    void bvisit(const Add &x)
+    {
+        std::vector<std::pair<double, size_t>> terms;
+        for (const auto &p : x.get_dict()) {
+            terms.push_back(
+                {eval_double(*p.second), apply(*p.first) * chunk_size});
+        }
+        double c = eval_double(*x.get_coef());
+        size_t out = new_slot() * chunk_size;
+        ops_.push_back([=](double *w, size_t n) {
+            double *o = w + out;
+            for (size_t i = 0; i < n; i++)
+                o[i] = c;
+            for (const auto &t : terms) {
+                const double *a = w + t.second;
+                for (size_t i = 0; i < n; i++)
+                    o[i] += t.first * a[i];
+            }
+        });
+        result_ = out / chunk_size;
+    }
+
+    void bvisit(const Mul &x)
+    {
+        std::vector<size_t> factors;
+        for (const auto &p : x.get_dict()) {
+            factors.push_back(power(*p.first, *p.second) * chunk_size);
+        }
+        double c = eval_double(*x.get_coef());
+        size_t out = new_slot() * chunk_size;
+        ops_.push_back([=](double *w, size_t n) {
+            double *o = w + out;
+            for (size_t i = 0; i < n; i++)
+                o[i] = c;
+            for (size_t f : factors) {
+                const double *a = w + f;
+                for (size_t i = 0; i < n; i++)
+                    o[i] *= a[i];
+            }
+        });
+        result_ = out / chunk_size;
+    }
+
+    void bvisit(const Pow &x)
+    {
+        result_ = power(*x.get_base(), *x.get_exp());
+    }
+
+    void bvisit(const Sin &x)
+    {
+        unary(x, [](double v) { return std::sin(v); });
+    }
+
+    void bvisit(const Cos &x)
+    {
+        unary(x, [](double v) { return std::cos(v); });
+    }
+
+    void bvisit(const Tan &x)
+    {
+        unary(x, [](double v) { return std::tan(v); });
+    }
+
+    void bvisit(const Cot &x)
+    {
+        unary(x, [](double v) { return 1.0 / std::tan(v); });
+    }
+
+    void bvisit(const Csc &x)
+    {
+        unary(x, [](double v) { return 1.0 / std::sin(v); });
+    }
+
+    void bvisit(const Sec &x)
+    {
+        unary(x, [](double v) { return 1.0 / std::cos(v); });
+    }
+
+    void bvisit(const ASin &x)
+    {
+        unary(x, [](double v) { return std::asin(v); });
+    }
+
+    void bvisit(const ACos &x)
+    {
+        unary(x, [](double v) { return std::acos(v); });
+    }
+
+    void bvisit(const ASec &x)
+    {
+        unary(x, [](double v) { return std::acos(1.0 / v); });
+    }
+
+    void bvisit(const ACsc &x)
+    {
+        unary(x, [](double v) { return std::asin(1.0 / v); });
+    }
+
+    void bvisit(const ATan &x)
+    {
+        unary(x, [](double v) { return std::atan(v); });
+    }
+
+    void bvisit(const ACot &x)
+    {
+        unary(x, [](double v) { return std::atan(1.0 / v); });
+    }
+
+    void bvisit(const Sinh &x)
+    {
+        unary(x, [](double v) { return std::sinh(v); });
+    }
+
+    void bvisit(const Csch &x)
+    {
+        unary(x, [](double v) { return 1.0 / std::sinh(v); });
+    }
+
+    void bvisit(const Cosh &x)
+    {
+        unary(x, [](double v) { return std::cosh(v); });
+    }
+
+    void bvisit(const Sech &x)
+    {
+        unary(x, [](double v) { return 1.0 / std::cosh(v); });
+    }
+
+    void bvisit(const Tanh &x)
+    {
+        unary(x, [](double v) { return std::tanh(v); });
+    }
+
+    void bvisit(const Coth &x)
+    {
+        unary(x, [](double v) { return 1.0 / std::tanh(v); });
+    }
+
+    void bvisit(const ASinh &x)
+    {
+        unary(x, [](double v) { return std::asinh(v); });
+    }
+
+    void bvisit(const ACsch &x)
+    {
+        unary(x, [](double v) { return std::asinh(1.0 / v); });
+    }
+
+    void bvisit(const ACosh &x)
+    {
+        unary(x, [](double v) { return std::acosh(v); });
+    }
+
+    void bvisit(const ATanh &x)
+    {
+        unary(x, [](double v) { return std::atanh(v); });
+    }
+
+    void bvisit(const ACoth &x)
+    {
+        unary(x, [](double v) { return std::atanh(1.0 / v); });
+    }
+
+    void bvisit(const ASech &x)
+    {
+        unary(x, [](double v) { return std::acosh(1.0 / v); });
+    }
+
+    void bvisit(const Log &x)
+    {
+        unary(x, [](double v) { return std::log(v); });
+    }
+
+    void bvisit(const Abs &x)
+    {
+        unary(x, [](double v) { return std::abs(v); });
+    }
+
+    void bvisit(const Gamma &x)
+    {
+        unary(x, [](double v) { return std::tgamma(v); });
+    }
+
+    void bvisit(const LogGamma &x)
+    {
+        unary(x, [](double v) { return std::lgamma(v); });
+    }
+
+    void bvisit(const Erf &x)
+    {
+        unary(x, [](double v) { return std::erf(v); });
+    }
+
+    void bvisit(const Erfc &x)
+    {
+        unary(x, [](double v) { return std::erfc(v); });
+    }
+
+    void bvisit(const ATan2 &x)
+    {
+        result_ = binary(apply(*x.get_num()), apply(*x.get_den()),
+                         [](double a, double b) { return std::atan2(a, b); });
+    }
+
+    // Everything else is evaluated point by point
+    void bvisit(const Basic &x)
+    {
+        auto v = std::make_shared<LambdaRealDoubleVisitor>();
+        v->init(symbols_, x);
+        std::vector<size_t> args;
+        for (size_t s : symbol_slots_)
+            args.push_back(s * chunk_size);
+        size_t out = new_slot() * chunk_size;
+        ops_.push_back([=](double *w, size_t n) {
+            std::vector<double> point(args.size());
+            double *o = w + out;
+            for (size_t i = 0; i < n; i++) {
+                for (size_t j = 0; j < args.size(); j++)
+                    point[j] = w[args[j] + i];
+                v->call(o + i, point.data());
+            }
+        });
+        result_ = out / chunk_size;
+    }
+
+protected:
+    size_t new_slot()
+    {
+        return num_slots_++;
+    }
+
+    void add_symbol(const RCP<const Basic> &x, size_t slot)
+    {
+        symbols_.push_back(x);
+        symbol_slots_.push_back(slot);
+        slots_[x] = slot;
+    }
+
+    size_t constant(double c)
+    {
+        size_t out = new_slot() * chunk_size;
+        ops_.push_back([=](double *w, size_t n) {
+            std::fill(w + out, w + out + n, c);
+        });
+        return out / chunk_size;
+    }
+
+    template <typename F>
+    size_t unary_slot(size_t arg, F f)
+    {
+        size_t a = arg * chunk_size;
+        size_t out = new_slot() * chunk_size;
+        ops_.push_back([=](double *w, size_t n) {
+            const double *x = w + a;
+            double *o = w + out;
+            for (size_t i = 0; i < n; i++)
+                o[i] = f(x[i]);
+        });
+        return out / chunk_size;
+    }
+
+    template <typename F>
+    void unary(const Basic &x, F f)
+    {
+        result_ = unary_slot(apply(*x.get_args()[0]), f);
+    }
+
+    template <typename F>
+    size_t binary(size_t arg1, size_t arg2, F f)
+    {
+        size_t a = arg1 * chunk_size, b = arg2 * chunk_size;
+        size_t out = new_slot() * chunk_size;
+        ops_.push_back([=](double *w, size_t n) {
+            const double *x = w + a;
+            const double *y = w + b;
+            double *o = w + out;
+            for (size_t i = 0; i < n; i++)
+                o[i] = f(x[i], y[i]);
+        });
+        return out / chunk_size;
+    }
+
+    // Slot of `base**exp`, with special kernels for common numeric exponents
+    size_t power(const Basic &base, const Basic &exp)
+    {
+        if (eq(base, *E))
+            return unary_slot(apply(exp),
+                              [](double v) { return std::exp(v); });
+        size_t b = apply(base);
+        if (not is_a_Number(exp))
+            return binary(b, apply(exp), [](double x, double y) {
+                return std::pow(x, y);
+            });
+        double e = eval_double(exp);
+        if (e == 1.0)
+            return b;
+        if (e == 2.0)
+            return unary_slot(b, [](double v) { return v * v; });
+        if (e == -1.0)
+            return unary_slot(b, [](double v) { return 1.0 / v; });
+        if (e == 0.5)
+            return unary_slot(b, [](double v) { return std::sqrt(v); });
+        if (e == -0.5)
+            return unary_slot(b, [](double v) { return 1.0 / std::sqrt(v); });
+        return unary_slot(b, [e](double v) { return std::pow(v, e); });
+    }
+};
+
 class LambdaComplexDoubleVisitor
     : public BaseVisitor<LambdaComplexDoubleVisitor,
                          LambdaDoubleVisitor<std::complex<double>>>
@@ -29,18 +29,30 @@
 #include "llvm/Transforms/Vectorize.h"
 #include "llvm/ExecutionEngine/ObjectCache.h"
 #include "llvm/Support/FileSystem.h"
+#include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/Path.h"
+#include "llvm/Support/DynamicLibrary.h"
+#include "llvm/Support/Host.h"
+#include "llvm/ADT/StringMap.h"
 #include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <memory>
 #include <vector>
 #include <fstream>
+#include <sstream>
+#include <cstdio>
 
 #if (LLVM_VERSION_MAJOR == 3 && LLVM_VERSION_MINOR >= 9)                       \
     || (LLVM_VERSION_MAJOR > 3)
 #include <llvm/Transforms/Scalar/GVN.h>
 #endif
 
+#if (LLVM_VERSION_MAJOR >= 7)
+#include "llvm/Transforms/InstCombine/InstCombine.h"
+#include "llvm/Transforms/Utils.h"
+#endif
+
 #include <symengine/llvm_double.h>
 #include <symengine/eval_double.h>
 
@@ -51,6 +63,138 @@ class IRBuilder : public llvm::IRBuilder<>
 {
 };
 
+namespace
+{
+
+// Vector loads and stores only assume the alignment of a double
+// llvm::make_unique was removed in LLVM 10
+template <typename T, typename... Args>
+std::unique_ptr<T> make_unique_ptr(Args &&... args)
+{
+    return std::unique_ptr<T>(new T(std::forward<Args>(args)...));
+}
+
+llvm::Pass *create_inst_simplify_pass()
+{
+#if (LLVM_VERSION_MAJOR >= 7)
+    return llvm::createInstSimplifyLegacyPass();
+#else
+    return llvm::createInstructionSimplifierPass();
+#endif
+}
+
+template <typename Inst>
+void set_double_alignment(Inst *inst)
+{
+#if (LLVM_VERSION_MAJOR >= 11)
+    inst->setAlignment(llvm::Align(8));
+#elif (LLVM_VERSION_MAJOR == 10)
+    inst->setAlignment(llvm::MaybeAlign(8));
+#else
+    inst->setAlignment(8);
+#endif
+}
+
+// Widest vector of doubles of the host and the letter of the matching
+// libmvec variants (b: SSE, c: AVX, d: AVX2, e: AVX-512)
+unsigned host_vector_width(char &isa)
+{
+    llvm::StringMap<bool> features;
+    llvm::sys::getHostCPUFeatures(features);
+    if (features.lookup("avx512f")) {
+        isa = 'e';
+        return 8;
+    }
+    if (features.lookup("avx")) {
+        isa = features.lookup("avx2") ? 'd' : 'c';
+        return 4;
+    }
+    isa = features.lookup("sse2") ? 'b' : 0;
+    return 2;
+}
+
+std::string &cache_directory()
+{
+    static std::string dir;
+    return dir;
+}
+
+std::atomic<size_t> &cache_hits()
+{
+    static std::atomic<size_t> hits(0);
+    return hits;
+}
+
+// Everything the compiled object depends on
+std::string cache_key(const vec_basic &inputs, const vec_basic &outputs,
+                      bool symbolic_cse, int opt_level, unsigned vector_width)
+{
+    std::ostringstream key;
+    key << "SymEngine LLVM " << LLVM_VERSION_MAJOR << "." << LLVM_VERSION_MINOR
+        << "\n" << llvm::sys::getHostCPUName().str() << "\n";
+    llvm::StringMap<bool> features;
+    if (llvm::sys::getHostCPUFeatures(features)) {
+        // The order of a StringMap is unspecified
+        std::vector<std::string> enabled;
+        for (auto &f : features) {
+            if (f.second)
+                enabled.push_back(f.first().str());
+        }
+        std::sort(enabled.begin(), enabled.end());
+        for (auto &f : enabled) {
+            key << "+" << f;
+        }
+        key << "\n";
+    }
+    key << symbolic_cse << " " << opt_level << " " << vector_width << "\n";
+    for (auto &x : inputs) {
+        key << x->__str__() << "\n";
+    }
+    // The printer rounds the floating point numbers, their hashes do not
+    for (auto &e : outputs) {
+        key << e->__str__() << " " << e->hash() << "\n";
+    }
+    return key.str();
+}
+
+// Name of the cache file for `key`, the FNV-1a hash of the key
+std::string cache_file(const std::string &key)
+{
+    uint64_t h = 14695981039346656037ULL;
+    for (unsigned char c : key) {
+        h ^= c;
+        h *= 1099511628211ULL;
+    }
+    char name[24];
+    std::snprintf(name, sizeof(name), "%016llx.o", (unsigned long long)h);
+    llvm::SmallString<128> path(cache_directory());
+    llvm::sys::path::append(path, name);
+    return path.str().str();
+}
+
+// The cache files hold the key, a null character and the object
+void save_to_cache(const std::string &path, const std::string &key,
+                   const std::string &object)
+{
+    if (llvm::sys::fs::create_directories(cache_directory()))
+        return;
+    // Other processes only ever see complete files
+    llvm::SmallString<128> tmp;
+    if (llvm::sys::fs::createUniqueFile(path + ".%%%%%%%%.tmp", tmp))
+        return;
+    bool ok;
+    {
+        std::ofstream out(tmp.c_str(), std::ios::binary);
+        out << key << '\0' << object;
+        ok = out.good();
+    }
+    if (not ok or llvm::sys::fs::rename(tmp, path)) {
+        llvm::sys::fs::remove(tmp);
+    }
+}
+
+} // namespace
+
 llvm::Value *LLVMDoubleVisitor::apply(const Basic &b)
 {
     b.accept(*this);
@@ -60,8 +204,7 @@ llvm::Value *LLVMDoubleVisitor::apply(const Basic &b)
 void LLVMDoubleVisitor::init(const vec_basic &x, const Basic &b,
                              bool symbolic_cse, int opt_level)
 {
-    init(x, b, symbolic_cse,
-         LLVMDoubleVisitor::create_default_passes(opt_level));
+    init(x, {b.rcp_from_this()}, symbolic_cse, opt_level);
 }
 
 void LLVMDoubleVisitor::init(const vec_basic &x, const Basic &b,
@@ -129,12 +272,14 @@ std::vector<llvm::Pass *> LLVMDoubleVisitor::create_default_passes(int optlevel)
     if (optlevel == 0) {
         return passes;
     }
-#if (LLVM_VERSION_MAJOR < 4)
+#if (LLVM_VERSION_MAJOR < 4) || (LLVM_VERSION_MAJOR >= 10)
     passes.push_back(llvm::createInstructionCombiningPass());
 #else
     passes.push_back(llvm::createInstructionCombiningPass(optlevel > 1));
 #endif
+#if (LLVM_VERSION_MAJOR < 12)
     passes.push_back(llvm::createDeadInstEliminationPass());
+#endif
     passes.push_back(llvm::createPromoteMemoryToRegisterPass());
     passes.push_back(llvm::createReassociatePass());
     passes.push_back(llvm::createGVNPass());
@@ -143,7 +288,7 @@ std::vector<llvm::Pass *> LLVMDoubleVisitor::create_default_passes(int optlevel)
 #if (LLVM_VERSION_MAJOR < 5)
     passes.push_back(llvm::createLoadCombinePass());
 #endif
-    passes.push_back(llvm::createInstructionSimplifierPass());
+    passes.push_back(create_inst_simplify_pass());
     passes.push_back(llvm::createMemCpyOptPass());
     passes.push_back(llvm::createSROAPass());
     passes.push_back(llvm::createMergedLoadStoreMotionPass());
@@ -151,37 +296,118 @@ std::vector<llvm::Pass *> LLVMDoubleVisitor::create_default_passes(int optlevel)
     passes.push_back(llvm::createAggressiveDCEPass());
     if (optlevel > 2) {
         passes.push_back(llvm::createSLPVectorizerPass());
-        passes.push_back(llvm::createInstructionSimplifierPass());
+        passes.push_back(create_inst_simplify_pass());
     }
     return passes;
 }
 
 void LLVMDoubleVisitor::init(const vec_basic &inputs, const vec_basic &outputs,
-                             const bool symbolic_cse, int opt_level)
+                             const bool symbolic_cse, int opt_level,
+                             unsigned vector_width)
 {
+    if (cache_directory().empty()) {
+        init(inputs, outputs, symbolic_cse,
+             LLVMDoubleVisitor::create_default_passes(opt_level),
+             vector_width);
+        return;
+    }
+    for (auto &x : inputs) {
+        if (not is_a<Symbol>(*x)) {
+            throw SymEngineException("Input contains a non-symbol.");
+        }
+    }
+    std::string key
+        = cache_key(inputs, outputs, symbolic_cse, opt_level, vector_width);
+    std::string path = cache_file(key);
+    auto buffer = llvm::MemoryBuffer::getFile(path);
+    if (buffer) {
+        llvm::StringRef contents = (*buffer)->getBuffer();
+        if (contents.size() > key.size()
+            and contents.substr(0, key.size()) == key
+            and contents[key.size()] == '\0') {
+            symbols = inputs;
+            loads(contents.substr(key.size() + 1).str());
+            if (func != 0) {
+                cache_hits()++;
+                return;
+            }
+        }
+    }
     init(inputs, outputs, symbolic_cse,
-         LLVMDoubleVisitor::create_default_passes(opt_level));
+         LLVMDoubleVisitor::create_default_passes(opt_level), vector_width);
+    save_to_cache(path, key, membuffer);
+}
+
+void LLVMDoubleVisitor::set_cache_directory(const std::string &dir)
+{
+    cache_directory() = dir;
+}
+
+const std::string &LLVMDoubleVisitor::get_cache_directory()
+{
+    return cache_directory();
+}
+
+size_t LLVMDoubleVisitor::get_cache_hits()
+{
+    return cache_hits();
+}
+
+void LLVMDoubleVisitor::set_lanes(unsigned width)
+{
+    lanes = width;
+    llvm::Type *double_type = llvm::Type::getDoubleTy(mod->getContext());
+    if (width == 1) {
+        float_type = double_type;
+    } else {
+#if (LLVM_VERSION_MAJOR >= 11)
+        float_type = llvm::FixedVectorType::get(double_type, width);
+#else
+        float_type = llvm::VectorType::get(double_type, width);
+#endif
+    }
+}
+
+std::vector<llvm::Value *>
+LLVMDoubleVisitor::emit_outputs(const vec_pair &replacements,
+                                const vec_basic &exprs)
+{
+    std::vector<llvm::Value *> output_vals;
+    replacement_symbol_ptrs.clear();
+    for (auto &rep : replacements) {
+        // Store the replacement symbol values in a dictionary
+        replacement_symbol_ptrs[rep.first] = apply(*(rep.second));
+    }
+    // Generate IR for all the exprs and save references
+    for (auto &e : exprs) {
+        output_vals.push_back(apply(*e));
+    }
+    return output_vals;
 }
 
 void LLVMDoubleVisitor::init(const vec_basic &inputs, const vec_basic &outputs,
                              const bool symbolic_cse,
-                             const std::vector<llvm::Pass *> &passes)
+                             const std::vector<llvm::Pass *> &passes,
+                             unsigned vector_width)
 {
     llvm::InitializeNativeTarget();
     llvm::InitializeNativeTargetAsmPrinter();
     llvm::InitializeNativeTargetAsmParser();
     std::unique_ptr<llvm::LLVMContext> context
-        = llvm::make_unique<llvm::LLVMContext>();
+        = make_unique_ptr<llvm::LLVMContext>();
     symbols = inputs;
+    symbol_ptrs.clear();
+    batch_func = 0;
 
     // Create some module to put our function into it.
     std::unique_ptr<llvm::Module> module
-        = llvm::make_unique<llvm::Module>("SymEngine", *context);
+        = make_unique_ptr<llvm::Module>("SymEngine", *context);
     module->setDataLayout("");
     mod = module.get();
+    set_lanes(1);
 
     // Create a new pass manager attached to it.
-    auto fpm = llvm::make_unique<llvm::legacy::FunctionPassManager>(mod);
+    auto fpm = make_unique_ptr<llvm::legacy::FunctionPassManager>(mod);
     for (auto pass : passes) {
         fpm->add(pass);
     }
@@ -197,7 +423,7 @@ void LLVMDoubleVisitor::init(const vec_basic &inputs, const vec_basic &outputs,
     // Create a basic block builder with default parameters.  The builder
     // will
     // automatically append instructions to the basic block `BB'.
-    llvm::IRBuilder<> _builder = llvm::IRBuilder<>(BB);
+    llvm::IRBuilder<> _builder(BB);
     builder = reinterpret_cast<IRBuilder *>(&_builder);
     builder->SetInsertPoint(BB);
     auto fmf = llvm::FastMathFlags();
@@ -224,27 +450,17 @@ void LLVMDoubleVisitor::init(const vec_basic &inputs, const vec_basic &outputs,
 #else
     auto out = &(*(it + 1));
 #endif
-    std::vector<llvm::Value *> output_vals;
 
+    vec_basic reduced_exprs;
+    vec_pair replacements;
     if (symbolic_cse) {
-        vec_basic reduced_exprs;
-        vec_pair replacements;
         // cse the outputs
         SymEngine::cse(replacements, reduced_exprs, outputs);
-        for (auto &rep : replacements) {
-            // Store the replacement symbol values in a dictionary
-            replacement_symbol_ptrs[rep.first] = apply(*(rep.second));
-        }
-        // Generate IR for all the reduced exprs and save references
-        for (unsigned i = 0; i < outputs.size(); i++) {
-            output_vals.push_back(apply(*reduced_exprs[i]));
-        }
     } else {
-        // Generate IR for all the output exprs and save references
-        for (unsigned i = 0; i < outputs.size(); i++) {
-            output_vals.push_back(apply(*outputs[i]));
-        }
+        reduced_exprs = outputs;
     }
+    std::vector<llvm::Value *> output_vals
+        = emit_outputs(replacements, reduced_exprs);
 
     // Store all the output exprs at the end
     for (unsigned i = 0; i < outputs.size(); i++) {
@@ -261,6 +477,21 @@ void LLVMDoubleVisitor::init(const vec_basic &inputs, const vec_basic &outputs,
     // Validate the generated code, checking for consistency.
     llvm::verifyFunction(*F);
 
+    llvm::Function *batch = nullptr;
+    if (vector_width != 1) {
+        // The libmvec routines are looked up in the process
+        llvm::sys::DynamicLibrary::LoadLibraryPermanently("libmvec.so.1");
+        unsigned width = host_vector_width(vector_isa);
+        if (vector_width != 0 and vector_width != width) {
+            width = vector_width;
+            // The libmvec variants only exist for the native widths
+            vector_isa = 0;
+        }
+        batch = get_batch_function_type(context.get());
+        emit_batch_loop(batch, replacements, reduced_exprs, width);
+        llvm::verifyFunction(*batch);
+    }
+
     //     std::cout << "LLVM IR" << std::endl;
     // #if (LLVM_VERSION_MAJOR < 5)
     //     module->dump();
@@ -270,17 +501,31 @@ void LLVMDoubleVisitor::init(const vec_basic &inputs, const vec_basic &outputs,
 
     // Optimize the function.
     fpm->run(*F);
+    if (batch != nullptr) {
+        fpm->run(*batch);
+    }
 
     // std::cout << "Optimized LLVM IR" << std::endl;
     // module->dump();
 
     // Now we create the JIT.
     std::string error;
-    auto executionengine = llvm::EngineBuilder(std::move(module))
-                               .setEngineKind(llvm::EngineKind::Kind::JIT)
-                               .setOptLevel(llvm::CodeGenOpt::Level::Aggressive)
-                               .setErrorStr(&error)
-                               .create();
+    llvm::EngineBuilder engine_builder(std::move(module));
+    engine_builder.setEngineKind(llvm::EngineKind::Kind::JIT)
+        .setOptLevel(llvm::CodeGenOpt::Level::Aggressive)
+        .setErrorStr(&error);
+    if (batch != nullptr) {
+        // The vector code needs the vector extensions of the host
+        llvm::StringMap<bool> features;
+        std::vector<std::string> attrs;
+        if (llvm::sys::getHostCPUFeatures(features)) {
+            for (auto &f : features) {
+                attrs.push_back((f.second ? "+" : "-") + f.first().str());
+            }
+        }
+        engine_builder.setMCPU(llvm::sys::getHostCPUName()).setMAttrs(attrs);
+    }
+    auto executionengine = engine_builder.create();
 
     // This is a hack to get the MemoryBuffer of a compiled object.
     class MemoryBufferRefCallback : public llvm::ObjectCache
@@ -313,6 +558,121 @@ void LLVMDoubleVisitor::init(const vec_basic &inputs, const vec_basic &outputs,
 
     // Get the symbol's address
     func = (intptr_t)executionengine->getPointerToFunction(F);
+    if (batch != nullptr) {
+        batch_func = (intptr_t)executionengine->getPointerToFunction(batch);
+    }
+    set_lanes(1);
+}
+
+llvm::Function *
+LLVMDoubleVisitor::get_batch_function_type(llvm::LLVMContext *context)
+{
+    llvm::Type *double_ptr
+        = llvm::PointerType::get(llvm::Type::getDoubleTy(*context), 0);
+    llvm::Type *int64 = llvm::Type::getInt64Ty(*context);
+    std::vector<llvm::Type *> inp = {double_ptr, double_ptr, int64, int64,
+                                     int64};
+    llvm::FunctionType *function_type = llvm::FunctionType::get(
+        llvm::Type::getVoidTy(*context), inp, /*isVarArgs=*/false);
+    // A named external function, so that `loads` can find it
+    auto F = llvm::Function::Create(function_type,
+                                    llvm::Function::ExternalLinkage,
+                                    "symengine_batch", mod);
+    F->setCallingConv(llvm::CallingConv::C);
+#if (LLVM_VERSION_MAJOR >= 5)
+    F->addParamAttr(0, llvm::Attribute::ReadOnly);
+    F->addParamAttr(0, llvm::Attribute::NoCapture);
+    F->addParamAttr(1, llvm::Attribute::NoCapture);
+    F->addFnAttr(llvm::Attribute::NoUnwind);
+#endif
+    return F;
+}
+
+/*
+   Emits
+
+       for (i = 0; i + width <= n; i += width)
+           outs[k * os + i : width] = f_k(inps[j * is + i : width])
+       for (; i < n; i++)
+           outs[k * os + i] = f_k(inps[j * is + i])
+
+   into `F`, where the first loop works on vectors of `width` doubles and the
+   second one evaluates the remaining points one by one (`is` and `os` are
+   the input and output strides).
+*/
+void LLVMDoubleVisitor::emit_batch_loop(llvm::Function *F,
+                                        const vec_pair &replacements,
+                                        const vec_basic &exprs,
+                                        unsigned width)
+{
+    llvm::LLVMContext &context = mod->getContext();
+    llvm::Type *double_type = llvm::Type::getDoubleTy(context);
+    llvm::Type *int64 = llvm::Type::getInt64Ty(context);
+    auto arg = F->args().begin();
+    llvm::Value *inps = &(*arg++);
+    llvm::Value *outs = &(*arg++);
+    llvm::Value *n = &(*arg++);
+    llvm::Value *inp_stride = &(*arg++);
+    llvm::Value *out_stride = &(*arg);
+
+    auto entry = llvm::BasicBlock::Create(context, "entry", F);
+    auto exit = llvm::BasicBlock::Create(context, "exit", F);
+    builder->SetInsertPoint(entry);
+    llvm::Value *start = llvm::ConstantInt::get(int64, 0);
+    llvm::BasicBlock *from = entry;
+
+    for (unsigned w : {width, 1u}) {
+        if (w == 1 and width == 1)
+            break;
+        set_lanes(w);
+        auto check = llvm::BasicBlock::Create(context, "check", F);
+        auto body = llvm::BasicBlock::Create(context, "body", F);
+        auto next = w == 1 ? exit : llvm::BasicBlock::Create(context, "", F);
+        builder->CreateBr(check);
+
+        builder->SetInsertPoint(check);
+        llvm::PHINode *i = builder->CreatePHI(int64, 2);
+        i->addIncoming(start, from);
+        llvm::Value *end = builder->CreateAdd(
+            i, llvm::ConstantInt::get(int64, w), "", true, true);
+        builder->CreateCondBr(builder->CreateICmpULE(end, n), body, next);
+
+        builder->SetInsertPoint(body);
+        symbol_ptrs.clear();
+        for (unsigned j = 0; j < symbols.size(); j++) {
+            llvm::Value *index = builder->CreateAdd(
+                builder->CreateMul(llvm::ConstantInt::get(int64, j),
+                                   inp_stride),
+                i);
+            llvm::Value *ptr = builder->CreateGEP(double_type, inps, index);
+            ptr = builder->CreateBitCast(ptr,
+                                         llvm::PointerType::get(float_type, 0));
+            llvm::LoadInst *v = builder->CreateLoad(float_type, ptr);
+            set_double_alignment(v);
+            symbol_ptrs.push_back(v);
+        }
+        std::vector<llvm::Value *> output_vals
+            = emit_outputs(replacements, exprs);
+        for (unsigned k = 0; k < output_vals.size(); k++) {
+            llvm::Value *index = builder->CreateAdd(
+                builder->CreateMul(llvm::ConstantInt::get(int64, k),
+                                   out_stride),
+                i);
+            llvm::Value *ptr = builder->CreateGEP(double_type, outs, index);
+            ptr = builder->CreateBitCast(ptr,
+                                         llvm::PointerType::get(float_type, 0));
+            llvm::StoreInst *st = builder->CreateStore(output_vals[k], ptr);
+            set_double_alignment(st);
+        }
+        i->addIncoming(end, builder->GetInsertBlock());
+        builder->CreateBr(check);
+
+        // The scalar loop is entered from `next`, after the vector loop
+        builder->SetInsertPoint(next);
+        start = i;
+        from = next;
+    }
+    builder->CreateRetVoid();
 }
 
 double LLVMDoubleVisitor::call(const std::vector<double> &vec)
@@ -327,10 +687,21 @@ void LLVMDoubleVisitor::call(double *outs, const double *inps)
     ((double (*)(const double *, double *))func)(inps, outs);
 }
 
+void LLVMDoubleVisitor::call(double *outs, const double *inps, size_t n,
+                             size_t inp_stride, size_t out_stride)
+{
+    if (batch_func == 0) {
+        throw SymEngineException("LLVMDoubleVisitor: evaluating at many "
+                                 "points needs a vector_width other than 1");
+    }
+    ((void (*)(const double *, double *, int64_t, int64_t, int64_t))batch_func)(
+        inps, outs, n, inp_stride == 0 ? n : inp_stride,
+        out_stride == 0 ? n : out_stride);
+}
+
 void LLVMDoubleVisitor::set_double(double d)
 {
-    result_
-        = llvm::ConstantFP::get(llvm::Type::getDoubleTy(mod->getContext()), d);
+    result_ = llvm::ConstantFP::get(float_type, d);
 }
 
 void LLVMDoubleVisitor::bvisit(const Integer &x, bool as_int32)
@@ -340,9 +711,7 @@ void LLVMDoubleVisitor::bvisit(const Integer &x, bool as_int32)
         result_ = llvm::ConstantInt::get(
             llvm::Type::getInt32Ty(mod->getContext()), d, true);
     } else {
-        result_
-            = llvm::ConstantFP::get(llvm::Type::getDoubleTy(mod->getContext()),
-                                    mp_get_d(x.as_integer_class()));
+        set_double(mp_get_d(x.as_integer_class()));
     }
 }
 
@@ -417,31 +786,103 @@ void LLVMDoubleVisitor::bvisit(const Mul &x)
 llvm::Function *LLVMDoubleVisitor::get_powi()
 {
     std::vector<llvm::Type *> arg_type;
-    arg_type.push_back(llvm::Type::getDoubleTy(mod->getContext()));
+    arg_type.push_back(float_type);
     arg_type.push_back(llvm::Type::getInt32Ty(mod->getContext()));
     return llvm::Intrinsic::getDeclaration(mod, llvm::Intrinsic::powi,
                                            arg_type);
 }
 
 llvm::Function *get_double_intrinsic(llvm::Intrinsic::ID id, unsigned n,
-                                     llvm::Module *mod)
+                                     llvm::Module *mod, llvm::Type *type)
 {
-    std::vector<llvm::Type *> arg_type(
-        n, llvm::Type::getDoubleTy(mod->getContext()));
+    std::vector<llvm::Type *> arg_type(n, type);
     return llvm::Intrinsic::getDeclaration(mod, id, arg_type);
 }
 
+llvm::Function *LLVMDoubleVisitor::get_vector_function(const std::string &name,
+                                                       unsigned nargs)
+{
+    if (lanes == 1 or vector_isa == 0) {
+        return nullptr;
+    }
+    // Name of the variant in the vector function ABI, e.g. `_ZGVdN4v_sin`
+    std::string vname = "_ZGV" + std::string(1, vector_isa) + "N"
+                        + std::to_string(lanes) + std::string(nargs, 'v') + "_"
+                        + name;
+    if (llvm::sys::DynamicLibrary::SearchForAddressOfSymbol(vname) == nullptr) {
+        return nullptr;
+    }
+    llvm::Function *fun = mod->getFunction(vname);
+    if (!fun) {
+        std::vector<llvm::Type *> args(nargs, float_type);
+        llvm::FunctionType *type
+            = llvm::FunctionType::get(float_type, args, /*isVarArgs=*/false);
+        fun = llvm::Function::Create(type, llvm::GlobalValue::ExternalLinkage,
+                                     vname, mod);
+        fun->setCallingConv(llvm::CallingConv::C);
+#if (LLVM_VERSION_MAJOR >= 5)
+        fun->addFnAttr(llvm::Attribute::NoUnwind);
+#endif
+    }
+    return fun;
+}
+
+// Calls the intrinsic `id`, or the libmvec routine `name` for vectors
+llvm::Value *
+LLVMDoubleVisitor::call_math(unsigned id, const std::string &name,
+                             const std::vector<llvm::Value *> &args)
+{
+    llvm::Function *fun = get_vector_function(name, args.size());
+    if (fun == nullptr) {
+        // LLVM splits the intrinsics on vectors into calls for each lane
+        fun = get_double_intrinsic(id, args.size(), mod, float_type);
+    }
+    auto r = builder->CreateCall(fun, args);
+    r->setTailCall(true);
+    return r;
+}
+
+// Calls the external function `name`, lane by lane for vectors
+llvm::Value *LLVMDoubleVisitor::call_external(const std::string &name,
+                                              llvm::Value *arg)
+{
+    if (lanes > 1) {
+        llvm::Function *vfun = get_vector_function(name, 1);
+        if (vfun != nullptr) {
+            auto r = builder->CreateCall(vfun, {arg});
+            r->setTailCall(true);
+            return r;
+        }
+    }
+    llvm::Function *fun = get_external_function(name);
+    if (lanes == 1) {
+        auto r = builder->CreateCall(fun, {arg});
+        r->setTailCall(true);
+        return r;
+    }
+    llvm::Value *r = llvm::UndefValue::get(float_type);
+    for (unsigned i = 0; i < lanes; i++) {
+        llvm::Value *lane = builder->CreateExtractElement(
+            arg, builder->getInt32(i));
+        r = builder->CreateInsertElement(
+            r, builder->CreateCall(fun, {lane}), builder->getInt32(i));
+    }
+    return r;
+}
+
 void LLVMDoubleVisitor::bvisit(const Pow &x)
 {
     std::vector<llvm::Value *> args;
     llvm::Function *fun;
     if (eq(*(x.get_base()), *E)) {
         args.push_back(apply(*x.get_exp()));
-        fun = get_double_intrinsic(llvm::Intrinsic::exp, 1, mod);
+        result_ = call_math(llvm::Intrinsic::exp, "exp", args);
+        return;
 
     } else if (eq(*(x.get_base()), *integer(2))) {
         args.push_back(apply(*x.get_exp()));
-        fun = get_double_intrinsic(llvm::Intrinsic::exp2, 1, mod);
+        result_ = call_math(llvm::Intrinsic::exp2, "exp2", args);
+        return;
 
     } else {
         if (is_a<Integer>(*x.get_exp())) {
@@ -458,7 +899,8 @@ void LLVMDoubleVisitor::bvisit(const Pow &x)
         } else {
             args.push_back(apply(*x.get_base()));
             args.push_back(apply(*x.get_exp()));
-            fun = get_double_intrinsic(llvm::Intrinsic::pow, 2, mod);
+            result_ = call_math(llvm::Intrinsic::pow, "pow", args);
+            return;
         }
     }
     auto r = builder->CreateCall(fun, args);
@@ -468,44 +910,23 @@ void LLVMDoubleVisitor::bvisit(const Pow &x)
 
 void LLVMDoubleVisitor::bvisit(const Sin &x)
 {
-    std::vector<llvm::Value *> args;
-    llvm::Function *fun;
-    args.push_back(apply(*x.get_arg()));
-    fun = get_double_intrinsic(llvm::Intrinsic::sin, 1, mod);
-    auto r = builder->CreateCall(fun, args);
-    r->setTailCall(true);
-    result_ = r;
+    result_ = call_math(llvm::Intrinsic::sin, "sin", {apply(*x.get_arg())});
 }
 
 void LLVMDoubleVisitor::bvisit(const Cos &x)
 {
-    std::vector<llvm::Value *> args;
-    llvm::Function *fun;
-    args.push_back(apply(*x.get_arg()));
-    fun = get_double_intrinsic(llvm::Intrinsic::cos, 1, mod);
-    auto r = builder->CreateCall(fun, args);
-    r->setTailCall(true);
-    result_ = r;
+    result_ = call_math(llvm::Intrinsic::cos, "cos", {apply(*x.get_arg())});
 }
 
 void LLVMDoubleVisitor::bvisit(const Log &x)
 {
-    std::vector<llvm::Value *> args;
-    llvm::Function *fun;
-    args.push_back(apply(*x.get_arg()));
-    fun = get_double_intrinsic(llvm::Intrinsic::log, 1, mod);
-    auto r = builder->CreateCall(fun, args);
-    r->setTailCall(true);
-    result_ = r;
+    result_ = call_math(llvm::Intrinsic::log, "log", {apply(*x.get_arg())});
 }
 
 #define ONE_ARG_EXTERNAL_FUNCTION(Class, ext)                                  \
     void LLVMDoubleVisitor::bvisit(const Class &x)                             \
     {                                                                          \
-        llvm::Function *func = get_external_function(#ext);                    \
-        auto r = builder->CreateCall(func, {apply(*x.get_arg())});             \
-        r->setTailCall(true);                                                  \
-        result_ = r;                                                           \
+        result_ = call_external(#ext, apply(*x.get_arg()));                    \
     }
 
 ONE_ARG_EXTERNAL_FUNCTION(Abs, abs)
@@ -600,12 +1021,15 @@ void LLVMDoubleVisitor::loads(const std::string &s)
     llvm::InitializeNativeTarget();
     llvm::InitializeNativeTargetAsmPrinter();
     llvm::InitializeNativeTargetAsmParser();
+    // Needed by the objects with vector code
+    llvm::sys::DynamicLibrary::LoadLibraryPermanently("libmvec.so.1");
+    membuffer = s;
     std::unique_ptr<llvm::LLVMContext> context
-        = llvm::make_unique<llvm::LLVMContext>();
+        = make_unique_ptr<llvm::LLVMContext>();
 
     // Create some module to put our function into it.
     std::unique_ptr<llvm::Module> module
-        = llvm::make_unique<llvm::Module>("SymEngine", *context);
+        = make_unique_ptr<llvm::Module>("SymEngine", *context);
     module->setDataLayout("");
     mod = module.get();
 
@@ -649,6 +1073,9 @@ void LLVMDoubleVisitor::loads(const std::string &s)
     executionengine->finalizeObject();
     // Set func to compiled function pointer
     func = (intptr_t)executionengine->getPointerToFunction(F);
+    // The object has a batch function if it was compiled with a vector width
+    batch_func
+        = (intptr_t)executionengine->getFunctionAddress("symengine_batch");
 }
 
 } // namespace SymEngine
@@ -16,6 +16,7 @@ class ExecutionEngine;
 class MemoryBufferRef;
 class LLVMContext;
 class Pass;
+class Type;
 }
 
 namespace SymEngine
@@ -33,12 +34,25 @@ protected:
     llvm::Value *result_;
     llvm::ExecutionEngine *executionengine;
     intptr_t func;
+    // Function evaluating many points, see `call(outs, inps, n)`
+    intptr_t batch_func = 0;
 
     // Following are invalid after the init call.
     IRBuilder *builder;
     llvm::Module *mod;
     std::string membuffer;
+    // `double` or a vector of `lanes` doubles, the type of the values
+    llvm::Type *float_type;
+    unsigned lanes = 1;
+    // Vector ISA letter of the libmvec routines of the host, 0 if none
+    char vector_isa = 0;
     llvm::Function *get_function_type(llvm::LLVMContext *);
+    llvm::Function *get_batch_function_type(llvm::LLVMContext *);
+    std::vector<llvm::Value *> emit_outputs(const vec_pair &replacements,
+                                            const vec_basic &exprs);
+    void emit_batch_loop(llvm::Function *F, const vec_pair &replacements,
+                         const vec_basic &exprs, unsigned width);
+    void set_lanes(unsigned width);
 
 public:
     llvm::Value *apply(const Basic &b);
@@ -46,20 +60,55 @@ public:
               const bool symbolic_cse = false, int opt_level = 2);
     void init(const vec_basic &x, const Basic &b, const bool symbolic_cse,
               const std::vector<llvm::Pass *> &passes);
+    /*! When `vector_width` is not 1, a second function evaluating the
+        outputs at many points is compiled, see `call(outs, inps, n)`. It
+        evaluates `vector_width` points at a time with LLVM vector types,
+        and calls the vector variants of `sin`, `cos`, `exp`, `log` and
+        `pow` of libmvec when they are available. A `vector_width` of 0
+        picks the widest vector of doubles of the host (8 with AVX-512, 4
+        with AVX, 2 otherwise). The code is then compiled for the host CPU.
+    */
     void init(const vec_basic &inputs, const vec_basic &outputs,
-              const bool symbolic_cse = false, int opt_level = 2);
+              const bool symbolic_cse = false, int opt_level = 2,
+              unsigned vector_width = 1);
     void init(const vec_basic &inputs, const vec_basic &outputs,
-              const bool symbolic_cse, const std::vector<llvm::Pass *> &passes);
+              const bool symbolic_cse, const std::vector<llvm::Pass *> &passes,
+              unsigned vector_width = 1);
 
     static std::vector<llvm::Pass *> create_default_passes(int optlevel);
 
+    /*! Directory of the on-disk cache of compiled objects, empty (the
+        default) disables the cache. `init` with an `opt_level` then looks
+        for an object compiled from the same inputs, outputs, `symbolic_cse`,
+        `opt_level` and `vector_width` on the same CPU with the same LLVM
+        version, and loads it instead of compiling. Otherwise the new object
+        is saved to the directory, which is created if needed. Not thread
+        safe, set it before using the visitors.
+    */
+    static void set_cache_directory(const std::string &dir);
+    static const std::string &get_cache_directory();
+    //! Number of `init` calls that loaded their object from the cache
+    static size_t get_cache_hits();
+
     double call(const std::vector<double> &vec);
     void call(double *outs, const double *inps);
+    /*! Evaluates at `n` points. The input `j` of the point `i` is read from
+        `inps[j * inp_stride + i]` and the output `k` is stored in
+        `outs[k * out_stride + i]`, strides of 0 mean `n`. Needs an `init`
+        with a `vector_width` other than 1.
+    */
+    void call(double *outs, const double *inps, size_t n,
+              size_t inp_stride = 0, size_t out_stride = 0);
 
     // Helper functions
     void set_double(double d);
     llvm::Function *get_external_function(const std::string &name);
+    llvm::Function *get_vector_function(const std::string &name,
+                                        unsigned nargs);
     llvm::Function *get_powi();
+    llvm::Value *call_math(unsigned id, const std::string &name,
+                           const std::vector<llvm::Value *> &args);
+    llvm::Value *call_external(const std::string &name, llvm::Value *arg);
 
     void bvisit(const Integer &x, bool as_int32 = false);
     void bvisit(const Rational &x);
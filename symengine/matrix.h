@@ -149,7 +149,8 @@ public:
     // Fraction free LDU factorization
     virtual void FFLDU(MatrixBase &L, MatrixBase &D, MatrixBase &U) const;
 
-    // Return the Jacobian of the matrix
+    // Return the Jacobian of the matrix. The rows are computed by `gradient`,
+    // so the entries equal the ones of `diff` but may differ in form.
     friend void jacobian(const DenseMatrix &A, const DenseMatrix &x,
                          DenseMatrix &result);
     // Return the Jacobian of the matrix using sdiff
@@ -162,6 +163,9 @@ public:
     // Differentiate the matrix element-wise using SymPy compatible diff
     friend void sdiff(const DenseMatrix &A, const RCP<const Basic> &x,
                       DenseMatrix &result);
+    // Substitute in the matrix element-wise
+    friend void subs(const DenseMatrix &A, const map_basic_basic &subs_dict,
+                     DenseMatrix &result);
 
     // Friend functions related to Matrix Operations
     friend void add_dense_dense(const DenseMatrix &A, const DenseMatrix &B,
@@ -376,6 +380,8 @@ public:
                               const std::vector<unsigned> &i,
                               const std::vector<unsigned> &j,
                               const vec_basic &x);
+    // The rows are computed by `gradient`, so the entries equal the ones of
+    // `diff` but may differ in form.
     static CSRMatrix jacobian(const vec_basic &exprs, const vec_sym &x);
     static CSRMatrix jacobian(const DenseMatrix &A, const DenseMatrix &x);
 
@@ -401,7 +407,50 @@ private:
     unsigned col_;
 };
 
-// Return the Jacobian of the matrix
+// Sparsity pattern of the Jacobian of a system of expressions with respect
+// to some symbols: the entry (i, j) is structurally nonzero if the i-th
+// expression depends on the j-th symbol. The pattern can be reused to
+// evaluate the Jacobian of any system with the same dependencies.
+class JacobianPattern
+{
+public:
+    JacobianPattern(const vec_basic &exprs, const vec_sym &x);
+
+    unsigned nrows() const
+    {
+        return row_;
+    }
+    unsigned ncols() const
+    {
+        return static_cast<unsigned>(x_.size());
+    }
+    unsigned nnz() const
+    {
+        return static_cast<unsigned>(j_.size());
+    }
+    const std::vector<unsigned> &get_p() const
+    {
+        return p_;
+    }
+    const std::vector<unsigned> &get_j() const
+    {
+        return j_;
+    }
+
+    // Differentiates the structurally nonzero entries only, the result has
+    // exactly this pattern (derivatives which cancel out are stored as
+    // explicit zeros)
+    CSRMatrix evaluate(const vec_basic &exprs) const;
+
+private:
+    vec_sym x_;
+    std::vector<unsigned> p_;
+    std::vector<unsigned> j_;
+    unsigned row_;
+};
+
+// Return the Jacobian of the matrix. The rows are computed by `gradient`, so
+// the entries equal the ones of `diff` but may differ in form.
 void jacobian(const DenseMatrix &A, const DenseMatrix &x, DenseMatrix &result);
 // Return the Jacobian of the matrix using sdiff
 void sjacobian(const DenseMatrix &A, const DenseMatrix &x, DenseMatrix &result);
@@ -409,6 +458,9 @@ void sjacobian(const DenseMatrix &A, const DenseMatrix &x, DenseMatrix &result);
 // Differentiate all the elements
 void diff(const DenseMatrix &A, const RCP<const Symbol> &x,
           DenseMatrix &result);
+// Substitute `subs_dict` in all the elements, see `SubsPlan`
+void subs(const DenseMatrix &A, const map_basic_basic &subs_dict,
+          DenseMatrix &result);
 // Differentiate all the elements using SymPy compatible diff
 void sdiff(const DenseMatrix &A, const RCP<const Basic> &x,
            DenseMatrix &result);
@@ -454,8 +506,17 @@ void pivoted_LU_solve(const DenseMatrix &A, const DenseMatrix &b,
 
 void LDL_solve(const DenseMatrix &A, const DenseMatrix &b, DenseMatrix &x);
 
+// Solves Ax = b for matrices of Integers and Rationals modulo word sized
+// primes, recovering x by rational reconstruction. Returns false (leaving x
+// untouched) if A is singular.
+bool multimodular_solve(const DenseMatrix &A, const DenseMatrix &b,
+                        DenseMatrix &x);
+
 // Determinant
 RCP<const Basic> det_berkowitz(const DenseMatrix &A);
+// Determinant of a matrix of Integers and Rationals, computed modulo word
+// sized primes and combined by Chinese remaindering
+RCP<const Basic> det_multimodular(const DenseMatrix &A);
 
 // Characteristic polynomial: Only the coefficients of monomials in decreasing
 // order of monomial powers is returned, i.e. if `B = transpose([1, -2, 3])`
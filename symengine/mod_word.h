@@ -0,0 +1,249 @@
+/**
+ *  \file mod_word.h
+ *  Modular arithmetic on machine words
+ *
+ **/
+#ifndef SYMENGINE_MOD_WORD_H
+#define SYMENGINE_MOD_WORD_H
+
+#include <cstdint>
+#include <vector>
+
+#include <symengine/mp_class.h>
+
+namespace SymEngine
+{
+
+// The functions below work modulo n < 2**63, so that the sum of two residues
+// fits in a word. They are used in place of `integer_class` arithmetic when
+// the modulus is small enough.
+
+//! True if `m` > 1 can be passed to these functions, through mp_get_ui
+inline bool is_word_modulus(const integer_class &m)
+{
+    return m > 1 and mp_fits_ulong_p(m)
+           and mp_get_ui(m) < (1ul << (sizeof(unsigned long) * 8 - 1));
+}
+
+//! Sets `hi` * 2**64 + `lo` = `a` * `b`
+inline void mul_u64(uint64_t &hi, uint64_t &lo, uint64_t a, uint64_t b)
+{
+#ifdef __SIZEOF_INT128__
+    const unsigned __int128 t = static_cast<unsigned __int128>(a) * b;
+    hi = static_cast<uint64_t>(t >> 64);
+    lo = static_cast<uint64_t>(t);
+#else
+    const uint64_t mask = 0xffffffff;
+    const uint64_t a0 = a & mask, a1 = a >> 32, b0 = b & mask, b1 = b >> 32;
+    const uint64_t p00 = a0 * b0, p01 = a0 * b1, p10 = a1 * b0;
+    const uint64_t mid = (p00 >> 32) + (p01 & mask) + (p10 & mask);
+    lo = (mid << 32) | (p00 & mask);
+    hi = a1 * b1 + (p01 >> 32) + (p10 >> 32) + (mid >> 32);
+#endif
+}
+
+//! \return (`hi` * 2**64 + `lo`) mod `n`, with `hi` < `n`
+inline uint64_t rem_u128(uint64_t hi, uint64_t lo, uint64_t n)
+{
+#ifdef __SIZEOF_INT128__
+    return static_cast<uint64_t>(
+        ((static_cast<unsigned __int128>(hi) << 64) | lo) % n);
+#else
+    for (int i = 63; i >= 0; i--) {
+        hi = (hi << 1) | ((lo >> i) & 1);
+        if (hi >= n)
+            hi -= n;
+    }
+    return hi;
+#endif
+}
+
+//! \return `a` * `b` mod `n`, with `a`, `b` < `n`
+inline uint64_t mulmod_u64(uint64_t a, uint64_t b, uint64_t n)
+{
+    uint64_t hi, lo;
+    mul_u64(hi, lo, a, b);
+    return rem_u128(hi, lo, n);
+}
+
+// Montgomery arithmetic modulo an odd n > 1. The residue x is represented by
+// x * 2**64 mod n, and products of representations are reduced with one
+// multiplication by -1/n modulo 2**64 instead of a division by n.
+class MontgomeryWord
+{
+public:
+    explicit MontgomeryWord(uint64_t n) : n_(n)
+    {
+        // Newton's iteration, each step doubles the number of correct bits
+        // of 1/n starting from 3 (n * n = 1 modulo 8)
+        uint64_t inv = n;
+        for (int i = 0; i < 5; i++)
+            inv *= 2 - n * inv;
+        ninv_ = 0 - inv;
+        one_ = rem_u128(1, 0, n);
+        r2_ = mulmod_u64(one_, one_, n);
+    }
+
+    uint64_t modulus() const
+    {
+        return n_;
+    }
+    //! Representation of 1
+    uint64_t one() const
+    {
+        return one_;
+    }
+    uint64_t to_mont(uint64_t a) const
+    {
+        return mul(a % n_, r2_);
+    }
+    uint64_t from_mont(uint64_t a) const
+    {
+        return reduce(0, a);
+    }
+
+    uint64_t mul(uint64_t a, uint64_t b) const
+    {
+        uint64_t hi, lo;
+        mul_u64(hi, lo, a, b);
+        return reduce(hi, lo);
+    }
+    uint64_t add(uint64_t a, uint64_t b) const
+    {
+        const uint64_t s = a + b;
+        return s >= n_ ? s - n_ : s;
+    }
+    uint64_t sub(uint64_t a, uint64_t b) const
+    {
+        return a >= b ? a - b : a + (n_ - b);
+    }
+    //! `a`**`e`, both `a` and the result being representations
+    uint64_t pow(uint64_t a, uint64_t e) const
+    {
+        uint64_t r = one_;
+        while (e > 0) {
+            if (e & 1)
+                r = mul(r, a);
+            a = mul(a, a);
+            e >>= 1;
+        }
+        return r;
+    }
+
+private:
+    uint64_t n_;
+    uint64_t ninv_;
+    uint64_t one_;
+    uint64_t r2_;
+
+    // (hi * 2**64 + lo) / 2**64 mod n, for hi < n
+    uint64_t reduce(uint64_t hi, uint64_t lo) const
+    {
+        const uint64_t m = lo * ninv_;
+        uint64_t mh, ml;
+        mul_u64(mh, ml, m, n_);
+        // lo + ml is 0 modulo 2**64, with a carry unless lo is 0
+        const uint64_t r = hi + mh + (lo != 0);
+        return r >= n_ ? r - n_ : r;
+    }
+};
+
+//! \return `b`**`e` mod `n`, for 0 < `n`
+inline uint64_t powmod_u64(uint64_t b, uint64_t e, uint64_t n)
+{
+    if (n == 1)
+        return 0;
+    b %= n;
+    if (n < (uint64_t(1) << 32)) {
+        uint64_t r = 1;
+        while (e > 0) {
+            if (e & 1)
+                r = r * b % n;
+            b = b * b % n;
+            e >>= 1;
+        }
+        return r;
+    }
+    if (n & 1) {
+        const MontgomeryWord M(n);
+        return M.from_mont(M.pow(M.to_mont(b), e));
+    }
+    uint64_t r = 1;
+    while (e > 0) {
+        if (e & 1)
+            r = mulmod_u64(r, b, n);
+        b = mulmod_u64(b, b, n);
+        e >>= 1;
+    }
+    return r;
+}
+
+//! Sets `r` to the inverse of `a` modulo `n`, for 0 < `n`
+//! \return false if `a` is not invertible
+inline bool invmod_u64(uint64_t &r, uint64_t a, uint64_t n)
+{
+    int64_t t = 0, newt = 1;
+    int64_t g = static_cast<int64_t>(n), newg = static_cast<int64_t>(a % n);
+    while (newg != 0) {
+        const int64_t q = g / newg;
+        int64_t tmp = t - q * newt;
+        t = newt;
+        newt = tmp;
+        tmp = g - q * newg;
+        g = newg;
+        newg = tmp;
+    }
+    if (g != 1)
+        return false;
+    r = static_cast<uint64_t>(t < 0 ? t + static_cast<int64_t>(n) : t);
+    return true;
+}
+
+//! Sets `r`[i] = `bases`[i]**`e` mod `n` for all i, for 0 < `n`. For odd
+//! moduli four exponentiations are interleaved, which hides the latency of
+//! the multiplications.
+inline void powmod_u64_list(std::vector<uint64_t> &r,
+                            const std::vector<uint64_t> &bases, uint64_t e,
+                            uint64_t n)
+{
+    const size_t k = bases.size();
+    r.resize(k);
+    if (n == 1 or not(n & 1)) {
+        for (size_t i = 0; i < k; i++)
+            r[i] = powmod_u64(bases[i], e, n);
+        return;
+    }
+    const MontgomeryWord M(n);
+    int top = 63;
+    while (top >= 0 and not((e >> top) & 1))
+        top--;
+    size_t i = 0;
+    for (; i + 4 <= k; i += 4) {
+        const uint64_t b0 = M.to_mont(bases[i]), b1 = M.to_mont(bases[i + 1]),
+                       b2 = M.to_mont(bases[i + 2]),
+                       b3 = M.to_mont(bases[i + 3]);
+        uint64_t x0 = M.one(), x1 = x0, x2 = x0, x3 = x0;
+        for (int bit = top; bit >= 0; bit--) {
+            x0 = M.mul(x0, x0);
+            x1 = M.mul(x1, x1);
+            x2 = M.mul(x2, x2);
+            x3 = M.mul(x3, x3);
+            if ((e >> bit) & 1) {
+                x0 = M.mul(x0, b0);
+                x1 = M.mul(x1, b1);
+                x2 = M.mul(x2, b2);
+                x3 = M.mul(x3, b3);
+            }
+        }
+        r[i] = M.from_mont(x0);
+        r[i + 1] = M.from_mont(x1);
+        r[i + 2] = M.from_mont(x2);
+        r[i + 3] = M.from_mont(x3);
+    }
+    for (; i < k; i++)
+        r[i] = M.from_mont(M.pow(M.to_mont(bases[i]), e));
+}
+
+} // namespace SymEngine
+
+#endif
@@ -12,6 +12,35 @@ void monomial_mul(const vec_int &A, const vec_int &B, vec_int &C)
     }
 }
 
+bool MonomialPacking::init(const std::vector<std::int64_t> &lo,
+                           const std::vector<std::int64_t> &hi)
+{
+    size_t n = lo.size();
+    word_.assign(n, 0);
+    shift_.assign(n, 0);
+    mask_.assign(n, 0);
+    offset_ = lo;
+    unsigned word = 0, used = 0;
+    for (size_t i = 0; i < n; i++) {
+        std::uint64_t range = static_cast<std::uint64_t>(hi[i] - lo[i]);
+        unsigned bits = 0;
+        while (bits < 64 and (range >> bits) != 0)
+            bits++;
+        if (bits == 0)
+            continue; // constant exponent, nothing to store
+        if (used + bits > 64) {
+            if (++word == 2)
+                return false;
+            used = 0;
+        }
+        word_[i] = word;
+        shift_[i] = used;
+        mask_[i] = ~std::uint64_t(0) >> (64 - bits);
+        used += bits;
+    }
+    return true;
+}
+
 /*
 // Other implementation of monomial_mul() are below. Those are slightly slower,
 // so they are commented out.
@@ -7,6 +7,8 @@
 #ifndef SYMENGINE_MONOMIALS_H
 #define SYMENGINE_MONOMIALS_H
 
+#include <cstdint>
+
 #include <symengine/basic.h>
 
 namespace SymEngine
@@ -14,6 +16,198 @@ namespace SymEngine
 //! Monomial multiplication
 void monomial_mul(const vec_int &A, const vec_int &B, vec_int &C);
 
+//! Exponent vector bit-packed into two 64-bit words, see `MonomialPacking`
+struct PackedMonomial {
+    std::uint64_t w[2];
+
+    bool operator==(const PackedMonomial &o) const
+    {
+        return w[0] == o.w[0] and w[1] == o.w[1];
+    }
+    bool operator!=(const PackedMonomial &o) const
+    {
+        return not(*this == o);
+    }
+};
+
+struct PackedMonomialHash {
+    std::size_t operator()(const PackedMonomial &m) const
+    {
+        std::uint64_t h = m.w[0] * 0x9E3779B97F4A7C15ULL + m.w[1];
+        h ^= h >> 29;
+        h *= 0xBF58476D1CE4E5B9ULL;
+        h ^= h >> 32;
+        return static_cast<std::size_t>(h);
+    }
+};
+
+//! Monomial multiplication of packed monomials is a word addition
+inline PackedMonomial monomial_mul(const PackedMonomial &A,
+                                   const PackedMonomial &B)
+{
+    return {{A.w[0] + B.w[0], A.w[1] + B.w[1]}};
+}
+
+/*! Layout of exponent vectors in a `PackedMonomial`. The exponent `i`,
+    which must lie in `[lo[i], hi[i]]`, is stored as `e - lo[i]` in a field
+    just wide enough for `hi[i] - lo[i]`. Fields do not straddle words, so
+    adding two packed monomials adds their exponents as long as the sums fit
+    in the fields.
+*/
+class MonomialPacking
+{
+private:
+    std::vector<unsigned> word_, shift_;
+    std::vector<std::int64_t> offset_;
+    std::vector<std::uint64_t> mask_;
+
+public:
+    //! Returns false if the fields for `[lo, hi]` do not fit in two words
+    bool init(const std::vector<std::int64_t> &lo,
+              const std::vector<std::int64_t> &hi);
+
+    //! Same fields with the exponents stored relative to `lo`
+    MonomialPacking with_offsets(const std::vector<std::int64_t> &lo) const
+    {
+        MonomialPacking p = *this;
+        p.offset_ = lo;
+        return p;
+    }
+
+    template <typename Vec>
+    PackedMonomial pack(const Vec &v) const
+    {
+        PackedMonomial m = {{0, 0}};
+        for (size_t i = 0; i < offset_.size(); i++)
+            m.w[word_[i]] |= static_cast<std::uint64_t>(
+                                 static_cast<std::int64_t>(v[i]) - offset_[i])
+                             << shift_[i];
+        return m;
+    }
+
+    template <typename Vec>
+    void unpack(const PackedMonomial &m, Vec &v) const
+    {
+        for (size_t i = 0; i < offset_.size(); i++)
+            v[i] = static_cast<typename Vec::value_type>(
+                offset_[i] + static_cast<std::int64_t>(
+                                 (m.w[word_[i]] >> shift_[i]) & mask_[i]));
+    }
+};
+
+inline void coef_addmul(integer_class &r, const integer_class &a,
+                        const integer_class &b)
+{
+    mp_addmul(r, a, b);
+}
+
+template <typename T>
+inline void coef_addmul(T &r, const T &a, const T &b)
+{
+    r += a * b;
+}
+
+/*! The two factors of a product of sparse polynomials with their monomials
+    packed, so that multiplying two terms needs a word addition and no
+    allocation. `Dict` maps exponent vectors of `n` entries to coefficients,
+    like `umap_vec_mpz` or the dictionaries of `MIntPoly` and `MExprPoly`.
+
+        PackedProduct<umap_vec_mpz> pp;
+        if (pp.init(A, B, n)) {
+            PackedProduct<umap_vec_mpz>::packed_dict P;
+            pp.mul(0, pp.a.size(), P);
+            pp.unpack(P, C);    // C += A*B
+        }
+*/
+template <typename Dict>
+class PackedProduct
+{
+public:
+    typedef typename Dict::key_type vec_type;
+    typedef typename Dict::mapped_type coef_type;
+    typedef std::unordered_map<PackedMonomial, coef_type, PackedMonomialHash>
+        packed_dict;
+
+    std::vector<std::pair<PackedMonomial, const coef_type *>> a, b;
+    //! Layout of the monomials of the product
+    MonomialPacking packing;
+    unsigned n;
+
+    //! Returns false if the exponents of the product do not fit in two words
+    bool init(const Dict &A, const Dict &B, unsigned n_)
+    {
+        n = n_;
+        std::vector<std::int64_t> lo_a, hi_a, lo_b, hi_b;
+        bounds(A, lo_a, hi_a);
+        bounds(B, lo_b, hi_b);
+        std::vector<std::int64_t> lo(n), hi(n);
+        for (unsigned i = 0; i < n; i++) {
+            lo[i] = lo_a[i] + lo_b[i];
+            hi[i] = hi_a[i] + hi_b[i];
+        }
+        if (not packing.init(lo, hi))
+            return false;
+        pack_terms(A, packing.with_offsets(lo_a), a);
+        pack_terms(B, packing.with_offsets(lo_b), b);
+        return true;
+    }
+
+    //! Adds the products of the terms `a[begin:end]` with `b` to `P`
+    void mul(size_t begin, size_t end, packed_dict &P) const
+    {
+        for (size_t i = begin; i < end; i++) {
+            for (const auto &t : b) {
+                coef_addmul(P[monomial_mul(a[i].first, t.first)],
+                            *a[i].second, *t.second);
+            }
+        }
+    }
+
+    //! Adds the nonzero terms of `P` to `C`
+    void unpack(const packed_dict &P, Dict &C) const
+    {
+        vec_type v(n);
+        for (const auto &t : P) {
+            if (t.second == 0)
+                continue;
+            packing.unpack(t.first, v);
+            auto it = C.find(v);
+            if (it == C.end())
+                C.insert({v, t.second});
+            else
+                it->second += t.second;
+        }
+    }
+
+private:
+    void bounds(const Dict &A, std::vector<std::int64_t> &lo,
+                std::vector<std::int64_t> &hi) const
+    {
+        lo.assign(n, 0);
+        hi.assign(n, 0);
+        bool first = true;
+        for (const auto &t : A) {
+            for (unsigned i = 0; i < n; i++) {
+                std::int64_t e = t.first[i];
+                if (first or e < lo[i])
+                    lo[i] = e;
+                if (first or e > hi[i])
+                    hi[i] = e;
+            }
+            first = false;
+        }
+    }
+
+    static void
+    pack_terms(const Dict &A, const MonomialPacking &p,
+               std::vector<std::pair<PackedMonomial, const coef_type *>> &v)
+    {
+        v.reserve(A.size());
+        for (const auto &t : A)
+            v.push_back({p.pack(t.first), &t.second});
+    }
+};
+
 } // SymEngine
 
 #endif
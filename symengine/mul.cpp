@@ -14,7 +14,7 @@ Mul::Mul(const RCP<const Number> &coef, map_basic_basic &&dict)
 }
 
 bool Mul::is_canonical(const RCP<const Number> &coef,
-                       const map_basic_basic &dict) const
+                       const map_basic_basic &dict)
 {
     if (coef == null)
         return false;
@@ -117,8 +117,8 @@ public:
                    const RCP<const Number> &exp) const;
 
     //! \return true if both `coef` and `dict` are in canonical form
-    bool is_canonical(const RCP<const Number> &coef,
-                      const map_basic_basic &dict) const;
+    static bool is_canonical(const RCP<const Number> &coef,
+                             const map_basic_basic &dict);
 
     virtual vec_basic get_args() const;
 
@@ -1,7 +1,10 @@
-#include <valarray>
+#include <algorithm>
+#include <climits>
 #include <iterator>
+#include <mutex>
 
 #include <symengine/ntheory.h>
+#include <symengine/mod_word.h>
 #include <symengine/rational.h>
 #include <symengine/mul.h>
 #ifdef HAVE_SYMENGINE_ECM
@@ -175,6 +178,20 @@ RCP<const Integer> nextprime(const Integer &a)
 
 namespace
 {
+// rop = b**e mod m like mp_powm, on words when `m` and `e` are small enough
+void _powm(integer_class &rop, const integer_class &b, const integer_class &e,
+           const integer_class &m)
+{
+    if (e < 0 or not mp_fits_ulong_p(e) or not is_word_modulus(m)) {
+        mp_powm(rop, b, e, m);
+        return;
+    }
+    // `rop` may alias the other arguments
+    const unsigned long n = mp_get_ui(m), k = mp_get_ui(e);
+    mp_fdiv_r(rop, b, m);
+    rop = static_cast<unsigned long>(powmod_u64(mp_get_ui(rop), k, n));
+}
+
 // Factoring by Trial division using primes only
 int _factor_trial_division_sieve(integer_class &factor, const integer_class &N)
 {
@@ -278,7 +295,7 @@ int _factor_pollard_pm1_method(integer_class &rop, const integer_class &n,
         while (m <= B / p) {
             m = m * p;
         }
-        mp_powm(_c, _c, m, n);
+        _powm(_c, _c, m, n);
     }
     _c = _c - 1;
     mp_gcd(rop, _c, n);
@@ -363,6 +380,61 @@ int factor_pollard_rho_method(const Ptr<RCP<const Integer>> &f,
     return ret_val;
 }
 
+namespace
+{
+// Finds a factor of `n` without gmp-ecm: trial division by the primes below
+// 2**16, then Pollard's rho method while `n` fits in a word, the quadratic
+// sieve up to 100 digits and the elliptic curve method above. Numbers of
+// more than 45 digits first get a few curves of ECM, which find the factors
+// of up to about 20 digits faster than the sieve.
+int _factor(integer_class &f, const integer_class &n)
+{
+    if (n < 4 or mp_probab_prime_p(n, 25) > 0)
+        return 0;
+    const unsigned limit = 65536;
+    Sieve::iterator pi(limit);
+    unsigned p;
+    while ((p = pi.next_prime()) <= limit) {
+        if (n < integer_class(p) * p)
+            break;
+        if (n % p == 0) {
+            f = p;
+            return 1;
+        }
+    }
+    integer_class rem;
+    for (unsigned long i = 2;; i++) {
+        mp_rootrem(f, rem, n, i);
+        if (f < 2)
+            break;
+        if (rem == 0)
+            return 1;
+    }
+
+    if (mp_fits_ulong_p(n)) {
+        const integer_class s(2);
+        for (unsigned a = 1; a < 20; a++) {
+            if (_factor_pollard_rho_method(f, n, integer_class(a), s, 1000000))
+                return 1;
+        }
+    }
+    const RCP<const Integer> N = integer(n);
+    RCP<const Integer> g;
+    const double d = mp_get_d(n);
+    int ret_val = 0;
+    if (d > 1e45)
+        ret_val = factor_ecm(outArg(g), *N, 2000, 10);
+    if (not ret_val and d < 1e100)
+        ret_val = factor_siqs(outArg(g), *N);
+    for (unsigned B1 = 10000; not ret_val and B1 < 1000000; B1 *= 4)
+        ret_val = factor_ecm(outArg(g), *N, B1, 100);
+    if (not ret_val)
+        throw SymEngineException("Failed to factor the given number");
+    f = g->as_integer_class();
+    return 1;
+}
+} // namespace
+
 // Factorization
 int factor(const Ptr<RCP<const Integer>> &f, const Integer &n, double B1)
 {
@@ -408,7 +480,7 @@ int factor(const Ptr<RCP<const Integer>> &f, const Integer &n, double B1)
     }
 #else
     // B1 is discarded if gmp-ecm is not installed
-    ret_val = _factor_trial_division_sieve(_f, _n);
+    ret_val = _factor(_f, _n);
 #endif // HAVE_SYMENGINE_ECM
     *f = integer(std::move(_f));
 
@@ -425,81 +497,224 @@ int factor_trial_division(const Ptr<RCP<const Integer>> &f, const Integer &n)
     return ret_val;
 }
 
+namespace
+{
+// Appends the prime factors of `n` > 0 to `primes` in increasing order, each
+// repeated by its multiplicity. The primes below 2**16 are found by trial
+// division and the cofactor is split with factor(), or with the methods of
+// _factor() when the former does not return a proper factor.
+void _prime_factors(std::vector<integer_class> &primes, integer_class n)
+{
+    const unsigned limit = 65536;
+    Sieve::iterator pi(limit);
+    unsigned p;
+    while ((p = pi.next_prime()) <= limit) {
+        if (n < integer_class(p) * p)
+            break;
+        while (n % p == 0) {
+            primes.push_back(integer_class(p));
+            n = n / p;
+        }
+    }
+    if (n == 1)
+        return;
+    const size_t first_large = primes.size();
+    std::vector<integer_class> composites = {std::move(n)};
+    RCP<const Integer> f;
+    integer_class g;
+    while (not composites.empty()) {
+        integer_class m = std::move(composites.back());
+        composites.pop_back();
+        if (mp_probab_prime_p(m, 25) > 0) {
+            primes.push_back(std::move(m));
+            continue;
+        }
+        // ecm_factor() may return `m` itself
+        g = 0;
+        if (factor(outArg(f), *integer(m)))
+            g = f->as_integer_class();
+        if (g <= 1 or g >= m) {
+            if (not _factor(g, m) or g <= 1 or g >= m)
+                throw SymEngineException("Failed to factor the given number");
+        }
+        mp_divexact(m, m, g);
+        composites.push_back(g);
+        composites.push_back(std::move(m));
+    }
+    std::sort(primes.begin() + first_large, primes.end());
+}
+} // namespace
+
 void prime_factors(std::vector<RCP<const Integer>> &prime_list,
                    const Integer &n)
 {
-    integer_class sqrtN;
     integer_class _n = n.as_integer_class();
     if (_n == 0)
         return;
     if (_n < 0)
         _n *= -1;
 
-    sqrtN = mp_sqrt(_n);
-    auto limit = mp_get_ui(sqrtN);
-    if (not mp_fits_ulong_p(sqrtN)
-        or limit > std::numeric_limits<unsigned>::max())
-        throw SymEngineException("N too large to factor");
-    Sieve::iterator pi(numeric_cast<unsigned>(limit));
-    unsigned p;
-
-    while ((p = pi.next_prime()) <= limit) {
-        while (_n % p == 0) {
-            prime_list.push_back(integer(p));
-            _n = _n / p;
-        }
-        if (_n == 1)
-            break;
-    }
-    if (not(_n == 1))
-        prime_list.push_back(integer(std::move(_n)));
+    std::vector<integer_class> primes;
+    _prime_factors(primes, std::move(_n));
+    for (auto &p : primes)
+        prime_list.push_back(integer(std::move(p)));
 }
 
 void prime_factor_multiplicities(map_integer_uint &primes_mul, const Integer &n)
 {
-    integer_class sqrtN;
     integer_class _n = n.as_integer_class();
-    unsigned count;
     if (_n == 0)
         return;
     if (_n < 0)
         _n *= -1;
 
-    sqrtN = mp_sqrt(_n);
-    auto limit = mp_get_ui(sqrtN);
-    if (not mp_fits_ulong_p(sqrtN)
-        or limit > std::numeric_limits<unsigned>::max())
-        throw SymEngineException("N too large to factor");
-    Sieve::iterator pi(numeric_cast<unsigned>(limit));
-
-    unsigned p;
-    while ((p = pi.next_prime()) <= limit) {
-        count = 0;
-        while (_n % p == 0) { // when a prime factor is found, we divide
-            ++count;          // _n by that prime as much as we can
-            _n = _n / p;
-        }
-        if (count > 0) {
-            insert(primes_mul, integer(p), count);
-            if (_n == 1)
-                break;
-        }
+    std::vector<integer_class> primes;
+    _prime_factors(primes, std::move(_n));
+    // The equal primes are consecutive
+    for (size_t i = 0, j = 0; i < primes.size(); i = j) {
+        while (j < primes.size() and primes[j] == primes[i])
+            j++;
+        insert(primes_mul, integer(std::move(primes[i])),
+               static_cast<unsigned>(j - i));
     }
-    if (not(_n == 1))
-        insert(primes_mul, integer(std::move(_n)), 1);
 }
 
 std::vector<unsigned> Sieve::_primes = {2, 3, 5, 7, 11, 13, 17, 19, 23, 29};
 bool Sieve::_clear = true;
 unsigned Sieve::_sieve_size = 32 * 1024 * 8; // 32K in bits
 
+namespace
+{
+std::mutex &sieve_mutex()
+{
+    static std::mutex *m = new std::mutex();
+    return *m;
+}
+
+#ifndef HAVE_SYMENGINE_PRIMESIEVE
+// Mod 30 wheel: bit i of byte k of a segment stands for the integer
+// 30 * k + wheel_residues[i], the other ones are multiples of 2, 3 or 5
+const unsigned wheel_residues[8] = {1, 7, 11, 13, 17, 19, 23, 29};
+const unsigned wheel_gaps[8] = {6, 4, 2, 4, 2, 4, 6, 2};
+// Bit of each residue coprime to 30
+const unsigned char wheel_bit[30] = {0, 0, 0, 0, 0, 0, 0, 1, 0, 0,
+                                     0, 2, 0, 3, 0, 0, 0, 4, 0, 5,
+                                     0, 0, 0, 6, 0, 0, 0, 0, 0, 7};
+// Index of the first residue coprime to 30 not less than each residue
+const unsigned char wheel_next[30] = {0, 0, 1, 1, 1, 1, 1, 1, 2, 2,
+                                      2, 2, 3, 3, 4, 4, 4, 4, 5, 5,
+                                      6, 6, 6, 6, 7, 7, 7, 7, 7, 7};
+
+// Sieves the integers in [30 * first, 30 * (first + bytes)) with `primes`,
+// which must hold all the primes up to the square root of the end, and
+// appends the primes in [start, limit] to `out`
+void sieve_segment(uint64_t first, unsigned bytes,
+                   const std::vector<unsigned> &primes, uint64_t start,
+                   uint64_t limit, std::vector<unsigned> &out)
+{
+    // The multiples of 7, 11 and 13 repeat every 1001 bytes, they are copied
+    // from a pattern instead of being crossed off
+    static const std::vector<unsigned char> pattern = []() {
+        std::vector<unsigned char> v(1001);
+        for (unsigned k = 0; k < 1001; k++) {
+            for (unsigned j = 0; j < 8; j++) {
+                const unsigned n = 30 * k + wheel_residues[j];
+                if (n % 7 != 0 and n % 11 != 0 and n % 13 != 0)
+                    v[k] |= static_cast<unsigned char>(1u << j);
+            }
+        }
+        return v;
+    }();
+    std::vector<unsigned char> sieve(bytes);
+    for (unsigned k = 0, j = static_cast<unsigned>(first % 1001); k < bytes;) {
+        const unsigned n = std::min(bytes - k, 1001 - j);
+        std::copy(pattern.begin() + j, pattern.begin() + j + n,
+                  sieve.begin() + k);
+        k += n;
+        j = 0;
+    }
+    const uint64_t low = 30 * first, high = low + 30 * uint64_t(bytes);
+    // 2, 3 and 5 are left out by the wheel, 7, 11 and 13 are in the pattern
+    for (size_t i = 6; i < primes.size(); i++) {
+        const uint64_t p = primes[i];
+        if (p * p >= high)
+            break;
+        // p * (30 * k + wheel_residues[j]) is in byte p * k + carry[j], at
+        // the bit cleared by mask[j]
+        uint64_t carry[8];
+        unsigned char mask[8];
+        for (unsigned j = 0; j < 8; j++) {
+            const uint64_t r = p * wheel_residues[j];
+            carry[j] = r / 30;
+            mask[j] = static_cast<unsigned char>(~(1u << wheel_bit[r % 30]));
+        }
+        // The first multiple p * q not below low nor p**2, with q coprime
+        // to 30 so that p * q is on the wheel
+        uint64_t q = std::max(p, (low + p - 1) / p);
+        unsigned w = wheel_next[q % 30];
+        int64_t base = static_cast<int64_t>(p * (q / 30))
+                       - static_cast<int64_t>(first);
+        // Whole turns of the wheel need no bound checks
+        const int64_t end = static_cast<int64_t>(bytes)
+                            - static_cast<int64_t>(carry[7]);
+        if (w != 0) {
+            for (; w < 8; w++) {
+                const int64_t k = base + static_cast<int64_t>(carry[w]);
+                if (k >= static_cast<int64_t>(bytes))
+                    break;
+                sieve[k] &= mask[w];
+            }
+            if (w < 8)
+                continue;
+            w = 0;
+            base += p;
+        }
+        for (; base < end; base += p) {
+            unsigned char *b = sieve.data();
+            b[base + carry[0]] &= mask[0];
+            b[base + carry[1]] &= mask[1];
+            b[base + carry[2]] &= mask[2];
+            b[base + carry[3]] &= mask[3];
+            b[base + carry[4]] &= mask[4];
+            b[base + carry[5]] &= mask[5];
+            b[base + carry[6]] &= mask[6];
+            b[base + carry[7]] &= mask[7];
+        }
+        for (bool done = false; not done; w = 0, base += p) {
+            for (; w < 8; w++) {
+                const int64_t k = base + static_cast<int64_t>(carry[w]);
+                if (k >= static_cast<int64_t>(bytes)) {
+                    done = true;
+                    break;
+                }
+                sieve[k] &= mask[w];
+            }
+        }
+    }
+    for (unsigned k = 0; k < bytes; k++) {
+        if (sieve[k] == 0)
+            continue;
+        for (unsigned i = 0; i < 8; i++) {
+            if (sieve[k] & (1 << i)) {
+                const uint64_t n = low + 30 * uint64_t(k) + wheel_residues[i];
+                if (n >= start and n <= limit)
+                    out.push_back(static_cast<unsigned>(n));
+            }
+        }
+    }
+}
+#endif
+} // namespace
+
 void Sieve::set_clear(bool clear)
 {
+    std::lock_guard<std::mutex> lock(sieve_mutex());
     _clear = clear;
 }
 
 void Sieve::clear()
 {
+    std::lock_guard<std::mutex> lock(sieve_mutex());
     _primes.erase(_primes.begin() + 10, _primes.end());
 }
 
@@ -508,10 +723,12 @@ void Sieve::set_sieve_size(unsigned size)
 #ifdef HAVE_SYMENGINE_PRIMESIEVE
     primesieve::set_sieve_size(size);
 #else
+    std::lock_guard<std::mutex> lock(sieve_mutex());
     _sieve_size = size * 1024 * 8; // size in bits
 #endif
 }
 
+// The caller must hold `sieve_mutex()`
 void Sieve::_extend(unsigned limit)
 {
 #ifdef HAVE_SYMENGINE_PRIMESIEVE
@@ -520,39 +737,38 @@ void Sieve::_extend(unsigned limit)
 #else
     const unsigned sqrt_limit
         = static_cast<unsigned>(std::floor(std::sqrt(limit)));
-    unsigned start = _primes.back() + 1;
+    uint64_t start = _primes.back() + 1;
     if (limit <= start)
         return;
     if (sqrt_limit >= start) {
         _extend(sqrt_limit);
         start = _primes.back() + 1;
     }
+    // pi(x) < x / (log(x) - 1.1) for x > 60184
+    if (limit > 60184) {
+        _primes.reserve(static_cast<size_t>(
+            limit / (std::log(static_cast<double>(limit)) - 1.1)));
+    }
 
-    unsigned segment = _sieve_size;
-    std::valarray<bool> is_prime(segment);
-    for (; start <= limit; start += 2 * segment) {
-        unsigned finish = std::min(start + segment * 2 + 1, limit);
-        is_prime[std::slice(0, segment, 1)] = true;
-        // considering only odd integers. An odd number n corresponds to
-        // n-start/2 in the array.
-        for (unsigned index = 1; index < _primes.size()
-                                 and _primes[index] * _primes[index] <= finish;
-             ++index) {
-            unsigned n = _primes[index];
-            unsigned multiple = (start / n + 1) * n;
-            if (multiple % 2 == 0)
-                multiple += n;
-            if (multiple > finish)
-                continue;
-            std::slice sl = std::slice((multiple - start) / 2,
-                                       1 + (finish - multiple) / (2 * n), n);
-            // starting from n*n, all the odd multiples of n are marked not
-            // prime.
-            is_prime[sl] = false;
+    const unsigned bytes = std::max(_sieve_size / 8, 1u);
+    const uint64_t first = start / 30, last = uint64_t(limit) / 30 + 1;
+    const uint64_t nsegments = (last - first + bytes - 1) / bytes;
+    // The segments are sieved in batches, each one in parallel, and their
+    // primes are appended in order
+    const uint64_t batch = 64;
+    std::vector<std::vector<unsigned>> found(batch);
+    for (uint64_t b = 0; b < nsegments; b += batch) {
+        const int count = static_cast<int>(std::min(batch, nsegments - b));
+#pragma omp parallel for schedule(dynamic)
+        for (int i = 0; i < count; i++) {
+            const uint64_t s = first + (b + i) * bytes;
+            found[i].clear();
+            sieve_segment(s, static_cast<unsigned>(std::min<uint64_t>(
+                                 bytes, last - s)),
+                          _primes, start, limit, found[i]);
         }
-        for (unsigned n = start + 1; n <= finish; n += 2) {
-            if (is_prime[(n - start) / 2])
-                _primes.push_back(n);
+        for (int i = 0; i < count; i++) {
+            _primes.insert(_primes.end(), found[i].begin(), found[i].end());
         }
     }
 #endif
@@ -560,6 +776,7 @@ void Sieve::_extend(unsigned limit)
 
 void Sieve::generate_primes(std::vector<unsigned> &primes, unsigned limit)
 {
+    std::lock_guard<std::mutex> lock(sieve_mutex());
     _extend(limit);
     auto it = std::upper_bound(_primes.begin(), _primes.end(), limit);
     // find the first position greater than limit and reserve space for the
@@ -567,7 +784,7 @@ void Sieve::generate_primes(std::vector<unsigned> &primes, unsigned limit)
     primes.reserve(it - _primes.begin());
     std::copy(_primes.begin(), it, std::back_inserter(primes));
     if (_clear)
-        clear();
+        _primes.erase(_primes.begin() + 10, _primes.end());
 }
 
 Sieve::iterator::iterator(unsigned max)
@@ -584,23 +801,37 @@ Sieve::iterator::iterator()
 
 Sieve::iterator::~iterator()
 {
+    std::lock_guard<std::mutex> lock(sieve_mutex());
     if (_clear)
-        Sieve::clear();
+        Sieve::_primes.erase(Sieve::_primes.begin() + 10,
+                             Sieve::_primes.end());
 }
 
 unsigned Sieve::iterator::next_prime()
 {
     if (_index >= _primes.size()) {
-        unsigned extend_to = _primes[_index - 1] * 2;
+        const unsigned last = _primes.empty() ? 1 : _primes.back();
+        unsigned extend_to = std::max(2 * std::min(last, UINT_MAX / 2), 100u);
         if (_limit > 0 and _limit < extend_to) {
             extend_to = _limit;
         }
-        _extend(extend_to);
-        if (_index >= _primes.size()) { // the next prime is greater than _limit
+        std::vector<unsigned> next;
+        {
+            std::lock_guard<std::mutex> lock(sieve_mutex());
+            Sieve::_extend(extend_to);
+            auto begin = std::upper_bound(Sieve::_primes.begin(),
+                                          Sieve::_primes.end(), last);
+            auto end = std::upper_bound(begin, Sieve::_primes.end(),
+                                        extend_to);
+            next.assign(begin, end);
+        }
+        if (next.empty()) { // the next prime is greater than _limit
             return _limit + 1;
         }
+        _primes = std::move(next);
+        _index = 0;
     }
-    return SymEngine::Sieve::_primes[_index++];
+    return _primes[_index++];
 }
 
 RCP<const Number> bernoulli(unsigned long n)
@@ -760,7 +991,7 @@ void _primitive_root(integer_class &g, const integer_class &p,
         for (const auto &it : primes) {
             t = it->as_integer_class();
             t = (p - 1) / t;
-            mp_powm(t, g, t, p);
+            _powm(t, g, t, p);
             if (t == 1) { // If g**(p-1)/q is 1 then g is not a primitive root.
                 root = false;
                 break;
@@ -774,7 +1005,7 @@ void _primitive_root(integer_class &g, const integer_class &p,
     if (e > 1) {
         t = p * p;
         integer_class pm1 = p - 1;
-        mp_powm(t, g, pm1, t);
+        _powm(t, g, pm1, t);
         if (t == 1) { // If g**(p-1) mod (p**2) == 1 then g + p is a primitive
                       // root.
             g += p;
@@ -850,7 +1081,7 @@ void _primitive_root_list(std::vector<RCP<const Integer>> &roots,
                 // h**(p-1) - 1 = d*p*h**(p-2)
                 // d = (h - h**(2-p)) / p
                 t = 2 - p;
-                mp_powm(d, h, t, pp);
+                _powm(d, h, t, pp);
                 d = ((h - d) / p + p) % p;
                 t = h;
                 // t = h + i * p + j * p * p and i != d
@@ -971,9 +1202,9 @@ bool multiplicative_order(const Ptr<RCP<const Integer>> &o,
         p = it.first->as_integer_class();
         mp_pow_ui(t, p, it.second);
         mp_divexact(order, order, t);
-        mp_powm(t, _a, order, _n);
+        _powm(t, _a, order, _n);
         while (t != 1) {
-            mp_powm(t, t, p, _n);
+            _powm(t, t, p, _n);
             order *= p;
         }
     }
@@ -1011,23 +1242,23 @@ bool _sqrt_mod_tonelli_shanks(integer_class &rop, const integer_class &a,
         state.urandomint(n, p);
         t = mp_legendre(n, p);
     }
-    mp_powm(y, n, q, p); // y = n**q mod p
-    mp_powm(b, a, q, p); // b = a**q mod p
+    _powm(y, n, q, p); // y = n**q mod p
+    _powm(b, a, q, p); // b = a**q mod p
     t = (q + 1) / 2;
-    mp_powm(rop, a, t, p); // rop = a**((q + 1) / 2) mod p
+    _powm(rop, a, t, p); // rop = a**((q + 1) / 2) mod p
 
     while (b != 1) {
         m = 0;
         t = b;
         while (t != 1) {
-            mp_powm(t, t, integer_class(2), p);
+            _powm(t, t, integer_class(2), p);
             ++m; // t = t**2 = b**2**(m)
         }
         if (m == e)
             return false;
         mp_pow_ui(q, integer_class(2), e - m - 1); // q = 2**(e - m - 1)
-        mp_powm(t, y, q, p);                       // t = y**(2**(e - m - 1))
-        mp_powm(y, t, integer_class(2), p);        // y = t**2
+        _powm(t, y, q, p);                         // t = y**(2**(e - m - 1))
+        _powm(y, t, integer_class(2), p);          // y = t**2
         e = m;
         rop = (rop * t) % p;
         b = (b * y) % p;
@@ -1050,17 +1281,17 @@ bool _sqrt_mod_prime(integer_class &rop, const integer_class &a,
         rop = 0;
     } else if (p % 4 == 3) {
         t = (p + 1) / 4;
-        mp_powm(rop, a, t, p);
+        _powm(rop, a, t, p);
     } else if (p % 8 == 5) {
         t = (p - 1) / 4;
-        mp_powm(t, a, t, p);
+        _powm(t, a, t, p);
         if (t == 1) {
             t = (p + 3) / 8;
-            mp_powm(rop, a, t, p);
+            _powm(rop, a, t, p);
         } else {
             t = (p - 5) / 8;
             integer_class t1 = 4 * a;
-            mp_powm(t, t1, t, p);
+            _powm(t, t1, t, p);
             rop = (2 * a * t) % p;
         }
     } else {
@@ -1094,7 +1325,7 @@ void _discrete_log(integer_class &log, const integer_class &a,
     log = 0;
     integer_class gamma = a, alpha, _n, t, beta, qj(1), m, l;
     _n = n / q;
-    mp_powm(alpha, g, _n, p);
+    _powm(alpha, g, _n, p);
     mp_sqrtrem(m, t, q);
     if (t != 0)
         ++m; // m = ceiling(sqrt(q)).
@@ -1102,7 +1333,7 @@ void _discrete_log(integer_class &log, const integer_class &a,
         table; // Table for lookup in baby-step giant-step algorithm
     integer_class alpha_j(1), d, s;
     s = -m;
-    mp_powm(s, alpha, s, p);
+    _powm(s, alpha, s, p);
 
     for (unsigned j = 0; j < m; ++j) {
         insert(table, integer(alpha_j), j);
@@ -1110,7 +1341,7 @@ void _discrete_log(integer_class &log, const integer_class &a,
     }
 
     for (unsigned long j = 0; j < k; ++j) { // Pohlig-Hellman
-        mp_powm(beta, gamma, _n, p);
+        _powm(beta, gamma, _n, p);
         // Baby-step giant-step algorithm for l = log_alpha(beta)
         d = beta;
         bool found = false;
@@ -1126,7 +1357,7 @@ void _discrete_log(integer_class &log, const integer_class &a,
         t = -l * qj;
 
         log -= t;
-        mp_powm(t, g, t, p);
+        _powm(t, g, t, p);
         gamma *= t; // gamma *= g ** (-l * (q ** j))
         qj *= q;
     }
@@ -1144,7 +1375,7 @@ bool _nthroot_mod1(std::vector<RCP<const Integer>> &roots,
     phi = pk * (p - 1) / p;
     mp_gcd(m, phi, n);
     t = phi / m;
-    mp_powm(t, a, t, pk);
+    _powm(t, a, t, pk);
     // Check whether a**(phi / gcd(phi, n)) == 1 mod p**k.
     if (t != 1) {
         return false;
@@ -1155,7 +1386,7 @@ bool _nthroot_mod1(std::vector<RCP<const Integer>> &roots,
     if (r < 0) {
         mp_fdiv_r(r, r, t / _n);
     }
-    mp_powm(s, a, r, p);
+    _powm(s, a, r, p);
 
     // Solve x**(_n) == s mod p where _n | p - 1.
     if (_n == 1) {
@@ -1180,18 +1411,18 @@ bool _nthroot_mod1(std::vector<RCP<const Integer>> &roots,
             mp_invert(t, h, qt);
             z = t * -h;
             x = (1 + z) / qt;
-            mp_powm(v, s1, x, p);
+            _powm(v, s1, x, p);
 
             if (c == it.second) {
                 s1 = v;
             } else {
-                mp_powm(x, s1, h, p);
+                _powm(x, s1, h, p);
                 t = h * qt;
-                mp_powm(r, g, t, p);
+                _powm(r, g, t, p);
                 mp_pow_ui(qt, q, c - it.second);
                 _discrete_log(t, x, r, qt, q, c - it.second, p);
                 t = -z * t;
-                mp_powm(r, g, t, p);
+                _powm(r, g, t, p);
                 v *= r;
                 mp_fdiv_r(v, v, p);
                 s1 = v;
@@ -1209,13 +1440,13 @@ bool _nthroot_mod1(std::vector<RCP<const Integer>> &roots,
     // Solve s == x**r mod p**k where (x**r)**(p**c)) == a mod p**k
     integer_class pc = n / r, pd = pc * p;
     if (c >= 1) {
-        mp_powm(s, root, r, p);
+        _powm(s, root, r, p);
         // s == root**r mod p. Since s**(p**c) == 1 == a mod p**(c + 1), lift
         // until p**k.
         for (unsigned d = c + 2; d <= k; ++d) {
             t = 1 - pc;
             pd *= p;
-            mp_powm(t, s, t, pd);
+            _powm(t, s, t, pd);
             t = (a * t - s) / pc;
             s += t;
         }
@@ -1231,7 +1462,7 @@ bool _nthroot_mod1(std::vector<RCP<const Integer>> &roots,
         pd *= pd;
         if (d > k)
             pd = pk;
-        mp_powm(u, root, t, pd);
+        _powm(u, root, t, pd);
         t = r * u;
         mp_invert(t, t, pd);
         root += (s - u * root) * t;
@@ -1245,7 +1476,7 @@ bool _nthroot_mod1(std::vector<RCP<const Integer>> &roots,
             if (g == 0)
                 _primitive_root(g, p, integer_class(2));
             t = phi / m;
-            mp_powm(t, g, t, pk);
+            _powm(t, g, t, pk);
         }
         for (unsigned j = 0; j < m; ++j) {
             roots.push_back(integer(root));
@@ -1268,7 +1499,7 @@ bool _is_nthroot_mod1(const integer_class &a, const integer_class &n,
     phi = pk * (p - 1) / p;
     mp_gcd(m, phi, n);
     t = phi / m;
-    mp_powm(t, a, t, pk);
+    _powm(t, a, t, pk);
     // Check whether a**(phi / gcd(phi, n)) == 1 mod p**k.
     if (t != 1) {
         return false;
@@ -1316,7 +1547,7 @@ bool _nthroot_mod_prime_power(std::vector<RCP<const Integer>> &roots,
             if (c == 0) {
                 // x**r == a mod 2**k and x**2**(k - 2) == 1 mod 2**k, implies
                 // x**(r * s) == x == a**s mod 2**k.
-                mp_powm(root, a, s, pk);
+                _powm(root, a, s, pk);
                 roots.push_back(integer(root));
                 return true;
             }
@@ -1332,14 +1563,14 @@ bool _nthroot_mod_prime_power(std::vector<RCP<const Integer>> &roots,
             // 1 is a root of x**2**c == 1 mod 2**(c + 2). Lift till 2**k.
             for (unsigned j = c + 2; j < k; ++j) {
                 pj *= 2;
-                mp_powm(t, root, pc, pj);
+                _powm(t, root, pc, pj);
                 t -= a;
                 if (t % pj != 0)
                     // Add 2**(j - c).
                     root += integer_class(1) << (j - c);
             }
             // Solve x**r == root mod 2**k.
-            mp_powm(root, root, s, pk);
+            _powm(root, root, s, pk);
 
             if (all_roots) {
                 // All roots are generated by, root * (j * (2**(k - c) +/- 1)).
@@ -1548,7 +1779,7 @@ bool powermod(const Ptr<RCP<const Integer>> &powm, const RCP<const Integer> &a,
         integer_class t = down_cast<const Integer &>(*b).as_integer_class();
         if (b->is_negative())
             t *= -1;
-        mp_powm(t, a->as_integer_class(), t, m->as_integer_class());
+        _powm(t, a->as_integer_class(), t, m->as_integer_class());
         if (b->is_negative()) {
             bool ret_val = mp_invert(t, t, m->as_integer_class());
             if (not ret_val)
@@ -1564,7 +1795,7 @@ bool powermod(const Ptr<RCP<const Integer>> &powm, const RCP<const Integer> &a,
             num = num->mulint(*minus_one);
         }
         integer_class t = mp_abs(num->as_integer_class());
-        mp_powm(t, a->as_integer_class(), t, m->as_integer_class());
+        _powm(t, a->as_integer_class(), t, m->as_integer_class());
         if (num->is_negative()) {
             bool ret_val = mp_invert(t, t, m->as_integer_class());
             if (not ret_val)
@@ -1583,7 +1814,7 @@ void powermod_list(std::vector<RCP<const Integer>> &pows,
     if (is_a<Integer>(*b)) {
         integer_class t
             = mp_abs(down_cast<const Integer &>(*b).as_integer_class());
-        mp_powm(t, a->as_integer_class(), t, m->as_integer_class());
+        _powm(t, a->as_integer_class(), t, m->as_integer_class());
         if (b->is_negative()) {
             bool ret_val = mp_invert(t, t, m->as_integer_class());
             if (not ret_val)
@@ -1600,7 +1831,7 @@ void powermod_list(std::vector<RCP<const Integer>> &pows,
         integer_class t = num->as_integer_class();
         if (num->is_negative())
             t *= -1;
-        mp_powm(t, a->as_integer_class(), t, m->as_integer_class());
+        _powm(t, a->as_integer_class(), t, m->as_integer_class());
         if (num->is_negative()) {
             bool ret_val = mp_invert(t, t, m->as_integer_class());
             if (not ret_val)
@@ -1611,6 +1842,35 @@ void powermod_list(std::vector<RCP<const Integer>> &pows,
     }
 }
 
+void powermod_batch(std::vector<RCP<const Integer>> &pows,
+                    const std::vector<RCP<const Integer>> &bases,
+                    const RCP<const Integer> &e, const RCP<const Integer> &m)
+{
+    const integer_class &_e = e->as_integer_class();
+    const integer_class &_m = m->as_integer_class();
+    if (_e < 0)
+        throw SymEngineException("Require e >= 0 in powermod_batch");
+    pows.reserve(pows.size() + bases.size());
+    integer_class t;
+    if (mp_fits_ulong_p(_e) and is_word_modulus(_m)) {
+        std::vector<uint64_t> b(bases.size()), r;
+        for (size_t i = 0; i < bases.size(); i++) {
+            mp_fdiv_r(t, bases[i]->as_integer_class(), _m);
+            b[i] = mp_get_ui(t);
+        }
+        powmod_u64_list(r, b, mp_get_ui(_e), mp_get_ui(_m));
+        for (uint64_t x : r)
+            pows.push_back(
+                integer(integer_class(static_cast<unsigned long>(x))));
+        return;
+    }
+    for (const auto &b : bases) {
+        integer_class r;
+        mp_powm(r, b->as_integer_class(), _e, _m);
+        pows.push_back(integer(std::move(r)));
+    }
+}
+
 vec_integer_class quadratic_residues(const Integer &a)
 {
     /*
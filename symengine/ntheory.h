@@ -75,7 +75,9 @@ RCP<const Integer> factorial(unsigned long n);
 //! \return true if `b` divides `a`
 bool divides(const Integer &a, const Integer &b);
 
-//! Factorization
+//! Factorization. Without gmp-ecm, `n` is split by Pollard's rho method when
+//! it fits in 64 bits, by the quadratic sieve up to 100 digits and by the
+//! elliptic curve method above.
 //! \param B1 is only used when `n` is factored using gmp-ecm
 int factor(const Ptr<RCP<const Integer>> &f, const Integer &n, double B1 = 1.0);
 
@@ -95,18 +97,27 @@ int factor_pollard_pm1_method(const Ptr<RCP<const Integer>> &f,
 int factor_pollard_rho_method(const Ptr<RCP<const Integer>> &f,
                               const Integer &n, unsigned retries = 5);
 
+//! Factor using the elliptic curve method (Montgomery curves with Suyama's
+//! parametrization), with stage 1 bound `B1` and stage 2 bound 100 * `B1`.
+//! \return 1 if a non-trivial factor is found, otherwise 0.
+int factor_ecm(const Ptr<RCP<const Integer>> &f, const Integer &n,
+               unsigned B1 = 10000, unsigned curves = 50);
+
+//! Factor using the self initializing quadratic sieve. `n` must be
+//! composite, not a perfect power and below 2**400.
+//! \return 1 if a non-trivial factor is found, otherwise 0.
+int factor_siqs(const Ptr<RCP<const Integer>> &f, const Integer &n);
+
 //! Find prime factors of `n`
 void prime_factors(std::vector<RCP<const Integer>> &primes, const Integer &n);
 //! Find multiplicities of prime factors of `n`
 void prime_factor_multiplicities(map_integer_uint &primes, const Integer &n);
 // Sieve class stores all the primes upto a limit. When a prime or a list of
-// prime
-// is requested, if the prime is not there in the sieve, it is extended to hold
-// that
-// prime. The implementation is a very basic Eratosthenes sieve, but the code
-// should
-// be quite optimized. For limit=1e8, it is about 20x slower than the
-// `primesieve` library (1206ms vs 55.63ms).
+// primes is requested, if the prime is not there in the sieve, it is extended
+// to hold that prime. The sieve is segmented, each segment being a bitmap of
+// the integers coprime to 30 (one byte per 30 integers), and the segments are
+// sieved in parallel when OpenMP is enabled. The stored primes are shared by
+// all threads and guarded by a mutex.
 class Sieve
 {
 
@@ -136,6 +147,9 @@ public:
     {
 
     private:
+        // The primes handed out next, copied from the shared list so that
+        // other threads can extend it meanwhile
+        std::vector<unsigned> _primes;
         unsigned _index;
         unsigned _limit;
 
@@ -194,6 +208,11 @@ bool powermod(const Ptr<RCP<const Integer>> &powm, const RCP<const Integer> &a,
 void powermod_list(std::vector<RCP<const Integer>> &pows,
                    const RCP<const Integer> &a, const RCP<const Number> &b,
                    const RCP<const Integer> &m);
+//! Appends b**e mod m to `pows` for every b of `bases`, with e >= 0. The
+//! moduli below 2**63 are handled on machine words, four bases at a time.
+void powermod_batch(std::vector<RCP<const Integer>> &pows,
+                    const std::vector<RCP<const Integer>> &bases,
+                    const RCP<const Integer> &e, const RCP<const Integer> &m);
 
 //! Finds all Quadratic Residues of a Positive Integer
 vec_integer_class quadratic_residues(const Integer &a);
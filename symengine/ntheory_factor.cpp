@@ -0,0 +1,741 @@
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <map>
+#include <random>
+#include <set>
+
+#include <symengine/ntheory.h>
+#include <symengine/mod_word.h>
+
+namespace SymEngine
+{
+
+namespace
+{
+// Arithmetic on words, the moduli are below 2**32. Inverse of `a` modulo
+// `m`, they are coprime.
+uint64_t invmod_u(uint64_t a, uint64_t m)
+{
+    uint64_t r = 0;
+    invmod_u64(r, a, m);
+    return r;
+}
+
+// Square root of the quadratic residue `a` modulo the odd prime `p`
+// (Tonelli-Shanks)
+uint64_t sqrtmod_u(uint64_t a, uint64_t p)
+{
+    a %= p;
+    if (a == 0)
+        return 0;
+    if (p % 4 == 3)
+        return powmod_u64(a, (p + 1) / 4, p);
+    uint64_t q = p - 1, s = 0;
+    while (q % 2 == 0) {
+        q /= 2;
+        s++;
+    }
+    uint64_t z = 2;
+    while (powmod_u64(z, (p - 1) / 2, p) != p - 1)
+        z++;
+    uint64_t m = s, c = powmod_u64(z, q, p), t = powmod_u64(a, q, p),
+             r = powmod_u64(a, (q + 1) / 2, p);
+    while (t != 1) {
+        uint64_t i = 0, t2 = t;
+        while (t2 != 1) {
+            t2 = t2 * t2 % p;
+            i++;
+        }
+        uint64_t b = c;
+        for (uint64_t j = 0; j + i + 1 < m; j++)
+            b = b * b % p;
+        m = i;
+        c = b * b % p;
+        t = t * c % p;
+        r = r * b % p;
+    }
+    return r;
+}
+
+unsigned mod_u(const integer_class &a, unsigned p)
+{
+    integer_class r;
+    mp_fdiv_r(r, a, integer_class(p));
+    return static_cast<unsigned>(mp_get_ui(r));
+}
+
+// Elliptic curve method on Montgomery curves b*y**2 = x**3 + A*x**2 + x,
+// whose points are kept in projective X:Z coordinates without y.
+struct MontgomeryPoint {
+    integer_class x, z;
+};
+
+class MontgomeryCurve
+{
+public:
+    // `a24` is (A + 2) / 4 modulo `n`
+    MontgomeryCurve(const integer_class &n, const integer_class &a24)
+        : n_(n), a24_(a24)
+    {
+    }
+
+    // r = 2 * p
+    void dbl(MontgomeryPoint &r, const MontgomeryPoint &p)
+    {
+        t1_ = p.x + p.z;
+        t1_ *= t1_;
+        mp_fdiv_r(t1_, t1_, n_);
+        t2_ = p.x - p.z;
+        t2_ *= t2_;
+        mp_fdiv_r(t2_, t2_, n_);
+        t3_ = t1_ - t2_;
+        r.x = t1_ * t2_;
+        mp_fdiv_r(r.x, r.x, n_);
+        t4_ = a24_ * t3_ + t2_;
+        mp_fdiv_r(t4_, t4_, n_);
+        r.z = t3_ * t4_;
+        mp_fdiv_r(r.z, r.z, n_);
+    }
+
+    // r = p + q, knowing d = p - q. `r` may be `p` or `q` but not `d`.
+    void add(MontgomeryPoint &r, const MontgomeryPoint &p,
+             const MontgomeryPoint &q, const MontgomeryPoint &d)
+    {
+        t1_ = (p.x - p.z) * (q.x + q.z);
+        t2_ = (p.x + p.z) * (q.x - q.z);
+        t3_ = t1_ + t2_;
+        mp_fdiv_r(t3_, t3_, n_);
+        t3_ *= t3_;
+        t4_ = t1_ - t2_;
+        mp_fdiv_r(t4_, t4_, n_);
+        t4_ *= t4_;
+        r.x = d.z * t3_;
+        mp_fdiv_r(r.x, r.x, n_);
+        r.z = d.x * t4_;
+        mp_fdiv_r(r.z, r.z, n_);
+    }
+
+    // r = k * p by the Montgomery ladder, k > 0
+    void mul(MontgomeryPoint &r, const MontgomeryPoint &p, uint64_t k)
+    {
+        MontgomeryPoint r0 = p, r1;
+        dbl(r1, p);
+        int bit = 63;
+        while (not((k >> bit) & 1))
+            bit--;
+        for (bit--; bit >= 0; bit--) {
+            if ((k >> bit) & 1) {
+                add(r0, r0, r1, p);
+                dbl(r1, r1);
+            } else {
+                add(r1, r0, r1, p);
+                dbl(r0, r0);
+            }
+        }
+        r = std::move(r0);
+    }
+
+private:
+    const integer_class &n_;
+    integer_class a24_;
+    integer_class t1_, t2_, t3_, t4_;
+};
+
+// Sets `f` to gcd(`a`, `n`) and returns whether it is a proper factor
+bool proper_gcd(integer_class &f, const integer_class &a,
+                const integer_class &n)
+{
+    mp_gcd(f, a, n);
+    return f != 1 and f != n;
+}
+
+// Runs one curve of Suyama's family with the given `sigma`. Stage 1
+// multiplies by all prime powers up to B1, stage 2 looks for one more prime
+// in (B1, B2] with a baby step giant step continuation.
+bool ecm_curve(integer_class &f, const integer_class &n, unsigned long sigma,
+               const std::vector<unsigned> &primes, unsigned B1, unsigned B2)
+{
+    integer_class u = integer_class(sigma) * sigma - 5, v = 4 * sigma, t, w;
+    MontgomeryPoint p;
+    p.x = u * u * u;
+    mp_fdiv_r(p.x, p.x, n);
+    p.z = v * v * v;
+    mp_fdiv_r(p.z, p.z, n);
+    // a24 = (v - u)**3 * (3 * u + v) / (16 * u**3 * v)
+    t = 16 * p.x * v;
+    mp_fdiv_r(t, t, n);
+    if (not mp_invert(w, t, n))
+        return proper_gcd(f, t, n);
+    t = v - u;
+    t = t * t * t * (3 * u + v) * w;
+    mp_fdiv_r(t, t, n);
+    MontgomeryCurve curve(n, t);
+
+    for (unsigned q : primes) {
+        if (q > B1)
+            break;
+        uint64_t m = q;
+        while (m * q <= B1)
+            m *= q;
+        curve.mul(p, p, m);
+    }
+    if (proper_gcd(f, p.z, n))
+        return true;
+    if (f == n)
+        return false;
+
+    // Each prime of stage 2 is k * D +- j with gcd(j, D) = 1, and
+    // x(k * D * P) * z(j * P) - x(j * P) * z(k * D * P) vanishes modulo a
+    // factor whose order divides it
+    const unsigned D = 210;
+    std::vector<MontgomeryPoint> baby(D / 2);
+    baby[1] = p;
+    curve.dbl(baby[2], p);
+    curve.add(baby[3], baby[2], p, p);
+    for (unsigned j = 5; j < D / 2; j += 2)
+        curve.add(baby[j], baby[j - 2], baby[2], baby[j - 4]);
+    // giant = k * D * P and prev = (k - 1) * D * P, starting at the first
+    // multiple of D at or below B1. The point at infinity is (1 : 0).
+    MontgomeryPoint step, giant, prev;
+    curve.mul(step, p, D);
+    uint64_t k = B1 / D;
+    if (k == 0) {
+        giant.x = 1;
+        giant.z = 0;
+    } else {
+        curve.mul(giant, p, k * D);
+        if (k >= 2)
+            curve.mul(prev, p, (k - 1) * D);
+    }
+    integer_class g(1);
+    auto it = std::upper_bound(primes.begin(), primes.end(), B1);
+    for (; it != primes.end() and *it <= B2; ++it) {
+        while (k * D + D / 2 < *it) {
+            // The differential addition cannot start from the point at
+            // infinity, the first two steps are done directly
+            MontgomeryPoint next;
+            if (k == 0)
+                next = step;
+            else if (k == 1)
+                curve.dbl(next, step);
+            else
+                curve.add(next, giant, step, prev);
+            prev = std::move(giant);
+            giant = std::move(next);
+            k++;
+        }
+        // The prime is k * D +- j, with j odd and coprime to D
+        const unsigned j
+            = static_cast<unsigned>(*it > k * D ? *it - k * D : k * D - *it);
+        const MontgomeryPoint &b = baby[j];
+        t = giant.x * b.z - b.x * giant.z;
+        g *= t;
+        mp_fdiv_r(g, g, n);
+    }
+    return proper_gcd(f, g, n);
+}
+
+// Parameters of the self initializing quadratic sieve by number of digits:
+// factor base size and half the length of the sieve interval
+struct SiqsParams {
+    unsigned digits;
+    unsigned fb_size;
+    unsigned half_interval;
+};
+
+// Largest size of n in bits
+const unsigned siqs_max_bits = 400;
+
+const SiqsParams siqs_params[] = {
+    {20, 100, 8192},     {25, 150, 16384},    {30, 250, 32768},
+    {35, 400, 32768},    {40, 600, 65536},    {45, 900, 65536},
+    {50, 1300, 65536},   {55, 1900, 98304},   {60, 2700, 98304},
+    {65, 3800, 131072},  {70, 5000, 131072},  {75, 6500, 196608},
+    {80, 8000, 196608},  {90, 12000, 262144}, {100, 18000, 327680},
+};
+
+// y**2 = sign * product of the factor base primes * large**2 (modulo n).
+// The factors are column indices, 0 standing for -1 and i + 1 for the i-th
+// prime of the factor base.
+struct SiqsRelation {
+    integer_class y;
+    std::vector<unsigned> factors;
+    integer_class large;
+};
+
+// Self initializing quadratic sieve (Contini's thesis). The polynomials are
+// (a * x + b)**2 - k * n = a * g(x), with `a` a product of factor base primes
+// and the 2**(s - 1) values of `b` for one `a` visited in Gray code order, so
+// that the roots of each new polynomial are updated with one addition.
+class Siqs
+{
+public:
+    explicit Siqs(const integer_class &n) : n_(n), rng_(12345)
+    {
+    }
+
+    bool run(integer_class &f);
+
+private:
+    const integer_class &n_;
+    integer_class kn_;
+    unsigned multiplier_;
+    unsigned half_interval_;
+    // Factor base primes with a square root of k * n modulo each of them
+    std::vector<unsigned> fb_;
+    std::vector<integer_class> fbz_;
+    std::vector<unsigned> sqrt_kn_;
+    std::vector<unsigned char> logp_;
+    // Primes below this index are not sieved, only trial divided
+    unsigned first_sieved_;
+    unsigned char threshold_;
+    integer_class large_bound_;
+    std::mt19937 rng_;
+    std::set<std::vector<unsigned>> used_a_;
+
+    void choose_multiplier();
+    bool build_factor_base(integer_class &f, unsigned size);
+    bool choose_a(std::vector<unsigned> &qs);
+    void sieve_a(const std::vector<unsigned> &qs,
+                 std::vector<SiqsRelation> &relations) const;
+    bool find_factor(integer_class &f,
+                     const std::vector<SiqsRelation> &relations) const;
+};
+
+void Siqs::choose_multiplier()
+{
+    // Knuth-Schroeppel function: the expected contribution of the small
+    // primes to the values to sieve, minus the growth due to the multiplier
+    static const unsigned candidates[]
+        = {1,  3,  5,  7,  11, 13, 15, 17, 19, 21,
+           23, 29, 31, 33, 35, 37, 39, 41, 43, 47};
+    std::vector<unsigned> small;
+    Sieve::generate_primes(small, 1000);
+    double best = -1e100;
+    multiplier_ = 1;
+    for (unsigned k : candidates) {
+        const integer_class kn = n_ * k;
+        double score = -0.5 * std::log(double(k));
+        const unsigned r8 = mod_u(kn, 8);
+        if (r8 == 1)
+            score += 2 * std::log(2.0);
+        else if (r8 == 5)
+            score += std::log(2.0);
+        else
+            score += 0.5 * std::log(2.0);
+        for (size_t i = 1; i < small.size(); i++) {
+            const unsigned p = small[i];
+            if (k % p == 0) {
+                score += std::log(double(p)) / p;
+            } else if (powmod_u64(mod_u(kn, p), (p - 1) / 2, p) == 1) {
+                score += 2 * std::log(double(p)) / (p - 1);
+            }
+        }
+        if (score > best) {
+            best = score;
+            multiplier_ = k;
+        }
+    }
+    kn_ = n_ * multiplier_;
+}
+
+bool Siqs::build_factor_base(integer_class &f, unsigned size)
+{
+    Sieve::iterator pi;
+    fb_.push_back(2);
+    sqrt_kn_.push_back(mod_u(kn_, 2));
+    while (fb_.size() < size) {
+        const unsigned p = pi.next_prime();
+        if (p == 2)
+            continue;
+        const unsigned r = mod_u(kn_, p);
+        if (r == 0 and multiplier_ % p != 0) {
+            f = p;
+            return true;
+        }
+        if (r == 0 or powmod_u64(r, (p - 1) / 2, p) == 1) {
+            fb_.push_back(p);
+            sqrt_kn_.push_back(static_cast<unsigned>(sqrtmod_u(r, p)));
+        }
+    }
+    for (unsigned p : fb_) {
+        fbz_.push_back(integer_class(p));
+        logp_.push_back(
+            static_cast<unsigned char>(std::lround(std::log2(double(p)))));
+    }
+    first_sieved_ = 0;
+    while (first_sieved_ + 1 < fb_.size() and fb_[first_sieved_] < 30)
+        first_sieved_++;
+    return false;
+}
+
+bool Siqs::choose_a(std::vector<unsigned> &qs)
+{
+    const double log_target = 0.5 * (std::log(2.0) + std::log(mp_get_d(kn_)))
+                              - std::log(double(half_interval_));
+    const unsigned nfb = static_cast<unsigned>(fb_.size());
+    // Number of primes in `a` and their ideal size, the primes are taken
+    // around it
+    const double log_mid = std::log(double(fb_[nfb / 2]));
+    const unsigned s = std::max(
+        2u, static_cast<unsigned>(std::lround(log_target / log_mid)));
+    const double log_ideal = log_target / s;
+    unsigned lo = first_sieved_, hi = nfb;
+    while (lo < nfb and std::log(double(fb_[lo])) < log_ideal - 0.7)
+        lo++;
+    while (hi > lo and std::log(double(fb_[hi - 1])) > log_ideal + 0.7)
+        hi--;
+    while (hi - lo < 2 * s + 4 and (lo > first_sieved_ or hi < nfb)) {
+        if (lo > first_sieved_)
+            lo--;
+        if (hi < nfb)
+            hi++;
+    }
+    std::uniform_int_distribution<unsigned> pick(lo, hi - 1);
+
+    double best = 1e100;
+    for (unsigned attempt = 0; attempt < 30; attempt++) {
+        std::vector<unsigned> cand;
+        double log_a = 0;
+        while (cand.size() + 1 < s) {
+            const unsigned i = pick(rng_);
+            // Primes dividing the multiplier have a single root
+            if (sqrt_kn_[i] == 0
+                or std::find(cand.begin(), cand.end(), i) != cand.end())
+                continue;
+            cand.push_back(i);
+            log_a += std::log(double(fb_[i]));
+        }
+        // The last prime brings `a` closest to the target
+        unsigned last = nfb;
+        double err = 1e100;
+        for (unsigned i = first_sieved_; i < nfb; i++) {
+            if (sqrt_kn_[i] == 0
+                or std::find(cand.begin(), cand.end(), i) != cand.end())
+                continue;
+            const double e
+                = std::fabs(log_a + std::log(double(fb_[i])) - log_target);
+            if (e < err) {
+                err = e;
+                last = i;
+            }
+        }
+        if (last == nfb)
+            continue;
+        cand.push_back(last);
+        std::sort(cand.begin(), cand.end());
+        if (err < best and used_a_.count(cand) == 0) {
+            best = err;
+            qs = cand;
+        }
+    }
+    if (best == 1e100)
+        return false;
+    used_a_.insert(qs);
+    return true;
+}
+
+void Siqs::sieve_a(const std::vector<unsigned> &qs,
+                   std::vector<SiqsRelation> &relations) const
+{
+    const unsigned nfb = static_cast<unsigned>(fb_.size());
+    const unsigned s = static_cast<unsigned>(qs.size());
+    const unsigned M = half_interval_;
+    integer_class a(1), b(0), c, t;
+    for (unsigned i : qs)
+        a *= fbz_[i];
+    // b = sum of the B_l, with B_l**2 = k * n modulo q_l and B_l = 0
+    // modulo the other primes of `a`
+    std::vector<integer_class> B(s);
+    for (unsigned l = 0; l < s; l++) {
+        const unsigned q = fb_[qs[l]];
+        const integer_class aq = a / fbz_[qs[l]];
+        uint64_t gamma = uint64_t(sqrt_kn_[qs[l]]) * invmod_u(mod_u(aq, q), q)
+                         % q;
+        if (gamma > q / 2)
+            gamma = q - gamma;
+        B[l] = aq * integer_class(static_cast<unsigned long>(gamma));
+        b += B[l];
+    }
+
+    std::vector<bool> divides_a(nfb, false);
+    for (unsigned i : qs)
+        divides_a[i] = true;
+    // Roots of g modulo each prime, as offsets in the sieve array, and the
+    // changes 2 * B_l / a of the roots when the sign of B_l flips
+    std::vector<unsigned> root1(nfb), root2(nfb);
+    std::vector<std::vector<unsigned>> delta(s, std::vector<unsigned>(nfb));
+    for (unsigned i = 1; i < nfb; i++) {
+        if (divides_a[i])
+            continue;
+        const uint64_t p = fb_[i];
+        const uint64_t ainv = invmod_u(mod_u(a, fb_[i]), p);
+        for (unsigned l = 0; l < s; l++)
+            delta[l][i] = static_cast<unsigned>(2 * mod_u(B[l], fb_[i]) * ainv
+                                                % p);
+        const uint64_t bm = mod_u(b, fb_[i]), r = sqrt_kn_[i], m = M % p;
+        root1[i] = static_cast<unsigned>((ainv * (r + p - bm) + m) % p);
+        root2[i] = static_cast<unsigned>((ainv * (2 * p - r - bm) + m) % p);
+    }
+
+    std::vector<unsigned char> sieve(2 * M);
+    integer_class g, y, x;
+    for (unsigned poly = 0; poly < (1u << (s - 1)); poly++) {
+        if (poly > 0) {
+            // Gray code: flip the sign of B_(v + 1)
+            unsigned v = 0;
+            while (not((poly >> v) & 1))
+                v++;
+            const bool negative = ((poly ^ (poly >> 1)) >> v) & 1;
+            const unsigned l = v + 1;
+            if (negative) {
+                b -= 2 * B[l];
+            } else {
+                b += 2 * B[l];
+            }
+            for (unsigned i = 1; i < nfb; i++) {
+                if (divides_a[i])
+                    continue;
+                const unsigned p = fb_[i];
+                const unsigned d = negative ? delta[l][i] : p - delta[l][i];
+                root1[i] = (root1[i] + d) % p;
+                root2[i] = (root2[i] + d) % p;
+            }
+        }
+        t = b * b - kn_;
+        mp_divexact(c, t, a);
+
+        std::fill(sieve.begin(), sieve.end(), 0);
+        for (unsigned i = first_sieved_; i < nfb; i++) {
+            if (divides_a[i])
+                continue;
+            const unsigned p = fb_[i];
+            const unsigned char lp = logp_[i];
+            for (unsigned j = root1[i]; j < 2 * M; j += p)
+                sieve[j] += lp;
+            if (root2[i] != root1[i]) {
+                for (unsigned j = root2[i]; j < 2 * M; j += p)
+                    sieve[j] += lp;
+            }
+        }
+
+        for (unsigned j = 0; j < 2 * M; j++) {
+            if (sieve[j] < threshold_)
+                continue;
+            x = static_cast<long>(j) - static_cast<long>(M);
+            g = (a * x + 2 * b) * x + c;
+            if (g == 0)
+                continue;
+            SiqsRelation rel;
+            if (g < 0) {
+                rel.factors.push_back(0);
+                g = -g;
+            }
+            for (unsigned i = 0; i < nfb; i++) {
+                if (i >= first_sieved_ and not divides_a[i]) {
+                    const unsigned r = j % fb_[i];
+                    if (r != root1[i] and r != root2[i])
+                        continue;
+                }
+                while (mp_divisible_p(g, fbz_[i])) {
+                    mp_divexact(g, g, fbz_[i]);
+                    rel.factors.push_back(i + 1);
+                }
+            }
+            if (g != 1 and g >= large_bound_)
+                continue;
+            for (unsigned i : qs)
+                rel.factors.push_back(i + 1);
+            rel.y = a * x + b;
+            rel.large = g;
+            relations.push_back(std::move(rel));
+        }
+    }
+}
+
+bool Siqs::find_factor(integer_class &f,
+                       const std::vector<SiqsRelation> &relations) const
+{
+    const size_t ncols = fb_.size() + 1, nrows = relations.size();
+    const size_t cwords = (ncols + 63) / 64, rwords = (nrows + 63) / 64;
+    // Each row is the exponent vector modulo 2 followed by the rows of the
+    // identity, which record the combination that produced it
+    std::vector<std::vector<uint64_t>> rows(
+        nrows, std::vector<uint64_t>(cwords + rwords, 0));
+    for (size_t r = 0; r < nrows; r++) {
+        for (unsigned col : relations[r].factors)
+            rows[r][col / 64] ^= uint64_t(1) << (col % 64);
+        rows[r][cwords + r / 64] |= uint64_t(1) << (r % 64);
+    }
+    std::vector<bool> pivot(nrows, false);
+    for (size_t col = 0; col < ncols; col++) {
+        const size_t w = col / 64;
+        const uint64_t bit = uint64_t(1) << (col % 64);
+        size_t p = 0;
+        while (p < nrows and (pivot[p] or not(rows[p][w] & bit)))
+            p++;
+        if (p == nrows)
+            continue;
+        pivot[p] = true;
+        for (size_t r = 0; r < nrows; r++) {
+            if (r != p and (rows[r][w] & bit)) {
+                for (size_t k = w; k < cwords + rwords; k++)
+                    rows[r][k] ^= rows[p][k];
+            }
+        }
+    }
+
+    std::vector<unsigned> exponents(ncols);
+    integer_class x, y, t;
+    for (size_t r = 0; r < nrows; r++) {
+        if (pivot[r])
+            continue;
+        // The relations of this dependency multiply to a square
+        std::fill(exponents.begin(), exponents.end(), 0);
+        x = 1;
+        y = 1;
+        for (size_t k = 0; k < nrows; k++) {
+            if (not((rows[r][cwords + k / 64] >> (k % 64)) & 1))
+                continue;
+            x *= relations[k].y;
+            mp_fdiv_r(x, x, n_);
+            y *= relations[k].large;
+            mp_fdiv_r(y, y, n_);
+            for (unsigned col : relations[k].factors)
+                exponents[col]++;
+        }
+        for (size_t col = 1; col < ncols; col++) {
+            if (exponents[col] == 0)
+                continue;
+            mp_powm(t, fbz_[col - 1], integer_class(exponents[col] / 2), n_);
+            y *= t;
+            mp_fdiv_r(y, y, n_);
+        }
+        if (proper_gcd(f, x - y, n_))
+            return true;
+    }
+    return false;
+}
+
+bool Siqs::run(integer_class &f)
+{
+    choose_multiplier();
+    const unsigned digits = static_cast<unsigned>(
+        std::ceil(std::log10(mp_get_d(kn_))));
+    const SiqsParams *params = siqs_params;
+    while (params->digits < digits
+           and params + 1 != std::end(siqs_params))
+        params++;
+    half_interval_ = params->half_interval;
+    if (build_factor_base(f, params->fb_size))
+        return true;
+
+    // The values of g are about M * sqrt(k * n / 2), the candidates may
+    // leave a cofactor of up to about two primes of the factor base
+    const double pmax = fb_.back();
+    threshold_ = static_cast<unsigned char>(std::max(
+        1.0, std::log2(double(half_interval_))
+                 + 0.5 * std::log2(mp_get_d(kn_)) - 0.5
+                 - 2.0 * std::log2(pmax)));
+    large_bound_ = integer_class(static_cast<unsigned long>(pmax)) * 64;
+
+    size_t needed = fb_.size() + 17;
+    // Relations with all factors in the factor base, and the ones left with
+    // one large prime, by that prime. Two of the latter with the same prime
+    // multiply to a relation.
+    std::vector<SiqsRelation> full;
+    std::map<integer_class, SiqsRelation> partial;
+    const int batch = 8;
+    while (true) {
+        while (full.size() < needed) {
+            std::vector<std::vector<unsigned>> as(batch);
+            for (auto &qs : as) {
+                if (not choose_a(qs))
+                    return false;
+            }
+            std::vector<std::vector<SiqsRelation>> found(batch);
+#pragma omp parallel for schedule(dynamic)
+            for (int i = 0; i < batch; i++) {
+                sieve_a(as[i], found[i]);
+            }
+            for (auto &rels : found) {
+                for (auto &rel : rels) {
+                    if (rel.large == 1) {
+                        full.push_back(std::move(rel));
+                        continue;
+                    }
+                    auto it = partial.find(rel.large);
+                    if (it == partial.end()) {
+                        const integer_class large = rel.large;
+                        partial.emplace(large, std::move(rel));
+                        continue;
+                    }
+                    if (proper_gcd(f, rel.large, n_))
+                        return true;
+                    rel.y *= it->second.y;
+                    rel.factors.insert(rel.factors.end(),
+                                       it->second.factors.begin(),
+                                       it->second.factors.end());
+                    full.push_back(std::move(rel));
+                }
+            }
+        }
+        if (find_factor(f, full))
+            return true;
+        // Very unlikely, all the dependencies were trivial
+        needed += 16;
+    }
+}
+} // namespace
+
+int factor_ecm(const Ptr<RCP<const Integer>> &f, const Integer &n,
+               unsigned B1, unsigned curves)
+{
+    const integer_class &_n = n.as_integer_class();
+    if (_n < 6 or B1 < 2)
+        throw SymEngineException(
+            "Require n > 5 and B1 > 1 to use the elliptic curve method");
+    const unsigned B2 = 100 * B1;
+    std::vector<unsigned> primes;
+    Sieve::generate_primes(primes, B2);
+    integer_class _f;
+    if (_n % 2 == 0) {
+        *f = integer(2);
+        return 1;
+    }
+    for (unsigned c = 0; c < curves; c++) {
+        // Suyama's parametrization needs sigma > 5
+        if (ecm_curve(_f, _n, 6 + 7919 * static_cast<unsigned long>(c), primes,
+                      B1, B2)) {
+            *f = integer(std::move(_f));
+            return 1;
+        }
+    }
+    return 0;
+}
+
+int factor_siqs(const Ptr<RCP<const Integer>> &f, const Integer &n)
+{
+    const integer_class &_n = n.as_integer_class();
+    if (_n < 2 or mp_probab_prime_p(_n, 25) > 0 or mp_perfect_power_p(_n))
+        throw SymEngineException("Require n to be composite and not a "
+                                 "perfect power to use the quadratic sieve");
+    // The logarithms of the primes are summed in bytes, which must not wrap
+    // around for the largest values, about M * sqrt(k * n / 2) < 2**221
+    if (_n >= integer_class(1) << siqs_max_bits)
+        throw SymEngineException("Require n < 2**400 to use the quadratic "
+                                 "sieve");
+    integer_class _f;
+    if (_n % 2 == 0) {
+        *f = integer(2);
+        return 1;
+    }
+    Siqs siqs(_n);
+    if (not siqs.run(_f))
+        return 0;
+    *f = integer(std::move(_f));
+    return 1;
+}
+
+} // namespace SymEngine
@@ -0,0 +1,517 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <symengine/numeric_matrix.h>
+#include <symengine/derivative.h>
+#include <symengine/eval_double.h>
+#include <symengine/real_double.h>
+#include <symengine/complex_double.h>
+
+#ifdef HAVE_SYMENGINE_BLAS
+extern "C" {
+void dgemm_(const char *transa, const char *transb, const int *m, const int *n,
+            const int *k, const double *alpha, const double *a, const int *lda,
+            const double *b, const int *ldb, const double *beta, double *c,
+            const int *ldc);
+void zgemm_(const char *transa, const char *transb, const int *m, const int *n,
+            const int *k, const std::complex<double> *alpha,
+            const std::complex<double> *a, const int *lda,
+            const std::complex<double> *b, const int *ldb,
+            const std::complex<double> *beta, std::complex<double> *c,
+            const int *ldc);
+}
+#endif
+
+namespace SymEngine
+{
+
+namespace
+{
+
+typedef std::complex<double> complex_t;
+
+inline double conjugate(double x)
+{
+    return x;
+}
+
+inline complex_t conjugate(const complex_t &x)
+{
+    return std::conj(x);
+}
+
+inline double to_real(double x)
+{
+    return x;
+}
+
+inline double to_real(const complex_t &x)
+{
+    return x.real();
+}
+
+template <typename T>
+T to_numeric(const Basic &b);
+
+template <>
+double to_numeric<double>(const Basic &b)
+{
+    if (is_a<RealDouble>(b)) {
+        return down_cast<const RealDouble &>(b).as_double();
+    }
+    if (not is_a_Number(b) and not free_symbols(b).empty()) {
+        throw SymEngineException("Matrix entries must be numbers");
+    }
+    return eval_double(b);
+}
+
+template <>
+complex_t to_numeric<complex_t>(const Basic &b)
+{
+    if (is_a<ComplexDouble>(b)) {
+        return down_cast<const ComplexDouble &>(b).as_complex_double();
+    }
+    if (not is_a_Number(b) and not free_symbols(b).empty()) {
+        throw SymEngineException("Matrix entries must be numbers");
+    }
+    return eval_complex_double(b);
+}
+
+inline RCP<const Basic> to_basic(double x)
+{
+    return real_double(x);
+}
+
+inline RCP<const Basic> to_basic(const complex_t &x)
+{
+    return complex_double(x);
+}
+
+// Side of the square blocks of the bundled matrix product
+const unsigned gemm_block_size = 64;
+
+// C += A B, all row major, A is m x k and B is k x n
+template <typename T>
+void gemm(unsigned m, unsigned n, unsigned k, const T *A, const T *B, T *C)
+{
+    for (unsigned i0 = 0; i0 < m; i0 += gemm_block_size) {
+        const unsigned i1 = std::min(i0 + gemm_block_size, m);
+        for (unsigned l0 = 0; l0 < k; l0 += gemm_block_size) {
+            const unsigned l1 = std::min(l0 + gemm_block_size, k);
+            for (unsigned j0 = 0; j0 < n; j0 += gemm_block_size) {
+                const unsigned j1 = std::min(j0 + gemm_block_size, n);
+                for (unsigned i = i0; i < i1; i++) {
+                    T *c = C + static_cast<size_t>(i) * n;
+                    for (unsigned l = l0; l < l1; l++) {
+                        const T a = A[static_cast<size_t>(i) * k + l];
+                        const T *b = B + static_cast<size_t>(l) * n;
+                        for (unsigned j = j0; j < j1; j++)
+                            c[j] += a * b[j];
+                    }
+                }
+            }
+        }
+    }
+}
+
+#ifdef HAVE_SYMENGINE_BLAS
+// The row major product C = A B is the column major product C^T = B^T A^T
+template <>
+void gemm<double>(unsigned m, unsigned n, unsigned k, const double *A,
+                  const double *B, double *C)
+{
+    const int m_ = m, n_ = n, k_ = k;
+    const double alpha = 1, beta = 1;
+    dgemm_("N", "N", &n_, &m_, &k_, &alpha, B, &n_, A, &k_, &beta, C, &n_);
+}
+
+template <>
+void gemm<complex_t>(unsigned m, unsigned n, unsigned k, const complex_t *A,
+                     const complex_t *B, complex_t *C)
+{
+    const int m_ = m, n_ = n, k_ = k;
+    const complex_t alpha = 1, beta = 1;
+    zgemm_("N", "N", &n_, &m_, &k_, &alpha, B, &n_, A, &k_, &beta, C, &n_);
+}
+#endif
+
+// Complex Givens rotation G = [[c, s], [-conj(s), c]] with G [a, b]^T having
+// a zero second component
+void givens(const complex_t &a, const complex_t &b, double &c, complex_t &s)
+{
+    const double aa = std::abs(a), r = std::hypot(aa, std::abs(b));
+    if (r == 0) {
+        c = 1;
+        s = 0;
+    } else if (aa == 0) {
+        c = 0;
+        s = 1;
+    } else {
+        c = aa / r;
+        s = (a / aa) * std::conj(b) / r;
+    }
+}
+
+// Eigenvalues of the n x n row major matrix H, which is overwritten
+std::vector<complex_t> hessenberg_qr(std::vector<complex_t> &H, unsigned n)
+{
+    auto h = [&](unsigned i, unsigned j) -> complex_t & {
+        return H[static_cast<size_t>(i) * n + j];
+    };
+    // Reduction to upper Hessenberg form by Householder similarities
+    std::vector<complex_t> v(n);
+    for (unsigned k = 0; k + 2 < n; k++) {
+        double norm = 0;
+        for (unsigned i = k + 1; i < n; i++)
+            norm += std::norm(h(i, k));
+        norm = std::sqrt(norm);
+        if (norm == 0)
+            continue;
+        const complex_t x0 = h(k + 1, k);
+        const complex_t alpha
+            = -(std::abs(x0) == 0 ? complex_t(1) : x0 / std::abs(x0)) * norm;
+        double vnorm = 0;
+        for (unsigned i = k + 1; i < n; i++) {
+            v[i] = h(i, k);
+            if (i == k + 1)
+                v[i] -= alpha;
+            vnorm += std::norm(v[i]);
+        }
+        if (vnorm == 0)
+            continue;
+        // H = (I - 2 v v^H / |v|^2) H (I - 2 v v^H / |v|^2)
+        for (unsigned j = k; j < n; j++) {
+            complex_t s = 0;
+            for (unsigned i = k + 1; i < n; i++)
+                s += std::conj(v[i]) * h(i, j);
+            s *= 2 / vnorm;
+            for (unsigned i = k + 1; i < n; i++)
+                h(i, j) -= s * v[i];
+        }
+        for (unsigned i = 0; i < n; i++) {
+            complex_t s = 0;
+            for (unsigned j = k + 1; j < n; j++)
+                s += h(i, j) * v[j];
+            s *= 2 / vnorm;
+            for (unsigned j = k + 1; j < n; j++)
+                h(i, j) -= s * std::conj(v[j]);
+        }
+        for (unsigned i = k + 2; i < n; i++)
+            h(i, k) = 0;
+    }
+
+    // Single shift QR iterations on the active block [lo, hi], deflating at
+    // negligible subdiagonal entries
+    std::vector<complex_t> eigs;
+    std::vector<double> cs(n);
+    std::vector<complex_t> ss(n);
+    const double eps = std::numeric_limits<double>::epsilon();
+    unsigned iter = 0;
+    for (unsigned hi = n; hi-- > 0;) {
+        while (true) {
+            unsigned lo = hi;
+            while (lo > 0
+                   and std::abs(h(lo, lo - 1))
+                           > eps * (std::abs(h(lo - 1, lo - 1))
+                                    + std::abs(h(lo, lo)))) {
+                lo--;
+            }
+            if (lo == hi) {
+                eigs.push_back(h(hi, hi));
+                iter = 0;
+                break;
+            }
+            if (++iter > 100 * n) {
+                throw SymEngineException("Eigenvalues did not converge");
+            }
+            // Wilkinson shift, an exceptional one now and then
+            const complex_t a = h(hi - 1, hi - 1), b = h(hi - 1, hi),
+                            c = h(hi, hi - 1), d = h(hi, hi);
+            complex_t mu;
+            if (iter % 11 == 10) {
+                mu = d + std::abs(c);
+            } else {
+                const complex_t t = (a + d) / 2.0;
+                const complex_t r = std::sqrt(t * t - (a * d - b * c));
+                mu = std::abs(t + r - d) < std::abs(t - r - d) ? t + r : t - r;
+            }
+            for (unsigned k = lo; k <= hi; k++)
+                h(k, k) -= mu;
+            for (unsigned k = lo; k < hi; k++) {
+                givens(h(k, k), h(k + 1, k), cs[k], ss[k]);
+                for (unsigned j = k; j <= hi; j++) {
+                    const complex_t x = h(k, j), y = h(k + 1, j);
+                    h(k, j) = cs[k] * x + ss[k] * y;
+                    h(k + 1, j) = -std::conj(ss[k]) * x + cs[k] * y;
+                }
+            }
+            for (unsigned k = lo; k < hi; k++) {
+                for (unsigned i = lo; i <= std::min(k + 1, hi); i++) {
+                    const complex_t x = h(i, k), y = h(i, k + 1);
+                    h(i, k) = x * cs[k] + y * std::conj(ss[k]);
+                    h(i, k + 1) = -x * ss[k] + y * cs[k];
+                }
+            }
+            for (unsigned k = lo; k <= hi; k++)
+                h(k, k) += mu;
+        }
+    }
+    std::reverse(eigs.begin(), eigs.end());
+    return eigs;
+}
+
+} // namespace
+
+template <typename T>
+NumericMatrix<T>::NumericMatrix(const DenseMatrix &A)
+    : m_(static_cast<size_t>(A.nrows()) * A.ncols()), row_(A.nrows()),
+      col_(A.ncols())
+{
+    for (unsigned i = 0; i < row_; i++) {
+        for (unsigned j = 0; j < col_; j++) {
+            (*this)(i, j) = to_numeric<T>(*A.get(i, j));
+        }
+    }
+}
+
+template <typename T>
+DenseMatrix NumericMatrix<T>::as_dense() const
+{
+    vec_basic l;
+    l.reserve(m_.size());
+    for (const auto &x : m_) {
+        l.push_back(to_basic(x));
+    }
+    return DenseMatrix(row_, col_, l);
+}
+
+template <typename T>
+NumericMatrix<T> NumericMatrix<T>::identity(unsigned n)
+{
+    NumericMatrix<T> I(n, n);
+    for (unsigned i = 0; i < n; i++)
+        I(i, i) = 1;
+    return I;
+}
+
+template <typename T>
+NumericMatrix<T> NumericMatrix<T>::transpose() const
+{
+    NumericMatrix<T> B(col_, row_);
+    for (unsigned i = 0; i < row_; i++) {
+        for (unsigned j = 0; j < col_; j++)
+            B(j, i) = (*this)(i, j);
+    }
+    return B;
+}
+
+template <typename T>
+NumericMatrix<T> NumericMatrix<T>::mul(const NumericMatrix<T> &B) const
+{
+    SYMENGINE_ASSERT(col_ == B.row_);
+    NumericMatrix<T> C(row_, B.col_);
+    if (C.m_.size() > 0 and col_ > 0) {
+        gemm(row_, B.col_, col_, data(), B.data(), C.data());
+    }
+    return C;
+}
+
+template <typename T>
+int NumericMatrix<T>::LU(NumericMatrix<T> &LU,
+                         std::vector<unsigned> &perm) const
+{
+    SYMENGINE_ASSERT(row_ == col_);
+    const unsigned n = row_;
+    LU = *this;
+    perm.resize(n);
+    for (unsigned i = 0; i < n; i++)
+        perm[i] = i;
+    int sign = 1;
+    for (unsigned k = 0; k < n; k++) {
+        unsigned p = k;
+        for (unsigned i = k + 1; i < n; i++) {
+            if (std::abs(LU(i, k)) > std::abs(LU(p, k)))
+                p = i;
+        }
+        if (p != k) {
+            std::swap_ranges(&LU(k, 0), &LU(k, 0) + n, &LU(p, 0));
+            std::swap(perm[k], perm[p]);
+            sign = -sign;
+        }
+        const T pivot = LU(k, k);
+        if (pivot == T(0))
+            continue;
+        for (unsigned i = k + 1; i < n; i++) {
+            const T l = LU(i, k) / pivot;
+            LU(i, k) = l;
+            if (l == T(0))
+                continue;
+            T *ri = &LU(i, 0);
+            const T *rk = &LU(k, 0);
+            for (unsigned j = k + 1; j < n; j++)
+                ri[j] -= l * rk[j];
+        }
+    }
+    return sign;
+}
+
+template <typename T>
+T NumericMatrix<T>::det() const
+{
+    NumericMatrix<T> F;
+    std::vector<unsigned> perm;
+    T d = T(LU(F, perm));
+    for (unsigned i = 0; i < row_; i++)
+        d *= F(i, i);
+    return d;
+}
+
+template <typename T>
+NumericMatrix<T> NumericMatrix<T>::solve(const NumericMatrix<T> &b) const
+{
+    SYMENGINE_ASSERT(row_ == col_ and b.row_ == row_);
+    const unsigned n = row_, m = b.col_;
+    NumericMatrix<T> F;
+    std::vector<unsigned> perm;
+    LU(F, perm);
+    for (unsigned i = 0; i < n; i++) {
+        if (F(i, i) == T(0))
+            throw SymEngineException("Matrix is singular");
+    }
+    NumericMatrix<T> x(n, m);
+    for (unsigned i = 0; i < n; i++) {
+        std::copy(&b(perm[i], 0), &b(perm[i], 0) + m, &x(i, 0));
+    }
+    // Forward substitution with L, then back substitution with U, the rows of
+    // x are updated as a whole
+    for (unsigned i = 0; i < n; i++) {
+        for (unsigned k = 0; k < i; k++) {
+            const T l = F(i, k);
+            for (unsigned j = 0; j < m; j++)
+                x(i, j) -= l * x(k, j);
+        }
+    }
+    for (unsigned i = n; i-- > 0;) {
+        for (unsigned k = i + 1; k < n; k++) {
+            const T u = F(i, k);
+            for (unsigned j = 0; j < m; j++)
+                x(i, j) -= u * x(k, j);
+        }
+        for (unsigned j = 0; j < m; j++)
+            x(i, j) /= F(i, i);
+    }
+    return x;
+}
+
+template <typename T>
+NumericMatrix<T> NumericMatrix<T>::inv() const
+{
+    return solve(identity(row_));
+}
+
+template <typename T>
+NumericMatrix<T> NumericMatrix<T>::cholesky() const
+{
+    SYMENGINE_ASSERT(row_ == col_);
+    const unsigned n = row_;
+    NumericMatrix<T> L(n, n);
+    for (unsigned j = 0; j < n; j++) {
+        double d = to_real((*this)(j, j));
+        for (unsigned k = 0; k < j; k++)
+            d -= std::norm(L(j, k));
+        if (not(d > 0))
+            throw SymEngineException("Matrix is not positive definite");
+        const double ljj = std::sqrt(d);
+        L(j, j) = ljj;
+        for (unsigned i = j + 1; i < n; i++) {
+            T s = (*this)(i, j);
+            for (unsigned k = 0; k < j; k++)
+                s -= L(i, k) * conjugate(L(j, k));
+            L(i, j) = s / ljj;
+        }
+    }
+    return L;
+}
+
+template <typename T>
+void NumericMatrix<T>::QR(NumericMatrix<T> &Q, NumericMatrix<T> &R) const
+{
+    const unsigned m = row_, n = col_;
+    R = *this;
+    Q = identity(m);
+    std::vector<T> v(m);
+    const unsigned steps = m > 0 ? std::min(m - 1, n) : 0;
+    for (unsigned k = 0; k < steps; k++) {
+        double norm = 0;
+        for (unsigned i = k; i < m; i++)
+            norm += std::norm(R(i, k));
+        norm = std::sqrt(norm);
+        if (norm == 0)
+            continue;
+        const T x0 = R(k, k);
+        const T alpha = -(std::abs(x0) == 0 ? T(1) : x0 / std::abs(x0)) * norm;
+        double vnorm = 0;
+        for (unsigned i = k; i < m; i++) {
+            v[i] = R(i, k);
+            if (i == k)
+                v[i] -= alpha;
+            vnorm += std::norm(v[i]);
+        }
+        if (vnorm == 0)
+            continue;
+        // R = H R and Q = Q H with H = I - 2 v v^H / |v|^2
+        for (unsigned j = k; j < n; j++) {
+            T s = 0;
+            for (unsigned i = k; i < m; i++)
+                s += conjugate(v[i]) * R(i, j);
+            s *= 2 / vnorm;
+            for (unsigned i = k; i < m; i++)
+                R(i, j) -= s * v[i];
+        }
+        for (unsigned i = k + 1; i < m; i++)
+            R(i, k) = 0;
+        for (unsigned i = 0; i < m; i++) {
+            T s = 0;
+            for (unsigned j = k; j < m; j++)
+                s += Q(i, j) * v[j];
+            s *= 2 / vnorm;
+            for (unsigned j = k; j < m; j++)
+                Q(i, j) -= s * conjugate(v[j]);
+        }
+    }
+}
+
+template <typename T>
+std::vector<complex_t> NumericMatrix<T>::eigenvalues() const
+{
+    SYMENGINE_ASSERT(row_ == col_);
+    std::vector<complex_t> H(m_.begin(), m_.end());
+    return hessenberg_qr(H, row_);
+}
+
+template class NumericMatrix<double>;
+template class NumericMatrix<complex_t>;
+
+LambdaJacobian::LambdaJacobian(const vec_basic &exprs, const vec_sym &x,
+                               bool cse)
+    : row_(static_cast<unsigned>(exprs.size())),
+      col_(static_cast<unsigned>(x.size()))
+{
+    vec_basic entries, inputs(x.begin(), x.end());
+    entries.reserve(static_cast<size_t>(row_) * col_);
+    for (const auto &e : exprs) {
+        vec_basic row = gradient(e, x);
+        entries.insert(entries.end(), row.begin(), row.end());
+    }
+    v_.init(inputs, entries, cse);
+}
+
+void LambdaJacobian::call(RealDoubleMatrix &J, const double *x)
+{
+    if (J.nrows() != row_ or J.ncols() != col_) {
+        J = RealDoubleMatrix(row_, col_);
+    }
+    v_.call(J.data(), x);
+}
+
+} // namespace SymEngine
@@ -0,0 +1,107 @@
+#ifndef SYMENGINE_NUMERIC_MATRIX_H
+#define SYMENGINE_NUMERIC_MATRIX_H
+
+#include <complex>
+#include <symengine/matrix.h>
+#include <symengine/lambda_double.h>
+
+namespace SymEngine
+{
+
+// Dense matrix of `double` or `std::complex<double>` entries stored
+// contiguously in row major order. It is meant for the numeric stages of a
+// computation, where boxing every entry in a `Basic` would dominate the cost.
+// The matrix product uses the system BLAS when SymEngine is built with it,
+// the factorizations use the bundled kernels.
+template <typename T>
+class NumericMatrix
+{
+public:
+    NumericMatrix() : row_(0), col_(0)
+    {
+    }
+    NumericMatrix(unsigned row, unsigned col)
+        : m_(static_cast<size_t>(row) * col, T(0)), row_(row), col_(col)
+    {
+    }
+    // Evaluates the entries of `A`, throws SymEngineException if one of them
+    // is not a number (or is not real for `NumericMatrix<double>`)
+    explicit NumericMatrix(const DenseMatrix &A);
+
+    // Converts back to a matrix of `RealDouble` (or `ComplexDouble`)
+    DenseMatrix as_dense() const;
+
+    unsigned nrows() const
+    {
+        return row_;
+    }
+    unsigned ncols() const
+    {
+        return col_;
+    }
+    T &operator()(unsigned i, unsigned j)
+    {
+        return m_[static_cast<size_t>(i) * col_ + j];
+    }
+    const T &operator()(unsigned i, unsigned j) const
+    {
+        return m_[static_cast<size_t>(i) * col_ + j];
+    }
+    T *data()
+    {
+        return m_.data();
+    }
+    const T *data() const
+    {
+        return m_.data();
+    }
+
+    static NumericMatrix identity(unsigned n);
+
+    NumericMatrix transpose() const;
+    NumericMatrix mul(const NumericMatrix &B) const;
+
+    // LU factorization with partial pivoting, P A = L U. `LU` holds U and
+    // the part of L below the diagonal (its diagonal is one), row `i` of
+    // P A is row `perm[i]` of A. Returns the sign of P.
+    int LU(NumericMatrix &LU, std::vector<unsigned> &perm) const;
+    T det() const;
+    // Solves A x = b for all the columns of `b`
+    NumericMatrix solve(const NumericMatrix &b) const;
+    NumericMatrix inv() const;
+    // Returns L such that A = L L^H, A must be Hermitian positive definite
+    NumericMatrix cholesky() const;
+    // Householder QR, A = Q R with Q unitary (nrows x nrows) and R upper
+    // triangular (nrows x ncols)
+    void QR(NumericMatrix &Q, NumericMatrix &R) const;
+    // Eigenvalues by Hessenberg reduction and shifted QR iterations
+    std::vector<std::complex<double>> eigenvalues() const;
+
+private:
+    std::vector<T> m_;
+    unsigned row_;
+    unsigned col_;
+};
+
+typedef NumericMatrix<double> RealDoubleMatrix;
+typedef NumericMatrix<std::complex<double>> ComplexDoubleMatrix;
+
+// Jacobian of a system of expressions, differentiated and compiled once and
+// then evaluated at points straight into a `RealDoubleMatrix`, without
+// creating any `Basic`
+class LambdaJacobian
+{
+public:
+    LambdaJacobian(const vec_basic &exprs, const vec_sym &x, bool cse = false);
+    // Evaluates the Jacobian at `x` into `J`, which is resized if needed
+    void call(RealDoubleMatrix &J, const double *x);
+
+private:
+    LambdaRealDoubleVisitor v_;
+    unsigned row_;
+    unsigned col_;
+};
+
+} // namespace SymEngine
+
+#endif
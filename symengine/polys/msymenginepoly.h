@@ -136,6 +136,18 @@ public:
         SYMENGINE_ASSERT(a.vec_size == b.vec_size)
 
         Wrapper p(a.vec_size);
+        // Multiply the monomials packed into machine words when the
+        // exponents of the product are small enough
+        PackedProduct<Dict> pp;
+        if (pp.init(a.dict_, b.dict_, a.vec_size)) {
+            typename PackedProduct<Dict>::packed_dict c;
+            pp.mul(0, pp.a.size(), c);
+#if defined(HAVE_SYMENGINE_RESERVE)
+            p.dict_.reserve(c.size());
+#endif
+            pp.unpack(c, p.dict_);
+            return p;
+        }
         for (auto const &a_ : a.dict_) {
             for (auto const &b_ : b.dict_) {
 
@@ -24,6 +24,317 @@ hash_t UIntPoly::__hash__() const
     return seed;
 }
 
+namespace
+{
+// Below these lengths the recursive kernels switch to the schoolbook one
+const size_t karatsuba_threshold = 16;
+const size_t toom3_threshold = 48;
+
+// Number of bits of the largest absolute value in `a`
+unsigned max_coef_bits(const vec_integer_class &a)
+{
+    integer_class m(0), t;
+    for (const auto &c : a) {
+        t = mp_abs(c);
+        if (t > m)
+            m = t;
+    }
+    unsigned bits = 0;
+    while (m > 4294967295u) {
+        m = m >> 32;
+        bits += 32;
+    }
+    while (m > 0) {
+        m = m >> 1;
+        bits++;
+    }
+    return bits;
+}
+
+vec_integer_class slice(const vec_integer_class &a, size_t begin, size_t end)
+{
+    begin = std::min(begin, a.size());
+    end = std::min(end, a.size());
+    return vec_integer_class(a.begin() + begin, a.begin() + end);
+}
+
+// r[i + offset] += s[i]
+void add_shifted(vec_integer_class &r, const vec_integer_class &s,
+                 size_t offset)
+{
+    if (r.size() < s.size() + offset)
+        r.resize(s.size() + offset);
+    for (size_t i = 0; i < s.size(); i++)
+        r[i + offset] += s[i];
+}
+
+// a + c * b, with the result as long as the longer operand
+vec_integer_class linear_comb(const vec_integer_class &a, long c,
+                              const vec_integer_class &b)
+{
+    vec_integer_class r(std::max(a.size(), b.size()));
+    for (size_t i = 0; i < a.size(); i++)
+        r[i] = a[i];
+    for (size_t i = 0; i < b.size(); i++)
+        r[i] += c * b[i];
+    return r;
+}
+
+// Multiplies `a` by `b` by pieces of `b.size()` coefficients of `a`, which
+// must be the longer operand. Each piece is multiplied by `kernel`.
+template <typename Kernel>
+vec_integer_class mul_unbalanced(const vec_integer_class &a,
+                                 const vec_integer_class &b, Kernel kernel)
+{
+    vec_integer_class r(a.size() + b.size() - 1);
+    for (size_t off = 0; off < a.size(); off += b.size())
+        add_shifted(r, kernel(slice(a, off, off + b.size()), b), off);
+    return r;
+}
+
+// a * 2**(N * i) summed over the coefficients a[begin:end]
+integer_class kronecker_pack(const vec_integer_class &a, size_t begin,
+                             size_t end, unsigned N)
+{
+    if (end - begin <= 8) {
+        integer_class r(0);
+        for (size_t i = end; i-- > begin;) {
+            r <<= N;
+            r += a[i];
+        }
+        return r;
+    }
+    size_t mid = begin + (end - begin) / 2;
+    integer_class r = kronecker_pack(a, mid, end, N);
+    r <<= N * (mid - begin);
+    r += kronecker_pack(a, begin, mid, N);
+    return r;
+}
+
+// Inverse of `kronecker_pack` for coefficients of less than N - 1 bits. The
+// lower half is the balanced residue modulo 2**(N * m), so the signs are
+// recovered without any carry propagation.
+void kronecker_unpack(integer_class &p, vec_integer_class &r, size_t begin,
+                      size_t end, unsigned N)
+{
+    if (end - begin == 1) {
+        r[begin] = p;
+        return;
+    }
+    size_t mid = begin + (end - begin) / 2;
+    unsigned long bits = static_cast<unsigned long>(N) * (mid - begin);
+    integer_class full(1), low;
+    full <<= bits;
+    mp_and(low, p, full - 1);
+    if (low >= (full >> 1))
+        low -= full;
+    p -= low;
+    p = p >> bits;
+    kronecker_unpack(low, r, begin, mid, N);
+    kronecker_unpack(p, r, mid, end, N);
+}
+} // namespace
+
+vec_integer_class mul_dense_schoolbook(const vec_integer_class &a,
+                                       const vec_integer_class &b)
+{
+    if (a.empty() or b.empty())
+        return vec_integer_class();
+    vec_integer_class r(a.size() + b.size() - 1);
+    for (size_t i = 0; i < a.size(); i++) {
+        if (a[i] == 0)
+            continue;
+        for (size_t j = 0; j < b.size(); j++)
+            mp_addmul(r[i + j], a[i], b[j]);
+    }
+    return r;
+}
+
+vec_integer_class mul_dense_karatsuba(const vec_integer_class &a,
+                                      const vec_integer_class &b)
+{
+    if (a.size() < b.size())
+        return mul_dense_karatsuba(b, a);
+    if (b.size() < karatsuba_threshold)
+        return mul_dense_schoolbook(a, b);
+    // a = a0 + a1 x**m, b = b0 + b1 x**m
+    const size_t m = (a.size() + 1) / 2;
+    if (b.size() <= m)
+        return mul_unbalanced(a, b, mul_dense_karatsuba);
+    vec_integer_class a0 = slice(a, 0, m), a1 = slice(a, m, a.size());
+    vec_integer_class b0 = slice(b, 0, m), b1 = slice(b, m, b.size());
+    vec_integer_class z0 = mul_dense_karatsuba(a0, b0);
+    vec_integer_class z2 = mul_dense_karatsuba(a1, b1);
+    vec_integer_class z1 = mul_dense_karatsuba(linear_comb(a0, 1, a1),
+                                               linear_comb(b0, 1, b1));
+    for (size_t i = 0; i < z0.size(); i++)
+        z1[i] -= z0[i];
+    for (size_t i = 0; i < z2.size(); i++)
+        z1[i] -= z2[i];
+
+    vec_integer_class r = std::move(z0);
+    r.resize(a.size() + b.size() - 1);
+    add_shifted(r, z1, m);
+    add_shifted(r, z2, 2 * m);
+    r.resize(a.size() + b.size() - 1);
+    return r;
+}
+
+vec_integer_class mul_dense_toom3(const vec_integer_class &a,
+                                  const vec_integer_class &b)
+{
+    if (a.size() < b.size())
+        return mul_dense_toom3(b, a);
+    if (b.size() < toom3_threshold)
+        return mul_dense_karatsuba(a, b);
+    // a = a0 + a1 y + a2 y**2 with y = x**k, the same for b
+    const size_t k = (a.size() + 2) / 3;
+    if (b.size() <= 2 * k)
+        return mul_unbalanced(a, b, mul_dense_toom3);
+    vec_integer_class a0 = slice(a, 0, k), a1 = slice(a, k, 2 * k),
+                      a2 = slice(a, 2 * k, a.size());
+    vec_integer_class b0 = slice(b, 0, k), b1 = slice(b, k, 2 * k),
+                      b2 = slice(b, 2 * k, b.size());
+
+    // Values at 0, 1, -1, -2 and infinity
+    vec_integer_class a02 = linear_comb(a0, 1, a2),
+                      b02 = linear_comb(b0, 1, b2);
+    vec_integer_class am1 = linear_comb(a02, -1, a1),
+                      bm1 = linear_comb(b02, -1, b1);
+    vec_integer_class am2 = linear_comb(linear_comb(a0, 4, a2), -2, a1),
+                      bm2 = linear_comb(linear_comb(b0, 4, b2), -2, b1);
+    vec_integer_class r0 = mul_dense_toom3(a0, b0);
+    vec_integer_class r1 = mul_dense_toom3(linear_comb(a02, 1, a1),
+                                           linear_comb(b02, 1, b1));
+    vec_integer_class rm1 = mul_dense_toom3(am1, bm1);
+    vec_integer_class rm2 = mul_dense_toom3(am2, bm2);
+    vec_integer_class rinf = mul_dense_toom3(a2, b2);
+
+    // Interpolation sequence of Bodrato and Zanoni
+    const size_t len = 2 * k - 1;
+    r0.resize(len);
+    r1.resize(len);
+    rm1.resize(len);
+    rm2.resize(len);
+    rinf.resize(len);
+    vec_integer_class r2(len), r3(len);
+    const integer_class two(2), three(3);
+    for (size_t i = 0; i < len; i++) {
+        mp_divexact(r3[i], rm2[i] - r1[i], three);
+        mp_divexact(r1[i], r1[i] - rm1[i], two);
+        r2[i] = rm1[i] - r0[i];
+        mp_divexact(r3[i], r2[i] - r3[i], two);
+        r3[i] += 2 * rinf[i];
+        r2[i] += r1[i] - rinf[i];
+        r1[i] -= r3[i];
+    }
+
+    vec_integer_class r = std::move(r0);
+    r.resize(a.size() + b.size() - 1);
+    add_shifted(r, r1, k);
+    add_shifted(r, r2, 2 * k);
+    add_shifted(r, r3, 3 * k);
+    add_shifted(r, rinf, 4 * k);
+    r.resize(a.size() + b.size() - 1);
+    return r;
+}
+
+vec_integer_class mul_dense_kronecker(const vec_integer_class &a,
+                                      const vec_integer_class &b)
+{
+    if (a.empty() or b.empty())
+        return vec_integer_class();
+    // Each coefficient of the product is a sum of at most min(len) products,
+    // one more bit holds the sign
+    const unsigned N
+        = bit_length(std::min(a.size(), b.size())) + max_coef_bits(a)
+          + max_coef_bits(b) + 1;
+    integer_class p = kronecker_pack(a, 0, a.size(), N);
+    if (&a == &b) {
+        p *= p;
+    } else {
+        p *= kronecker_pack(b, 0, b.size(), N);
+    }
+    vec_integer_class r(a.size() + b.size() - 1);
+    kronecker_unpack(p, r, 0, r.size(), N);
+    return r;
+}
+
+vec_integer_class mul_dense_upoly(const vec_integer_class &a,
+                                  const vec_integer_class &b)
+{
+    const size_t n = std::min(a.size(), b.size());
+    if (n < karatsuba_threshold)
+        return mul_dense_schoolbook(a, b);
+#if SYMENGINE_INTEGER_CLASS == SYMENGINE_BOOSTMP
+    // Without subquadratic integer multiplication packing gains nothing
+    return mul_dense_toom3(a, b);
+#else
+    // Packing and unpacking dominate for short polynomials with small
+    // coefficients, otherwise one big integer product beats the recursive
+    // kernels at every size measured
+    if (n < 64 and std::max(max_coef_bits(a), max_coef_bits(b)) < 512)
+        return mul_dense_schoolbook(a, b);
+    return mul_dense_kronecker(a, b);
+#endif
+}
+
+vec_integer_class mullow_dense_upoly(const vec_integer_class &a,
+                                     const vec_integer_class &b, size_t n)
+{
+    if (a.empty() or b.empty() or n == 0)
+        return vec_integer_class();
+    n = std::min(n, a.size() + b.size() - 1);
+    if (a.size() > n or b.size() > n)
+        return mullow_dense_upoly(slice(a, 0, n), slice(b, 0, n), n);
+    const size_t m = std::min(a.size(), b.size());
+#if SYMENGINE_INTEGER_CLASS == SYMENGINE_BOOSTMP
+    const bool schoolbook = m < karatsuba_threshold;
+#else
+    const bool schoolbook
+        = m < karatsuba_threshold
+          or (m < 64 and std::max(max_coef_bits(a), max_coef_bits(b)) < 512);
+#endif
+    if (schoolbook) {
+        // Only the pairs with i + j < n
+        vec_integer_class r(n);
+        for (size_t i = 0; i < a.size(); i++) {
+            if (a[i] == 0)
+                continue;
+            for (size_t j = 0; j < b.size() and i + j < n; j++)
+                mp_addmul(r[i + j], a[i], b[j]);
+        }
+        return r;
+    }
+#if SYMENGINE_INTEGER_CLASS == SYMENGINE_BOOSTMP
+    vec_integer_class r = mul_dense_toom3(a, b);
+    r.resize(n);
+    return r;
+#else
+    // The integer product is computed in full, as there is no short integer
+    // product, but only the low n coefficients are unpacked
+    const unsigned N = bit_length(m) + max_coef_bits(a) + max_coef_bits(b) + 1;
+    integer_class p = kronecker_pack(a, 0, a.size(), N);
+    if (&a == &b) {
+        p *= p;
+    } else {
+        p *= kronecker_pack(b, 0, b.size(), N);
+    }
+    vec_integer_class r(n);
+    if (n < a.size() + b.size() - 1) {
+        // The balanced residue modulo 2**(N * n)
+        integer_class full(1), low;
+        full <<= static_cast<unsigned long>(N) * n;
+        mp_and(low, p, full - 1);
+        if (low >= (full >> 1))
+            low -= full;
+        p = std::move(low);
+    }
+    kronecker_unpack(p, r, 0, n, N);
+    return r;
+#endif
+}
+
 bool divides_upoly(const UIntPoly &a, const UIntPoly &b,
                    const Ptr<RCP<const UIntPoly>> &out)
 {
@@ -9,7 +9,7 @@
 
 namespace SymEngine
 {
-// Calculates bit length of number, used in UIntDict*= only
+// Calculates bit length of number, used in mul_dense_kronecker only
 template <typename T>
 unsigned int bit_length(T t)
 {
@@ -21,6 +21,26 @@ unsigned int bit_length(T t)
     return count;
 }
 
+//! Products of dense coefficient vectors, the i-th entry being the
+//! coefficient of x**i. `mul_dense_upoly` chooses between the kernels from
+//! the lengths and the coefficient sizes.
+vec_integer_class mul_dense_upoly(const vec_integer_class &a,
+                                  const vec_integer_class &b);
+vec_integer_class mul_dense_schoolbook(const vec_integer_class &a,
+                                       const vec_integer_class &b);
+vec_integer_class mul_dense_karatsuba(const vec_integer_class &a,
+                                      const vec_integer_class &b);
+vec_integer_class mul_dense_toom3(const vec_integer_class &a,
+                                  const vec_integer_class &b);
+//! Kronecker substitution: the coefficients are packed into one big integer
+//! each, which are multiplied once
+vec_integer_class mul_dense_kronecker(const vec_integer_class &a,
+                                      const vec_integer_class &b);
+//! The coefficients of x**0, ..., x**(n - 1) of the product, without the
+//! products of the coefficients that only contribute to the higher powers
+vec_integer_class mullow_dense_upoly(const vec_integer_class &a,
+                                     const vec_integer_class &b, size_t n);
+
 class UIntDict : public ODictWrapper<unsigned int, integer_class, UIntDict>
 {
 
@@ -64,43 +84,37 @@ public:
         return result;
     }
 
+    //! Dense products go through `mul_dense_upoly`, products with fewer
+    //! term pairs than output coefficients stay sparse
     static UIntDict mul(const UIntDict &a, const UIntDict &b)
     {
-        int mul = 1;
-
-        unsigned int N = bit_length(std::min(a.degree() + 1, b.degree() + 1))
-                         + bit_length(a.max_abs_coef())
-                         + bit_length(b.max_abs_coef());
-
-        integer_class full = integer_class(1), temp, res;
-        full <<= N;
-        integer_class thresh = full / 2;
-        integer_class mask = full - 1;
-        integer_class s_val = a.eval_bit(N) * b.eval_bit(N);
-        if (s_val < 0)
-            mul = -1;
-        s_val = mp_abs(s_val);
-
-        unsigned int deg = 0, carry = 0;
-        UIntDict r;
-
-        while (s_val != 0 or carry != 0) {
-            mp_and(temp, s_val, mask);
-            if (temp < thresh) {
-                res = mul * (temp + carry);
-                if (res != 0)
-                    r.dict_[deg] = res;
-                carry = 0;
-            } else {
-                res = mul * (temp - full + carry);
-                if (res != 0)
-                    r.dict_[deg] = res;
-                carry = 1;
-            }
-            s_val >>= N;
-            deg++;
+        if (a.empty() or b.empty())
+            return UIntDict();
+        const size_t len = a.degree() + b.degree() + 1;
+        if (a.size() * b.size() <= len) {
+            return ODictWrapper::mul(a, b);
+        }
+        vec_integer_class va = a.to_dense(), r;
+        if (&a == &b) {
+            r = mul_dense_upoly(va, va);
+        } else {
+            r = mul_dense_upoly(va, b.to_dense());
+        }
+        UIntDict p;
+        for (unsigned i = 0; i < r.size(); i++) {
+            if (r[i] != 0)
+                p.dict_.emplace_hint(p.dict_.end(), i, std::move(r[i]));
         }
-        return r;
+        return p;
+    }
+
+    //! Coefficients of x**0 to x**degree()
+    vec_integer_class to_dense() const
+    {
+        vec_integer_class v(dict_.empty() ? 0 : degree() + 1);
+        for (const auto &it : dict_)
+            v[it.first] = it.second;
+        return v;
     }
 
     int compare(const UIntDict &other) const
@@ -13,7 +13,7 @@ Pow::Pow(const RCP<const Basic> &base, const RCP<const Basic> &exp)
     SYMENGINE_ASSERT(is_canonical(*base, *exp))
 }
 
-bool Pow::is_canonical(const Basic &base, const Basic &exp) const
+bool Pow::is_canonical(const Basic &base, const Basic &exp)
 {
     // e.g. 0**x
     if (is_a<Integer>(base) and down_cast<const Integer &>(base).is_zero()) {
@@ -32,7 +32,7 @@ public:
     virtual bool __eq__(const Basic &o) const;
     virtual int compare(const Basic &o) const;
     //! \return `true` if canonical
-    bool is_canonical(const Basic &base, const Basic &exp) const;
+    static bool is_canonical(const Basic &base, const Basic &exp);
     //! \return `base` of `base**exp`
     inline RCP<const Basic> get_base() const
     {
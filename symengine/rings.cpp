@@ -1,5 +1,9 @@
+#include <algorithm>
+
 #include <symengine/add.h>
 #include <symengine/pow.h>
+#include <symengine/mul.h>
+#include <symengine/rational.h>
 #include <symengine/rings.h>
 #include <symengine/monomials.h>
 #include <symengine/symengine_exception.h>
@@ -7,71 +11,250 @@
 namespace SymEngine
 {
 
+namespace
+{
+
+// Exponents are limited so that the sum of two of them cannot overflow.
+const long max_poly_exp = 1L << 20;
+
+bool get_poly_exp(const Integer &i, int &e)
+{
+    if (not mp_fits_slong_p(i.as_integer_class()))
+        return false;
+    long l = i.as_int();
+    if (l >= max_poly_exp or l <= -max_poly_exp)
+        return false;
+    e = static_cast<int>(l);
+    return true;
+}
+
+// Writes the factor `base**exp` of a term as `gen**e` with an integer `e`.
+// A positive Integer base with a Rational exponent p/q is written as
+// (base**(1/q))**p, so that surds like `sqrt(3)` are generators too.
+bool factor_gen_exp(const RCP<const Basic> &base, const RCP<const Basic> &exp,
+                    RCP<const Basic> &gen, int &e)
+{
+    if (is_a<Integer>(*exp)) {
+        if (is_a_Number(*base) or is_a<Add>(*base))
+            return false;
+        gen = base;
+        return get_poly_exp(down_cast<const Integer &>(*exp), e);
+    }
+    if (is_a<Rational>(*exp) and is_a<Integer>(*base)
+        and down_cast<const Integer &>(*base).is_positive()) {
+        const rational_class &r
+            = down_cast<const Rational &>(*exp).as_rational_class();
+        Integer num(get_num(r));
+        if (not get_poly_exp(num, e))
+            return false;
+        gen = make_rcp<const Pow>(base, Rational::from_mpq(rational_class(
+                                            integer_class(1), get_den(r))));
+        return true;
+    }
+    return false;
+}
+
+// Appends the generators of the monomial `term` (as found in the dictionary
+// of an Add) and their exponents to `v`.
+bool term_gens(const RCP<const Basic> &term,
+               std::vector<std::pair<RCP<const Basic>, int>> &v)
+{
+    RCP<const Basic> gen;
+    int e;
+    if (is_a<Mul>(*term)) {
+        for (const auto &q : down_cast<const Mul &>(*term).get_dict()) {
+            if (not factor_gen_exp(q.first, q.second, gen, e))
+                return false;
+            v.push_back({gen, e});
+        }
+    } else if (is_a<Pow>(*term)) {
+        const Pow &t = down_cast<const Pow &>(*term);
+        if (not factor_gen_exp(t.get_base(), t.get_exp(), gen, e))
+            return false;
+        v.push_back({gen, e});
+    } else if (is_a_Number(*term) or is_a<Add>(*term)) {
+        return false;
+    } else {
+        v.push_back({term, 1});
+    }
+    return true;
+}
+
+} // namespace
+
+bool poly_gens(const RCP<const Basic> &p, umap_basic_num &gens)
+{
+    if (not is_a<Add>(*p))
+        return false;
+    const Add &a = down_cast<const Add &>(*p);
+    if (not is_a<Integer>(*a.get_coef()))
+        return false;
+    std::vector<std::pair<RCP<const Basic>, int>> v;
+    for (const auto &q : a.get_dict()) {
+        if (not is_a<Integer>(*q.second))
+            return false;
+        v.clear();
+        if (not term_gens(q.first, v))
+            return false;
+        for (const auto &g : v) {
+            if (gens.find(g.first) == gens.end())
+                insert(gens, g.first, integer(gens.size()));
+        }
+    }
+    return true;
+}
+
 void expr2poly(const RCP<const Basic> &p, umap_basic_num &syms, umap_vec_mpz &P)
 {
     if (is_a<Add>(*p)) {
         auto n = syms.size();
-        const umap_basic_num &d = down_cast<const Add &>(*p).get_dict();
+        const Add &a = down_cast<const Add &>(*p);
         vec_int exp;
-        integer_class coef;
-        for (const auto &p : d) {
-            if (not is_a<Integer>(*p.second))
+        if (not a.get_coef()->is_zero()) {
+            if (not is_a<Integer>(*a.get_coef()))
                 throw NotImplementedError("Not Implemented");
-            coef = down_cast<const Integer &>(*p.second).as_integer_class();
+            exp.assign(n, 0);
+            P[exp] = down_cast<const Integer &>(*a.get_coef())
+                         .as_integer_class();
+        }
+        std::vector<std::pair<RCP<const Basic>, int>> v;
+        for (const auto &q : a.get_dict()) {
+            if (not is_a<Integer>(*q.second))
+                throw NotImplementedError("Not Implemented");
+            v.clear();
+            if (not term_gens(q.first, v))
+                throw SymEngineException("Cannot convert " + q.first->__str__()
+                                         + " to a sparse polynomial with "
+                                           "integer exponents.");
             exp.assign(n, 0); // Initialize to [0]*n
-            if (is_a<Mul>(*p.first)) {
-                const map_basic_basic &term
-                    = down_cast<const Mul &>(*p.first).get_dict();
-                for (const auto &q : term) {
-                    RCP<const Basic> sym = q.first;
-                    if (not is_a<Integer>(*syms.at(sym)))
-                        throw NotImplementedError("Not Implemented");
-                    int i = numeric_cast<int>(
-                        down_cast<const Integer &>(*syms.at(sym)).as_int());
-                    if (is_a<Integer>(*q.second)) {
-                        exp[i] = numeric_cast<int>(
-                            down_cast<const Integer &>(*q.second).as_int());
-                    } else {
-                        throw SymEngineException(
-                            "Cannot convert symbolic exponents to sparse "
-                            "polynomials with integer exponents.");
-                    }
-                }
-            } else if (is_a<Pow>(*p.first)) {
-                RCP<const Basic> sym
-                    = down_cast<const Pow &>(*p.first).get_base();
-                RCP<const Basic> exp_
-                    = down_cast<const Pow &>(*p.first).get_exp();
-                if (not is_a<Integer>(*syms.at(sym)))
-                    throw NotImplementedError("Not Implemented");
-                int i = numeric_cast<int>(
-                    down_cast<const Integer &>(*syms.at(sym)).as_int());
-                if (not is_a<Integer>(*exp_))
-                    throw NotImplementedError("Not Implemented");
-                exp[i] = numeric_cast<int>(
-                    down_cast<const Integer &>(*exp_).as_int());
-            } else if (is_a<Symbol>(*p.first)) {
-                RCP<const Basic> sym = p.first;
-                if (not is_a<Integer>(*syms.at(sym)))
+            for (const auto &g : v) {
+                const RCP<const Number> &i = syms.at(g.first);
+                if (not is_a<Integer>(*i))
                     throw NotImplementedError("Not Implemented");
-                int i = numeric_cast<int>(
-                    down_cast<const Integer &>(*syms.at(sym)).as_int());
-                exp[i] = 1;
-            } else {
-                throw NotImplementedError("Not Implemented");
+                exp[numeric_cast<int>(
+                    down_cast<const Integer &>(*i).as_int())] += g.second;
             }
-
-            P[exp] = coef;
+            P[exp] = down_cast<const Integer &>(*q.second).as_integer_class();
         }
     } else {
         throw NotImplementedError("Not Implemented");
     }
 }
 
-void poly_mul(const umap_vec_mpz &A, const umap_vec_mpz &B, umap_vec_mpz &C)
+RCP<const Basic> poly2expr(const umap_vec_mpz &P, const vec_basic &gens)
 {
-    vec_int exp;
+    umap_basic_num d;
+    RCP<const Number> coef = zero;
+    for (const auto &t : P) {
+        if (t.second == 0)
+            continue;
+        RCP<const Number> c = integer(t.second);
+        map_basic_basic m;
+        for (size_t i = 0; i < gens.size(); i++) {
+            if (t.first[i] == 0)
+                continue;
+            const RCP<const Basic> &g = gens[i];
+            if (is_a<Pow>(*g)
+                and is_a_Number(*down_cast<const Pow &>(*g).get_base())) {
+                // (base**(1/q))**e, the integer part of the exponent goes
+                // into the coefficient
+                const Pow &s = down_cast<const Pow &>(*g);
+                Mul::dict_add_term_new(
+                    outArg(c), m,
+                    mulnum(rcp_static_cast<const Number>(s.get_exp()),
+                           integer(t.first[i])),
+                    s.get_base());
+            } else {
+                insert(m, g, integer(t.first[i]));
+            }
+        }
+        Add::coef_dict_add_term(outArg(coef), d, c,
+                                Mul::from_dict(one, std::move(m)));
+    }
+    return Add::from_dict(coef, std::move(d));
+}
+
+namespace
+{
+
+// Adds `src` into `dst`, leaving `src` empty
+template <typename Dict>
+void poly_add_to(Dict &dst, Dict &src)
+{
+    if (dst.size() < src.size())
+        std::swap(dst, src);
+    for (auto &t : src)
+        dst[t.first] += t.second;
+    src.clear();
+}
+
+// Calls `mul_range(begin, end, P)` for `num_threads` contiguous ranges of
+// `[0, n)` and adds the partial products to `C`. Every thread multiplies
+// into its own polynomial, the partial products are then summed pairwise in
+// a tree. The coefficients are integers, so the result does not depend on
+// the number of threads.
+template <typename Dict, typename F>
+void split_mul(size_t n, unsigned num_threads, Dict &C, F mul_range)
+{
+    int nt = static_cast<int>(std::min<size_t>(num_threads, n));
+    if (nt <= 1) {
+        mul_range(0, n, C);
+        return;
+    }
+    std::vector<Dict> parts(nt);
+    parts[0].swap(C);
+#pragma omp parallel for num_threads(nt) schedule(static, 1)
+    for (int k = 0; k < nt; k++) {
+        mul_range(n * k / nt, n * (k + 1) / nt, parts[k]);
+    }
+    for (int step = 1; step < nt; step *= 2) {
+#pragma omp parallel for num_threads(nt) schedule(static, 1)
+        for (int k = 0; k < nt - step; k += 2 * step) {
+            poly_add_to(parts[k], parts[k + step]);
+        }
+    }
+    C.swap(parts[0]);
+}
+
+} // namespace
+
+void poly_mul(const umap_vec_mpz &A, const umap_vec_mpz &B, umap_vec_mpz &C,
+              unsigned num_threads)
+{
+    if (A.empty() or B.empty())
+        return;
     auto n = A.begin()->first.size();
+    // The monomials are multiplied packed into two words if the exponents
+    // of the product are small enough, which is the common case.
+    typedef PackedProduct<umap_vec_mpz> Product;
+    Product pp;
+    if (pp.init(A, B, numeric_cast<unsigned>(n))) {
+        Product::packed_dict P;
+        split_mul(pp.a.size(), num_threads, P,
+                  [&pp](size_t begin, size_t end, Product::packed_dict &D) {
+                      pp.mul(begin, end, D);
+                  });
+        pp.unpack(P, C);
+        return;
+    }
+    if (num_threads > 1) {
+        std::vector<const umap_vec_mpz::value_type *> a;
+        a.reserve(A.size());
+        for (const auto &t : A)
+            a.push_back(&t);
+        split_mul(a.size(), num_threads, C,
+                  [&a, &B, n](size_t begin, size_t end, umap_vec_mpz &D) {
+                      vec_int exp(n, 0);
+                      for (size_t i = begin; i < end; i++) {
+                          for (const auto &b : B) {
+                              monomial_mul(a[i]->first, b.first, exp);
+                              mp_addmul(D[exp], a[i]->second, b.second);
+                          }
+                      }
+                  });
+        return;
+    }
+    vec_int exp;
     exp.assign(n, 0); // Initialize to [0]*n
     /*
     std::cout << "A: " << A.load_factor() << " " << A.bucket_count() << " " <<
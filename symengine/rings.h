@@ -11,12 +11,27 @@
 namespace SymEngine
 {
 
+/*! Collects the generators of the expanded expression `p` into `gens`,
+    numbering the new ones after the existing ones. The generators are the
+    bases with integer exponents and the surds `n**(1/q)` of positive
+    integers `n`.
+    \return false if `p` is not an Add with integer coefficients in such
+    generators.
+*/
+bool poly_gens(const RCP<const Basic> &p, umap_basic_num &gens);
+
 //! Converts expression `p` into a polynomial `P`, with symbols `sym`
 void expr2poly(const RCP<const Basic> &p, umap_basic_num &syms,
                umap_vec_mpz &P);
 
-//! Multiply two polynomials: `C = A*B`
-void poly_mul(const umap_vec_mpz &A, const umap_vec_mpz &B, umap_vec_mpz &C);
+//! Converts the polynomial `P` in the generators `gens` into an expression
+RCP<const Basic> poly2expr(const umap_vec_mpz &P, const vec_basic &gens);
+
+/*! Multiply two polynomials: `C = A*B`. The terms of `A` are split between
+    `num_threads` OpenMP threads.
+*/
+void poly_mul(const umap_vec_mpz &A, const umap_vec_mpz &B, umap_vec_mpz &C,
+              unsigned num_threads = 1);
 
 } // SymEngine
 
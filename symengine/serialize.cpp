@@ -0,0 +1,737 @@
+/**
+ *  \file serialize.cpp
+ *  Binary serialization of expressions, see `Basic::dumps()`
+ *
+ **/
+
+#include <cstring>
+#include <iterator>
+#include <limits>
+#include <unordered_map>
+
+#include <symengine/visitor.h>
+
+namespace SymEngine
+{
+
+/*
+   The format is the magic string "SyEn", the format version and the nodes of
+   the expression in post order, the root coming last. All the unsigned
+   numbers are LEB128 varints. Every node is written once, as its type code
+   (from type_codes.inc) followed by its data. The children are referred to
+   by the index of their node, so shared subexpressions are stored only
+   once:
+
+       Integer             0 and the zigzag encoded value if it fits in 64
+                           bits, else 1 (positive) or 2 (negative), the
+                           number of 64 bit words and the words, least
+                           significant first
+       Rational, Complex   integers: numerator and denominator of each part
+       RealDouble          8 bytes, the IEEE 754 representation
+       ComplexDouble       the real and imaginary parts as RealDouble
+       Symbol, Constant    the name: its length and the bytes
+       Dummy               the name and a number, the same for equal dummies
+       Add                 coefficient, number of terms, (term, coefficient)
+       Mul                 coefficient, number of factors, (base, exponent)
+       FunctionSymbol      the name, number of arguments, arguments
+       Interval            start, end, 1 byte of flags (1: left open,
+                           2: right open)
+       BooleanAtom         1 byte
+       Derivative, Subs    the argument followed by the symbols or the
+                           (old, new) pairs
+       Piecewise           number of pieces, (expression, condition)
+
+   and the other nodes store the number of children and the children.
+
+   The version must be increased whenever the format or type_codes.inc
+   changes.
+*/
+
+namespace
+{
+
+// The functions, stored as their arguments and rebuilt with the functions
+// creating them
+#define SYMENGINE_ONE_ARG_FUNCTIONS(F)                                         \
+    F(SIGN, sign) F(FLOOR, floor) F(CEILING, ceiling)                          \
+    F(CONJUGATE, conjugate) F(SIN, sin) F(COS, cos) F(TAN, tan) F(COT, cot)    \
+    F(CSC, csc) F(SEC, sec) F(ASIN, asin) F(ACOS, acos) F(ASEC, asec)          \
+    F(ACSC, acsc) F(ATAN, atan) F(ACOT, acot) F(LOG, log)                      \
+    F(LAMBERTW, lambertw) F(DIRICHLET_ETA, dirichlet_eta) F(SINH, sinh)        \
+    F(CSCH, csch) F(COSH, cosh) F(SECH, sech) F(TANH, tanh) F(COTH, coth)      \
+    F(ASINH, asinh) F(ACSCH, acsch) F(ACOSH, acosh) F(ATANH, atanh)            \
+    F(ACOTH, acoth) F(ASECH, asech) F(ERF, erf) F(ERFC, erfc)                  \
+    F(GAMMA, gamma) F(LOGGAMMA, loggamma) F(ABS, abs)
+#define SYMENGINE_TWO_ARG_FUNCTIONS(F)                                         \
+    F(ATAN2, atan2) F(ZETA, zeta) F(KRONECKERDELTA, kronecker_delta)           \
+    F(LOWERGAMMA, lowergamma) F(UPPERGAMMA, uppergamma) F(BETA, beta)          \
+    F(POLYGAMMA, polygamma)
+#define SYMENGINE_MULTI_ARG_FUNCTIONS(F)                                       \
+    F(LEVICIVITA, levi_civita) F(MAX, max) F(MIN, min)
+
+const char magic[] = "SyEn";
+const unsigned version = 1;
+
+class BinaryWriter
+{
+private:
+    std::string &out_;
+    std::unordered_map<const Basic *, unsigned long> index_;
+    // Equal dummies are not always the same object, they are numbered by
+    // their index
+    std::unordered_map<size_t, unsigned long> dummies_;
+
+    static void put_uint(std::string &s, uint64_t n)
+    {
+        while (n >= 0x80) {
+            s.push_back(static_cast<char>((n & 0x7f) | 0x80));
+            n >>= 7;
+        }
+        s.push_back(static_cast<char>(n));
+    }
+
+    static void put_string(std::string &s, const std::string &str)
+    {
+        put_uint(s, str.size());
+        s.append(str);
+    }
+
+    static void put_word(std::string &s, uint64_t w)
+    {
+        for (unsigned i = 0; i < 8; i++) {
+            s.push_back(static_cast<char>(w & 0xff));
+            w >>= 8;
+        }
+    }
+
+    static void put_double(std::string &s, double d)
+    {
+        uint64_t w;
+        std::memcpy(&w, &d, sizeof(w));
+        put_word(s, w);
+    }
+
+    static void put_integer(std::string &s, const integer_class &i)
+    {
+        if (mp_fits_slong_p(i)) {
+            const int64_t v = mp_get_si(i);
+            s.push_back(0);
+            put_uint(s, (static_cast<uint64_t>(v) << 1)
+                            ^ static_cast<uint64_t>(v < 0 ? -1 : 0));
+            return;
+        }
+        s.push_back(mp_sign(i) > 0 ? 1 : 2);
+        std::vector<uint64_t> words;
+#if SYMENGINE_INTEGER_CLASS == SYMENGINE_BOOSTMP
+        boost::multiprecision::export_bits(mp_abs(i),
+                                           std::back_inserter(words), 64,
+                                           false);
+#else
+        size_t count;
+        words.resize((mpz_sizeinbase(get_mpz_t(i), 2) + 63) / 64);
+        mpz_export(words.data(), &count, -1, sizeof(uint64_t), 0, 0,
+                   get_mpz_t(i));
+        words.resize(count);
+#endif
+        put_uint(s, words.size());
+        for (uint64_t w : words) {
+            put_word(s, w);
+        }
+    }
+
+    static void put_rational(std::string &s, const rational_class &q)
+    {
+        put_integer(s, get_num(q));
+        put_integer(s, get_den(q));
+    }
+
+    // Writes `b` if needed and appends its index to `s`
+    void put_ref(std::string &s, const Basic &b)
+    {
+        auto it = index_.find(&b);
+        if (it == index_.end()) {
+            write(b);
+            it = index_.find(&b);
+        }
+        put_uint(s, it->second);
+    }
+
+    template <typename Container>
+    void put_refs(std::string &s, const Container &c)
+    {
+        put_uint(s, c.size());
+        for (const auto &p : c) {
+            put_ref(s, *p);
+        }
+    }
+
+public:
+    BinaryWriter(std::string &out) : out_(out)
+    {
+    }
+
+    void write(const Basic &b)
+    {
+        // The children are written first, the data of `b` is collected in
+        // `s` meanwhile
+        std::string s;
+        TypeID id = b.get_type_code();
+        put_uint(s, id);
+        switch (id) {
+            case INTEGER:
+                put_integer(s,
+                            down_cast<const Integer &>(b).as_integer_class());
+                break;
+            case RATIONAL:
+                put_rational(
+                    s, down_cast<const Rational &>(b).as_rational_class());
+                break;
+            case COMPLEX:
+                put_rational(s, down_cast<const Complex &>(b).real_);
+                put_rational(s, down_cast<const Complex &>(b).imaginary_);
+                break;
+            case REAL_DOUBLE:
+                put_double(s, down_cast<const RealDouble &>(b).as_double());
+                break;
+            case COMPLEX_DOUBLE: {
+                std::complex<double> c
+                    = down_cast<const ComplexDouble &>(b).as_complex_double();
+                put_double(s, c.real());
+                put_double(s, c.imag());
+                break;
+            }
+            case SYMBOL:
+                put_string(s, down_cast<const Symbol &>(b).get_name());
+                break;
+            case DUMMY: {
+                const Dummy &x = down_cast<const Dummy &>(b);
+                put_string(s, x.get_name());
+                auto it = dummies_.find(x.get_index());
+                if (it == dummies_.end()) {
+                    unsigned long n = dummies_.size();
+                    it = dummies_.emplace(x.get_index(), n).first;
+                }
+                put_uint(s, it->second);
+                break;
+            }
+            case CONSTANT:
+                put_string(s, down_cast<const Constant &>(b).get_name());
+                break;
+            case ADD: {
+                const Add &x = down_cast<const Add &>(b);
+                put_ref(s, *x.get_coef());
+                put_uint(s, x.get_dict().size());
+                for (const auto &p : x.get_dict()) {
+                    put_ref(s, *p.first);
+                    put_ref(s, *p.second);
+                }
+                break;
+            }
+            case MUL: {
+                const Mul &x = down_cast<const Mul &>(b);
+                put_ref(s, *x.get_coef());
+                put_uint(s, x.get_dict().size());
+                for (const auto &p : x.get_dict()) {
+                    put_ref(s, *p.first);
+                    put_ref(s, *p.second);
+                }
+                break;
+            }
+            case FUNCTIONSYMBOL: {
+                const FunctionSymbol &x = down_cast<const FunctionSymbol &>(b);
+                put_string(s, x.get_name());
+                put_refs(s, x.get_args());
+                break;
+            }
+            case DERIVATIVE: {
+                const Derivative &x = down_cast<const Derivative &>(b);
+                put_ref(s, *x.get_arg());
+                put_refs(s, x.get_symbols());
+                break;
+            }
+            case SUBS: {
+                const Subs &x = down_cast<const Subs &>(b);
+                put_ref(s, *x.get_arg());
+                put_uint(s, x.get_dict().size());
+                for (const auto &p : x.get_dict()) {
+                    put_ref(s, *p.first);
+                    put_ref(s, *p.second);
+                }
+                break;
+            }
+            case INTERVAL: {
+                const Interval &x = down_cast<const Interval &>(b);
+                put_ref(s, *x.get_start());
+                put_ref(s, *x.get_end());
+                s.push_back(static_cast<char>((x.get_left_open() ? 1 : 0)
+                                              | (x.get_right_open() ? 2 : 0)));
+                break;
+            }
+            case BOOLEAN_ATOM:
+                s.push_back(down_cast<const BooleanAtom &>(b).get_val());
+                break;
+            case PIECEWISE: {
+                const Piecewise &x = down_cast<const Piecewise &>(b);
+                put_uint(s, x.get_vec().size());
+                for (const auto &p : x.get_vec()) {
+                    put_ref(s, *p.first);
+                    put_ref(s, *p.second);
+                }
+                break;
+            }
+            case INFTY:
+            case NOT_A_NUMBER:
+            case POW:
+#define SYMENGINE_CASE(type, f) case type:
+                SYMENGINE_ONE_ARG_FUNCTIONS(SYMENGINE_CASE)
+                SYMENGINE_TWO_ARG_FUNCTIONS(SYMENGINE_CASE)
+                SYMENGINE_MULTI_ARG_FUNCTIONS(SYMENGINE_CASE)
+#undef SYMENGINE_CASE
+            case NOT:
+            case AND:
+            case OR:
+            case XOR:
+            case EQUALITY:
+            case UNEQUALITY:
+            case LESSTHAN:
+            case STRICTLESSTHAN:
+            case CONTAINS:
+            case EMPTYSET:
+            case UNIVERSALSET:
+            case FINITESET:
+                put_refs(s, b.get_args());
+                break;
+            default:
+                throw NotImplementedError("dumps: " + b.__str__()
+                                          + " is not supported");
+        }
+        out_.append(s);
+        unsigned long n = index_.size();
+        index_[&b] = n;
+    }
+
+    void write_header()
+    {
+        out_.append(magic, 4);
+        put_uint(out_, version);
+    }
+};
+
+class BinaryReader
+{
+private:
+    const std::string &in_;
+    size_t pos_;
+    vec_basic nodes_;
+    // The dummies by their number in the data
+    std::unordered_map<uint64_t, RCP<const Basic>> dummies_;
+
+    void error(const std::string &msg) const
+    {
+        throw SymEngineException("loads: " + msg);
+    }
+
+    void check(size_t n) const
+    {
+        if (in_.size() - pos_ < n)
+            error("unexpected end of data");
+    }
+
+    uint64_t get_uint()
+    {
+        uint64_t n = 0;
+        for (unsigned shift = 0; shift < 64; shift += 7) {
+            check(1);
+            unsigned char c = static_cast<unsigned char>(in_[pos_++]);
+            n |= static_cast<uint64_t>(c & 0x7f) << shift;
+            if (not(c & 0x80))
+                return n;
+        }
+        error("invalid number");
+        return 0;
+    }
+
+    // The number of items that follow, each of them takes at least
+    // `item_size` bytes
+    size_t get_count(size_t item_size)
+    {
+        uint64_t n = get_uint();
+        if (n > (in_.size() - pos_) / item_size)
+            error("unexpected end of data");
+        return static_cast<size_t>(n);
+    }
+
+    unsigned char get_byte()
+    {
+        check(1);
+        return static_cast<unsigned char>(in_[pos_++]);
+    }
+
+    std::string get_string()
+    {
+        size_t n = get_count(1);
+        pos_ += n;
+        return in_.substr(pos_ - n, n);
+    }
+
+    uint64_t get_word()
+    {
+        check(8);
+        uint64_t w = 0;
+        for (unsigned i = 0; i < 8; i++) {
+            w |= static_cast<uint64_t>(static_cast<unsigned char>(in_[pos_++]))
+                 << (8 * i);
+        }
+        return w;
+    }
+
+    double get_double()
+    {
+        uint64_t w = get_word();
+        double d;
+        std::memcpy(&d, &w, sizeof(d));
+        return d;
+    }
+
+    static integer_class from_words(const std::vector<uint64_t> &words)
+    {
+        integer_class i;
+#if SYMENGINE_INTEGER_CLASS == SYMENGINE_BOOSTMP
+        boost::multiprecision::import_bits(i, words.begin(), words.end(), 64,
+                                           false);
+#else
+        mpz_t z;
+        mpz_init(z);
+        mpz_import(z, words.size(), -1, sizeof(uint64_t), 0, 0, words.data());
+        i = integer_class(z);
+        mpz_clear(z);
+#endif
+        return i;
+    }
+
+    integer_class get_integer()
+    {
+        unsigned char kind = get_byte();
+        if (kind == 0) {
+            const uint64_t z = get_uint();
+            const int64_t v = static_cast<int64_t>(z >> 1)
+                              ^ -static_cast<int64_t>(z & 1);
+            if (v >= std::numeric_limits<long>::min()
+                and v <= std::numeric_limits<long>::max())
+                return integer_class(static_cast<long>(v));
+            // Only where long has 32 bits
+            integer_class i = from_words({v < 0 ? 0 - static_cast<uint64_t>(v)
+                                                : static_cast<uint64_t>(v)});
+            return v < 0 ? integer_class(-i) : i;
+        }
+        if (kind > 2)
+            error("invalid integer");
+        std::vector<uint64_t> words(get_count(8));
+        for (auto &w : words) {
+            w = get_word();
+        }
+        integer_class i = from_words(words);
+        if (kind == 2)
+            i = -i;
+        return i;
+    }
+
+    rational_class get_rational()
+    {
+        integer_class num = get_integer();
+        integer_class den = get_integer();
+        if (den <= 0)
+            error("invalid rational");
+        rational_class q(num, den);
+        canonicalize(q);
+        return q;
+    }
+
+    RCP<const Basic> get_ref()
+    {
+        uint64_t i = get_uint();
+        if (i >= nodes_.size())
+            error("invalid reference");
+        return nodes_[i];
+    }
+
+    RCP<const Number> get_number()
+    {
+        RCP<const Basic> b = get_ref();
+        if (not is_a_Number(*b))
+            error("expected a number");
+        return rcp_static_cast<const Number>(b);
+    }
+
+    RCP<const Boolean> get_boolean()
+    {
+        RCP<const Basic> b = get_ref();
+        if (not is_a_Boolean(*b))
+            error("expected a boolean");
+        return rcp_static_cast<const Boolean>(b);
+    }
+
+    RCP<const Set> get_set()
+    {
+        RCP<const Basic> b = get_ref();
+        if (not is_a_Set(*b))
+            error("expected a set");
+        return rcp_static_cast<const Set>(b);
+    }
+
+    vec_basic get_refs()
+    {
+        vec_basic v(get_count(1));
+        for (auto &b : v) {
+            b = get_ref();
+        }
+        return v;
+    }
+
+    // Children of a node with a fixed number of them
+    vec_basic get_args(size_t n)
+    {
+        vec_basic v = get_refs();
+        if (v.size() != n)
+            error("wrong number of arguments");
+        return v;
+    }
+
+    RCP<const Basic> read_node()
+    {
+        uint64_t id = get_uint();
+        switch (id) {
+            case INTEGER:
+                return integer(get_integer());
+            case RATIONAL:
+                return Rational::from_mpq(get_rational());
+            case COMPLEX: {
+                rational_class re = get_rational();
+                return Complex::from_mpq(re, get_rational());
+            }
+            case REAL_DOUBLE:
+                return real_double(get_double());
+            case COMPLEX_DOUBLE: {
+                double re = get_double();
+                return complex_double(std::complex<double>(re, get_double()));
+            }
+            case INFTY: {
+                vec_basic a = get_args(1);
+                if (not is_a_Number(*a[0]))
+                    error("expected a number");
+                return Infty::from_direction(
+                    rcp_static_cast<const Number>(a[0]));
+            }
+            case NOT_A_NUMBER:
+                get_args(0);
+                return Nan;
+            case SYMBOL:
+                return symbol(get_string());
+            case DUMMY: {
+                std::string name = get_string();
+                // `Dummy` prefixes the name given to it with an underscore
+                if (name.empty() or name[0] != '_')
+                    error("invalid Dummy");
+                const uint64_t n = get_uint();
+                auto it = dummies_.find(n);
+                if (it == dummies_.end()) {
+                    it = dummies_.emplace(n, dummy(name.substr(1))).first;
+                } else if (down_cast<const Dummy &>(*it->second).get_name()
+                           != name) {
+                    error("invalid Dummy");
+                }
+                return it->second;
+            }
+            case CONSTANT:
+                return constant(get_string());
+            case ADD: {
+                RCP<const Number> coef = get_number();
+                size_t n = get_count(2);
+                umap_basic_num d;
+                d.reserve(n);
+                for (size_t i = 0; i < n; i++) {
+                    RCP<const Basic> term = get_ref();
+                    d[term] = get_number();
+                }
+                if (d.size() != n)
+                    error("repeated term");
+                if (not Add::is_canonical(coef, d))
+                    error("invalid Add");
+                return make_rcp<const Add>(coef, std::move(d));
+            }
+            case MUL: {
+                RCP<const Number> coef = get_number();
+                size_t n = get_count(2);
+                map_basic_basic d;
+                for (size_t i = 0; i < n; i++) {
+                    RCP<const Basic> base = get_ref();
+                    d[base] = get_ref();
+                }
+                if (d.size() != n)
+                    error("repeated factor");
+                if (not Mul::is_canonical(coef, d))
+                    error("invalid Mul");
+                return make_rcp<const Mul>(coef, std::move(d));
+            }
+            case POW: {
+                vec_basic a = get_args(2);
+                if (not Pow::is_canonical(*a[0], *a[1]))
+                    error("invalid Pow");
+                return make_rcp<const Pow>(a[0], a[1]);
+            }
+            case FUNCTIONSYMBOL: {
+                std::string name = get_string();
+                return function_symbol(name, get_refs());
+            }
+            case DERIVATIVE: {
+                RCP<const Basic> arg = get_ref();
+                vec_basic v = get_refs();
+                multiset_basic x(v.begin(), v.end());
+                if (not Derivative::is_canonical(arg, x))
+                    error("invalid Derivative");
+                return make_rcp<const Derivative>(arg, x);
+            }
+            case SUBS: {
+                RCP<const Basic> arg = get_ref();
+                size_t n = get_count(2);
+                map_basic_basic d;
+                for (size_t i = 0; i < n; i++) {
+                    RCP<const Basic> old = get_ref();
+                    d[old] = get_ref();
+                }
+                if (d.size() != n)
+                    error("repeated variable");
+                if (not Subs::is_canonical(arg, d))
+                    error("invalid Subs");
+                return make_rcp<const Subs>(arg, d);
+            }
+            case INTERVAL: {
+                RCP<const Number> start = get_number();
+                RCP<const Number> end = get_number();
+                unsigned char flags = get_byte();
+                return interval(start, end, flags & 1, flags & 2);
+            }
+            case BOOLEAN_ATOM:
+                return boolean(get_byte() != 0);
+            case PIECEWISE: {
+                size_t n = get_count(2);
+                PiecewiseVec vec;
+                for (size_t i = 0; i < n; i++) {
+                    RCP<const Basic> expr = get_ref();
+                    vec.push_back({expr, get_boolean()});
+                }
+                return piecewise(std::move(vec));
+            }
+            case NOT: {
+                if (get_count(1) != 1)
+                    error("wrong number of arguments");
+                return logical_not(get_boolean());
+            }
+            case AND:
+            case OR:
+            case XOR: {
+                size_t n = get_count(1);
+                vec_boolean v;
+                for (size_t i = 0; i < n; i++) {
+                    v.push_back(get_boolean());
+                }
+                if (id == XOR)
+                    return logical_xor(v);
+                set_boolean s(v.begin(), v.end());
+                return id == AND ? logical_and(s) : logical_or(s);
+            }
+            case EQUALITY:
+            case UNEQUALITY:
+            case LESSTHAN:
+            case STRICTLESSTHAN: {
+                vec_basic a = get_args(2);
+                if (id == EQUALITY)
+                    return Eq(a[0], a[1]);
+                if (id == UNEQUALITY)
+                    return Ne(a[0], a[1]);
+                if (id == LESSTHAN)
+                    return Le(a[0], a[1]);
+                return Lt(a[0], a[1]);
+            }
+            case CONTAINS: {
+                if (get_count(1) != 2)
+                    error("wrong number of arguments");
+                RCP<const Basic> expr = get_ref();
+                return contains(expr, get_set());
+            }
+            case EMPTYSET:
+                get_args(0);
+                return emptyset();
+            case UNIVERSALSET:
+                get_args(0);
+                return universalset();
+            case FINITESET: {
+                vec_basic v = get_refs();
+                return finiteset(set_basic(v.begin(), v.end()));
+            }
+#define SYMENGINE_CASE(type, f)                                                \
+    case type: {                                                   \
+        vec_basic a = get_args(1);                                             \
+        return SymEngine::f(a[0]);                                             \
+    }
+                SYMENGINE_ONE_ARG_FUNCTIONS(SYMENGINE_CASE)
+#undef SYMENGINE_CASE
+#define SYMENGINE_CASE(type, f)                                                \
+    case type: {                                                   \
+        vec_basic a = get_args(2);                                             \
+        return SymEngine::f(a[0], a[1]);                                       \
+    }
+                SYMENGINE_TWO_ARG_FUNCTIONS(SYMENGINE_CASE)
+#undef SYMENGINE_CASE
+#define SYMENGINE_CASE(type, f)                                                \
+    case type:                                                     \
+        return SymEngine::f(get_refs());
+                SYMENGINE_MULTI_ARG_FUNCTIONS(SYMENGINE_CASE)
+#undef SYMENGINE_CASE
+            default:
+                error("unknown type code " + std::to_string(id));
+        }
+        return RCP<const Basic>();
+    }
+
+public:
+    BinaryReader(const std::string &in) : in_(in), pos_(0)
+    {
+    }
+
+    RCP<const Basic> read()
+    {
+        check(4);
+        if (in_.compare(0, 4, magic) != 0)
+            error("not a serialized expression");
+        pos_ = 4;
+        unsigned long long v = get_uint();
+        if (v != version)
+            error("unsupported format version " + std::to_string(v));
+        while (pos_ < in_.size()) {
+            nodes_.push_back(read_node());
+        }
+        if (nodes_.empty())
+            error("no expression");
+        return nodes_.back();
+    }
+};
+
+} // namespace
+
+std::string Basic::dumps() const
+{
+    std::string s;
+    BinaryWriter w(s);
+    w.write_header();
+    w.write(*this);
+    return s;
+}
+
+RCP<const Basic> Basic::loads(const std::string &serialized)
+{
+    BinaryReader r(serialized);
+    return r.read();
+}
+
+} // namespace SymEngine
@@ -76,20 +76,103 @@ int UnivariateSeries::ldegree(const UExprDict &s)
     return s.get_dict().begin()->first;
 }
 
+namespace
+{
+// Coefficients of x**low to x**(low + n - 1) of `a` over a common
+// denominator `den`. Returns false if one of them is not a rational number.
+bool rational_coeffs(const UExprDict &a, int low, unsigned n,
+                     vec_integer_class &num, integer_class &den)
+{
+    den = 1;
+    for (const auto &it : a.get_dict()) {
+        if (it.first - low >= (int)n)
+            break;
+        const Basic &c = *it.second.get_basic();
+        if (is_a<Rational>(c)) {
+            mp_lcm(den, den,
+                   get_den(down_cast<const Rational &>(c).as_rational_class()));
+        } else if (not is_a<Integer>(c)) {
+            return false;
+        }
+    }
+    num.assign(std::min<size_t>(n, a.get_dict().rbegin()->first - low + 1),
+               integer_class(0));
+    for (const auto &it : a.get_dict()) {
+        if (it.first - low >= (int)n)
+            break;
+        const Basic &c = *it.second.get_basic();
+        integer_class &t = num[it.first - low];
+        if (is_a<Integer>(c)) {
+            t = down_cast<const Integer &>(c).as_integer_class() * den;
+        } else {
+            const rational_class &q
+                = down_cast<const Rational &>(c).as_rational_class();
+            mp_divexact(t, den, get_den(q));
+            t *= get_num(q);
+        }
+    }
+    return true;
+}
+} // namespace
+
+// Only the terms below x**prec are computed. Rational coefficients are
+// multiplied as one integer polynomial, other ones are summed with a single
+// `add` per coefficient instead of growing an `Expression` term by term.
 UExprDict UnivariateSeries::mul(const UExprDict &a, const UExprDict &b,
                                 unsigned prec)
 {
+    if (a.empty() or b.empty())
+        return UExprDict();
+    const int low = ldegree(a) + ldegree(b);
+    if (low >= (int)prec)
+        return UExprDict();
+    // Number of coefficients of the truncated product
+    const unsigned n = prec - low;
+
     map_int_Expr p;
-    for (auto &it1 : a.get_dict()) {
-        for (auto &it2 : b.get_dict()) {
-            int exp = it1.first + it2.first;
-            if (exp < (int)prec) {
-                p[exp] += it1.second * it2.second;
-            } else {
+    vec_integer_class na, nb;
+    integer_class da, db;
+    if (rational_coeffs(a, ldegree(a), n, na, da)
+        and rational_coeffs(b, ldegree(b), n, nb, db)) {
+        vec_integer_class r = mullow_dense_upoly(na, nb, n);
+        da *= db;
+        for (unsigned k = 0; k < r.size(); k++) {
+            if (r[k] == 0)
+                continue;
+            rational_class q(r[k], da);
+            canonicalize(q);
+            p.emplace_hint(p.end(), low + k,
+                           Expression(Rational::from_mpq(std::move(q))));
+        }
+        return UExprDict(p);
+    }
+
+    // The nonzero terms below the precision, by their degree above the lowest
+    std::vector<std::pair<unsigned, RCP<const Basic>>> ta, tb;
+    for (const auto &it : a.get_dict()) {
+        if (it.first - ldegree(a) >= (int)n)
+            break;
+        ta.emplace_back(it.first - ldegree(a), it.second.get_basic());
+    }
+    for (const auto &it : b.get_dict()) {
+        if (it.first - ldegree(b) >= (int)n)
+            break;
+        tb.emplace_back(it.first - ldegree(b), it.second.get_basic());
+    }
+    std::vector<vec_basic> terms(n);
+    for (const auto &i : ta) {
+        for (const auto &j : tb) {
+            if (i.first + j.first >= n)
                 break;
-            }
+            terms[i.first + j.first].push_back(
+                SymEngine::mul(i.second, j.second));
         }
     }
+    for (unsigned k = 0; k < n; k++) {
+        if (not terms[k].empty())
+            p.emplace_hint(p.end(), low + k,
+                           Expression(SymEngine::add(terms[k])));
+    }
     return UExprDict(p);
 }
 
@@ -1,10 +1,12 @@
 #include <numeric>
+#include <set>
 #include <symengine/matrix.h>
 #include <symengine/add.h>
 #include <symengine/mul.h>
 #include <symengine/constants.h>
 #include <symengine/symengine_exception.h>
 #include <symengine/visitor.h>
+#include <symengine/derivative.h>
 
 namespace SymEngine
 {
@@ -159,6 +161,279 @@ void CSRMatrix::set(unsigned i, unsigned j, const RCP<const Basic> &e)
     }
 }
 
+namespace
+{
+
+typedef std::map<unsigned, RCP<const Basic>> SparseRow;
+
+/*
+   Sparse fraction free (Bareiss) elimination of a square CSR matrix.
+
+   The pivot order is chosen by `analyze()` on the sparsity pattern alone,
+   before any symbolic arithmetic: at each step the column with the fewest
+   entries is eliminated, using the row with the fewest entries among the
+   rows having one in that column, which keeps the fill-in low (Markowitz).
+   `factorize()` then follows that order, falling back to another row of the
+   pivot column only when the planned pivot cancels out.
+
+   Rows which are not touched by a step are not rescaled. A row stored at
+   step `l` is brought to step `k` by multiplying it by
+   pivot[k - 1] / pivot[l - 1], which is folded into its next update.
+*/
+class SparseFFLU
+{
+private:
+    unsigned n_;
+    // Rows not eliminated yet, columns >= n_ hold the right hand sides
+    std::vector<SparseRow> rows_;
+    // The elimination step the values of each row belong to
+    std::vector<unsigned> level_;
+    // For every column, the rows not eliminated yet having an entry in it
+    std::vector<std::set<unsigned>> col_rows_;
+    std::vector<bool> eliminated_;
+    std::vector<unsigned> plan_rows_, plan_cols_;
+    // The pivot rows at the step they were used
+    std::vector<SparseRow> U_;
+    std::vector<unsigned> pivot_rows_, pivot_cols_;
+    vec_basic pivots_;
+    bool singular_ = false;
+
+    RCP<const Basic> previous_pivot(unsigned level) const
+    {
+        if (level == 0)
+            return one;
+        return pivots_[level - 1];
+    }
+
+    void set_entry(unsigned i, SparseRow &row, unsigned j,
+                   const RCP<const Basic> &v)
+    {
+        if (is_a<Integer>(*v) and down_cast<const Integer &>(*v).is_zero()) {
+            if (row.erase(j) and j < n_)
+                col_rows_[j].erase(i);
+        } else {
+            if (row.insert({j, v}).second and j < n_)
+                col_rows_[j].insert(i);
+            else
+                row[j] = v;
+        }
+    }
+
+    // Chooses a row having an entry in column `c` with as few entries as
+    // possible, returns n_ if there is none
+    unsigned pivot_row(unsigned c) const
+    {
+        unsigned r = n_;
+        for (unsigned i : col_rows_[c]) {
+            if (r == n_ or rows_[i].size() < rows_[r].size())
+                r = i;
+        }
+        return r;
+    }
+
+    void eliminate(unsigned k, unsigned r, unsigned c)
+    {
+        SparseRow pr = std::move(rows_[r]);
+        if (level_[r] != k) {
+            const RCP<const Basic> d = previous_pivot(level_[r]);
+            for (auto &e : pr)
+                e.second = div(mul(e.second, pivots_[k - 1]), d);
+        }
+        for (const auto &e : pr) {
+            if (e.first < n_)
+                col_rows_[e.first].erase(r);
+        }
+        eliminated_[r] = true;
+        const RCP<const Basic> p = pr[c];
+
+        std::vector<unsigned> targets(col_rows_[c].begin(),
+                                      col_rows_[c].end());
+        for (unsigned i : targets) {
+            SparseRow &row = rows_[i];
+            const RCP<const Basic> a = row[c];
+            const RCP<const Basic> d = previous_pivot(level_[i]);
+            auto it = row.begin();
+            for (const auto &e : pr) {
+                for (; it != row.end() and it->first < e.first; ++it) {
+                    it->second = div(mul(p, it->second), d);
+                }
+                if (e.first == c) {
+                    continue;
+                }
+                RCP<const Basic> v;
+                if (it != row.end() and it->first == e.first) {
+                    v = sub(mul(p, it->second), mul(a, e.second));
+                    ++it;
+                } else {
+                    v = neg(mul(a, e.second));
+                }
+                set_entry(i, row, e.first, div(v, d));
+            }
+            for (; it != row.end(); ++it) {
+                it->second = div(mul(p, it->second), d);
+            }
+            row.erase(c);
+            level_[i] = k + 1;
+        }
+        col_rows_[c].clear();
+
+        U_.push_back(std::move(pr));
+        pivot_rows_.push_back(r);
+        pivot_cols_.push_back(c);
+        pivots_.push_back(p);
+    }
+
+public:
+    SparseFFLU(unsigned n, const std::vector<unsigned> &p,
+               const std::vector<unsigned> &j, const vec_basic &x)
+        : n_(n), rows_(n), level_(n, 0), col_rows_(n), eliminated_(n, false)
+    {
+        for (unsigned i = 0; i < n; i++) {
+            for (unsigned k = p[i]; k < p[i + 1]; k++) {
+                set_entry(i, rows_[i], j[k], x[k]);
+            }
+        }
+    }
+
+    // Appends the columns of `b` as right hand sides
+    void add_rhs(const DenseMatrix &b)
+    {
+        SYMENGINE_ASSERT(b.nrows() == n_);
+        for (unsigned i = 0; i < n_; i++) {
+            for (unsigned k = 0; k < b.ncols(); k++) {
+                set_entry(i, rows_[i], n_ + k, b.get(i, k));
+            }
+        }
+    }
+
+    // Chooses the pivots from the sparsity pattern
+    void analyze()
+    {
+        std::vector<std::set<unsigned>> rpat(n_), cpat(col_rows_);
+        for (unsigned i = 0; i < n_; i++) {
+            for (const auto &e : rows_[i]) {
+                if (e.first < n_)
+                    rpat[i].insert(e.first);
+            }
+        }
+        std::set<std::pair<size_t, unsigned>> queue;
+        for (unsigned c = 0; c < n_; c++) {
+            queue.insert({cpat[c].size(), c});
+        }
+        std::vector<unsigned> touched;
+        while (not queue.empty()) {
+            const unsigned c = queue.begin()->second;
+            queue.erase(queue.begin());
+            if (cpat[c].empty()) {
+                // Structurally singular
+                singular_ = true;
+                return;
+            }
+            unsigned r = *cpat[c].begin();
+            for (unsigned i : cpat[c]) {
+                if (rpat[i].size() < rpat[r].size())
+                    r = i;
+            }
+            plan_rows_.push_back(r);
+            plan_cols_.push_back(c);
+
+            touched.clear();
+            for (unsigned j : rpat[r]) {
+                if (j != c) {
+                    touched.push_back(j);
+                    queue.erase({cpat[j].size(), j});
+                    cpat[j].erase(r);
+                }
+            }
+            for (unsigned i : cpat[c]) {
+                if (i == r)
+                    continue;
+                rpat[i].erase(c);
+                for (unsigned j : touched) {
+                    if (rpat[i].insert(j).second)
+                        cpat[j].insert(i);
+                }
+            }
+            for (unsigned j : touched) {
+                queue.insert({cpat[j].size(), j});
+            }
+            rpat[r].clear();
+            cpat[c].clear();
+        }
+    }
+
+    void factorize()
+    {
+        for (unsigned k = 0; k < plan_cols_.size(); k++) {
+            const unsigned c = plan_cols_[k];
+            unsigned r = plan_rows_[k];
+            if (eliminated_[r] or rows_[r].find(c) == rows_[r].end()) {
+                r = pivot_row(c);
+            }
+            if (r == n_) {
+                singular_ = true;
+                return;
+            }
+            eliminate(k, r, c);
+        }
+    }
+
+    bool is_singular() const
+    {
+        return singular_;
+    }
+
+    // The determinant, the last pivot up to the sign of the permutations
+    RCP<const Basic> det() const
+    {
+        if (singular_)
+            return zero;
+        if (n_ == 0)
+            return one;
+        int sign = 1;
+        for (const auto *perm : {&pivot_rows_, &pivot_cols_}) {
+            std::vector<bool> seen(n_, false);
+            for (unsigned i = 0; i < n_; i++) {
+                if (seen[i])
+                    continue;
+                for (unsigned j = i; not seen[j]; j = (*perm)[j]) {
+                    seen[j] = true;
+                    if (j != i)
+                        sign = -sign;
+                }
+            }
+        }
+        if (sign == 1)
+            return pivots_.back();
+        return neg(pivots_.back());
+    }
+
+    // Back substitution for the right hand sides, `x` must be n_ x nrhs
+    void solve(DenseMatrix &x) const
+    {
+        SYMENGINE_ASSERT(not singular_);
+        for (unsigned k = n_; k-- > 0;) {
+            const SparseRow &row = U_[k];
+            const unsigned c = pivot_cols_[k];
+            for (unsigned m = 0; m < x.ncols(); m++) {
+                auto it = row.find(n_ + m);
+                RCP<const Basic> s = zero;
+                if (it != row.end())
+                    s = it->second;
+                for (const auto &e : row) {
+                    if (e.first >= n_)
+                        break;
+                    if (e.first != c)
+                        s = sub(s, mul(e.second, x.get(e.first, m)));
+                }
+                x.set(c, m, div(s, row.at(c)));
+            }
+        }
+    }
+};
+
+} // namespace
+
 unsigned CSRMatrix::rank() const
 {
     throw NotImplementedError("Not Implemented");
@@ -166,12 +441,22 @@ unsigned CSRMatrix::rank() const
 
 RCP<const Basic> CSRMatrix::det() const
 {
-    throw NotImplementedError("Not Implemented");
+    SYMENGINE_ASSERT(row_ == col_);
+    SparseFFLU lu(row_, p_, j_, x_);
+    lu.analyze();
+    lu.factorize();
+    return lu.det();
 }
 
 void CSRMatrix::inv(MatrixBase &result) const
 {
-    throw NotImplementedError("Not Implemented");
+    if (is_a<DenseMatrix>(result)) {
+        DenseMatrix I(row_, row_);
+        eye(I);
+        LU_solve(I, result);
+    } else {
+        throw NotImplementedError("Not Implemented");
+    }
 }
 
 void CSRMatrix::add_matrix(const MatrixBase &other, MatrixBase &result) const
@@ -250,10 +535,23 @@ void CSRMatrix::LDL(MatrixBase &L, MatrixBase &D) const
     throw NotImplementedError("Not Implemented");
 }
 
-// Solve Ax = b using LU factorization
+// Solve Ax = b using sparse fraction free LU factorization
 void CSRMatrix::LU_solve(const MatrixBase &b, MatrixBase &x) const
 {
-    throw NotImplementedError("Not Implemented");
+    if (is_a<DenseMatrix>(b) and is_a<DenseMatrix>(x)) {
+        SYMENGINE_ASSERT(row_ == col_ and b.nrows() == row_);
+        SYMENGINE_ASSERT(x.nrows() == row_ and x.ncols() == b.ncols());
+        SparseFFLU lu(row_, p_, j_, x_);
+        lu.analyze();
+        lu.add_rhs(down_cast<const DenseMatrix &>(b));
+        lu.factorize();
+        if (lu.is_singular()) {
+            throw SymEngineException("Matrix is singular");
+        }
+        lu.solve(down_cast<DenseMatrix &>(x));
+    } else {
+        throw NotImplementedError("Not Implemented");
+    }
 }
 
 // Fraction free LU factorization
@@ -424,26 +722,23 @@ CSRMatrix CSRMatrix::from_coo(unsigned row, unsigned col,
 
 CSRMatrix CSRMatrix::jacobian(const vec_basic &exprs, const vec_sym &x)
 {
-    const unsigned nrows = static_cast<unsigned>(exprs.size());
-    const unsigned ncols = static_cast<unsigned>(x.size());
-    std::vector<unsigned> p(1, 0), j;
-    vec_basic elems;
-    p.reserve(nrows + 1);
-    j.reserve(nrows);
-    elems.reserve(nrows);
-    for (unsigned ri = 0; ri < nrows; ++ri) {
-        p.push_back(p.back());
-        for (unsigned ci = 0; ci < ncols; ++ci) {
-            auto elem = exprs[ri]->diff(x[ci]);
-            if (neq(*elem, *zero)) {
-                p.back()++;
-                j.push_back(ci);
-                elems.emplace_back(std::move(elem));
+    CSRMatrix J = JacobianPattern(exprs, x).evaluate(exprs);
+    // Drop the derivatives which cancelled out
+    unsigned nnz = 0, start = 0;
+    for (unsigned ri = 0; ri < J.row_; ++ri) {
+        for (unsigned k = start; k < J.p_[ri + 1]; ++k) {
+            if (neq(*J.x_[k], *zero)) {
+                J.j_[nnz] = J.j_[k];
+                J.x_[nnz] = std::move(J.x_[k]);
+                nnz++;
             }
         }
+        start = J.p_[ri + 1];
+        J.p_[ri + 1] = nnz;
     }
-    return CSRMatrix(nrows, ncols, std::move(p), std::move(j),
-                     std::move(elems));
+    J.j_.resize(nnz);
+    J.x_.resize(nnz);
+    return J;
 }
 
 CSRMatrix CSRMatrix::jacobian(const DenseMatrix &A, const DenseMatrix &x)
@@ -461,6 +756,61 @@ CSRMatrix CSRMatrix::jacobian(const DenseMatrix &A, const DenseMatrix &x)
     return CSRMatrix::jacobian(A.m_, syms);
 }
 
+JacobianPattern::JacobianPattern(const vec_basic &exprs, const vec_sym &x)
+    : x_(x), p_(exprs.size() + 1, 0),
+      row_(static_cast<unsigned>(exprs.size()))
+{
+    // The columns of each symbol, usually a single one
+    std::unordered_map<RCP<const Basic>, std::vector<unsigned>, RCPBasicHash,
+                       RCPBasicKeyEq>
+        columns;
+    for (unsigned ci = 0; ci < x.size(); ++ci) {
+        columns[x[ci]].push_back(ci);
+    }
+    std::vector<std::vector<unsigned>> rows(row_);
+#pragma omp parallel for schedule(dynamic, 64)
+    for (unsigned ri = 0; ri < row_; ++ri) {
+        std::vector<unsigned> &row = rows[ri];
+        for (const auto &s : free_symbols(*exprs[ri])) {
+            auto it = columns.find(s);
+            if (it != columns.end()) {
+                row.insert(row.end(), it->second.begin(), it->second.end());
+            }
+        }
+        std::sort(row.begin(), row.end());
+    }
+    for (unsigned ri = 0; ri < row_; ++ri) {
+        p_[ri + 1] = p_[ri] + static_cast<unsigned>(rows[ri].size());
+    }
+    j_.resize(p_[row_]);
+#pragma omp parallel for schedule(static)
+    for (unsigned ri = 0; ri < row_; ++ri) {
+        std::copy(rows[ri].begin(), rows[ri].end(), j_.begin() + p_[ri]);
+    }
+}
+
+CSRMatrix JacobianPattern::evaluate(const vec_basic &exprs) const
+{
+    SYMENGINE_ASSERT(exprs.size() == row_);
+    vec_basic elems(j_.size());
+#pragma omp parallel for schedule(dynamic, 64)
+    for (unsigned ri = 0; ri < row_; ++ri) {
+        if (p_[ri] == p_[ri + 1]) {
+            continue;
+        }
+        vec_sym syms;
+        syms.reserve(p_[ri + 1] - p_[ri]);
+        for (unsigned k = p_[ri]; k < p_[ri + 1]; ++k) {
+            syms.push_back(x_[j_[k]]);
+        }
+        vec_basic row = gradient(exprs[ri], syms);
+        std::move(row.begin(), row.end(), elems.begin() + p_[ri]);
+    }
+    std::vector<unsigned> p(p_), j(j_);
+    return CSRMatrix(row_, ncols(), std::move(p), std::move(j),
+                     std::move(elems));
+}
+
 void csr_matmat_pass1(const CSRMatrix &A, const CSRMatrix &B, CSRMatrix &C)
 {
     // method that uses O(n) temp storage
@@ -3,6 +3,9 @@
 
 #include <symengine/visitor.h>
 #include <symengine/derivative.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 namespace SymEngine
 {
@@ -28,10 +31,24 @@ class XReplaceVisitor : public BaseVisitor<XReplaceVisitor>
 protected:
     RCP<const Basic> result_;
     const map_basic_basic &subs_dict_;
+    // The results of the nodes visited so far, so that the subexpressions
+    // shared in a DAG are visited once. The nodes are kept alive, their
+    // addresses can then not be reused by temporaries.
+    std::unordered_map<const Basic *,
+                       std::pair<RCP<const Basic>, RCP<const Basic>>>
+        visited_;
+    // Whether `subs_dict_` has Mul (resp. Pow) keys, which the terms of an
+    // Add (resp. factors of a Mul) have to be looked up for
+    bool has_mul_key_ = false;
+    bool has_pow_key_ = false;
 
 public:
     XReplaceVisitor(const map_basic_basic &subs_dict) : subs_dict_(subs_dict)
     {
+        for (const auto &p : subs_dict_) {
+            has_mul_key_ = has_mul_key_ or is_a<Mul>(*p.first);
+            has_pow_key_ = has_pow_key_ or is_a<Pow>(*p.first);
+        }
     }
     // TODO : Polynomials, Series, Sets
     void bvisit(const Basic &x)
@@ -41,49 +58,97 @@ public:
 
     void bvisit(const Add &x)
     {
+        // The terms are substituted first, the Add is only rebuilt if one of
+        // them has changed
+        std::vector<std::pair<RCP<const Number>, RCP<const Basic>>> terms;
+        terms.reserve(x.get_dict().size());
+        auto coef_it = subs_dict_.find(x.get_coef());
+        bool changed = coef_it != subs_dict_.end();
+        for (const auto &p : x.get_dict()) {
+            // The term is `p.first` itself if the coefficient is one, a Mul
+            // otherwise
+            auto it = subs_dict_.end();
+            if (eq(*p.second, *one)) {
+                it = subs_dict_.find(p.first);
+            } else if (has_mul_key_) {
+                it = subs_dict_.find(
+                    Add::from_dict(zero, {{p.first, p.second}}));
+            }
+            if (it != subs_dict_.end()) {
+                terms.push_back({one, it->second});
+                changed = true;
+                continue;
+            }
+            it = subs_dict_.find(p.second);
+            if (it != subs_dict_.end()) {
+                terms.push_back({one, mul(it->second, apply(p.first))});
+                changed = true;
+            } else {
+                terms.push_back({p.second, apply(p.first)});
+                changed = changed or terms.back().second != p.first;
+            }
+        }
+        if (not changed) {
+            result_ = x.rcp_from_this();
+            return;
+        }
+
         SymEngine::umap_basic_num d;
         RCP<const Number> coef;
-
-        auto it = subs_dict_.find(x.get_coef());
-        if (it != subs_dict_.end()) {
+        if (coef_it != subs_dict_.end()) {
             coef = zero;
-            Add::coef_dict_add_term(outArg(coef), d, one, it->second);
+            Add::coef_dict_add_term(outArg(coef), d, one, coef_it->second);
         } else {
             coef = x.get_coef();
         }
-
-        for (const auto &p : x.get_dict()) {
-            auto it
-                = subs_dict_.find(Add::from_dict(zero, {{p.first, p.second}}));
-            if (it != subs_dict_.end()) {
-                Add::coef_dict_add_term(outArg(coef), d, one, it->second);
-            } else {
-                it = subs_dict_.find(p.second);
-                if (it != subs_dict_.end()) {
-                    Add::coef_dict_add_term(outArg(coef), d, one,
-                                            mul(it->second, apply(p.first)));
-                } else {
-                    Add::coef_dict_add_term(outArg(coef), d, p.second,
-                                            apply(p.first));
-                }
-            }
+        for (const auto &t : terms) {
+            Add::coef_dict_add_term(outArg(coef), d, t.first, t.second);
         }
         result_ = Add::from_dict(coef, std::move(d));
     }
 
     void bvisit(const Mul &x)
     {
-        RCP<const Number> coef = x.get_coef();
-        map_basic_basic d;
+        // The factors are substituted first, the Mul is only rebuilt if one
+        // of them has changed. A null factor is unchanged.
+        vec_basic factors;
+        factors.reserve(x.get_dict().size());
+        bool changed = false;
         for (const auto &p : x.get_dict()) {
-            RCP<const Basic> factor_old;
+            RCP<const Basic> factor;
             if (eq(*p.second, *one)) {
-                factor_old = p.first;
+                factor = apply(p.first);
+                if (factor == p.first) {
+                    factor = null;
+                }
+            } else if (has_pow_key_) {
+                RCP<const Basic> factor_old = make_rcp<Pow>(p.first, p.second);
+                factor = apply(factor_old);
+                if (factor == factor_old) {
+                    factor = null;
+                }
             } else {
-                factor_old = make_rcp<Pow>(p.first, p.second);
+                // Same as visiting the Pow, without creating it
+                RCP<const Basic> base_new = apply(p.first);
+                RCP<const Basic> exp_new = apply(p.second);
+                if (base_new != p.first or exp_new != p.second) {
+                    factor = pow(base_new, exp_new);
+                }
             }
-            RCP<const Basic> factor = apply(factor_old);
-            if (factor == factor_old) {
+            changed = changed or not factor.is_null();
+            factors.push_back(factor);
+        }
+        if (not changed) {
+            result_ = x.rcp_from_this();
+            return;
+        }
+
+        RCP<const Number> coef = x.get_coef();
+        map_basic_basic d;
+        auto f = factors.begin();
+        for (const auto &p : x.get_dict()) {
+            const RCP<const Basic> &factor = *f++;
+            if (factor.is_null()) {
                 // TODO: Check if Mul::dict_add_term is enough
                 Mul::dict_add_term_new(outArg(coef), d, p.second, p.first);
             } else if (is_a_Number(*factor)) {
@@ -142,19 +207,22 @@ public:
     void bvisit(const MultiArgFunction &x)
     {
         vec_basic v = x.get_args();
+        bool changed = false;
         for (auto &elem : v) {
-            elem = apply(elem);
+            RCP<const Basic> a = apply(elem);
+            changed = changed or a != elem;
+            elem = a;
+        }
+        if (changed) {
+            result_ = x.create(v);
+        } else {
+            result_ = x.rcp_from_this();
         }
-        result_ = x.create(v);
     }
 
     void bvisit(const FunctionSymbol &x)
     {
-        vec_basic v = x.get_args();
-        for (auto &elem : v) {
-            elem = apply(elem);
-        }
-        result_ = x.create(v);
+        bvisit(static_cast<const MultiArgFunction &>(x));
     }
 
     void bvisit(const Contains &x)
@@ -252,8 +320,16 @@ public:
         auto it = subs_dict_.find(x);
         if (it != subs_dict_.end()) {
             result_ = it->second;
-        } else {
+        } else if (is_a_Atom(*x)) {
             x->accept(*this);
+        } else {
+            auto v = visited_.find(x.get());
+            if (v != visited_.end()) {
+                result_ = v->second.second;
+            } else {
+                x->accept(*this);
+                visited_.emplace(x.get(), std::make_pair(x, result_));
+            }
         }
         return result_;
     }
@@ -486,6 +562,68 @@ inline RCP<const Basic> subs(const RCP<const Basic> &x,
     return b.apply(x);
 }
 
+/*! The same substitution applied to many expressions, e.g. to evaluate all
+    the entries of a Jacobian at an operating point:
+
+        SubsPlan plan({{x, real_double(0.5)}, {y, real_double(1.5)}});
+        vec_basic values = plan.apply(entries);
+
+    The results of the subexpressions are kept for the lifetime of the plan,
+    so a subexpression shared by several expressions is substituted once. The
+    subexpressions that the substitution does not change are returned as
+    they are, without being rebuilt.
+*/
+class SubsPlan
+{
+private:
+    const map_basic_basic subs_dict_;
+    SubsVisitor visitor_;
+
+public:
+    SubsPlan(const map_basic_basic &subs_dict)
+        : subs_dict_(subs_dict), visitor_(subs_dict_)
+    {
+    }
+    SubsPlan(const SubsPlan &) = delete;
+    SubsPlan &operator=(const SubsPlan &) = delete;
+
+    //! Same as `subs(x, subs_dict)`
+    RCP<const Basic> apply(const RCP<const Basic> &x)
+    {
+        return visitor_.apply(x);
+    }
+
+    /*! Substitutes in all of `exprs`. When SymEngine is built thread safe,
+        the caller is compiled with OpenMP and `parallel` is true, the
+        expressions are split into contiguous chunks, one per thread, and
+        every thread but the first one uses its own cache. Otherwise the
+        cache of the plan is used for all of them.
+    */
+    vec_basic apply(const vec_basic &exprs, bool parallel = true)
+    {
+        vec_basic result(exprs.size());
+#if defined(_OPENMP) && defined(WITH_SYMENGINE_THREAD_SAFE)
+        if (parallel and exprs.size() > 1) {
+#pragma omp parallel
+            {
+                SubsVisitor local(subs_dict_);
+                SubsVisitor &visitor
+                    = omp_get_thread_num() == 0 ? visitor_ : local;
+#pragma omp for schedule(static)
+                for (unsigned i = 0; i < exprs.size(); i++) {
+                    result[i] = visitor.apply(exprs[i]);
+                }
+            }
+            return result;
+        }
+#endif
+        for (unsigned i = 0; i < exprs.size(); i++) {
+            result[i] = visitor_.apply(exprs[i]);
+        }
+        return result;
+    }
+};
+
 } // namespace SymEngine
 
 #endif // SYMENGINE_SUBS_H
@@ -3,6 +3,7 @@
 #include <symengine/eval_double.h>
 #include <symengine/derivative.h>
 #include <symengine/symengine_exception.h>
+#include <symengine/intern.h>
 #include <cstring>
 
 using SymEngine::Basic;
@@ -45,12 +46,15 @@ using SymEngine::rational_class;
 using SymEngine::pi;
 using SymEngine::diff;
 using SymEngine::sdiff;
+using SymEngine::gradient;
 using SymEngine::down_cast;
 using SymEngine::NotImplementedError;
 using SymEngine::ComplexInf;
 using SymEngine::Nan;
 using SymEngine::EulerGamma;
 using SymEngine::atoms;
+using SymEngine::InternTable;
+using SymEngine::sin;
 
 using namespace SymEngine::literals;
 
@@ -558,6 +562,58 @@ TEST_CASE("Diff: Basic", "[basic]")
     REQUIRE(eq(*r1, *r2));
 }
 
+TEST_CASE("Gradient: Basic", "[basic]")
+{
+    RCP<const Symbol> x = symbol("x");
+    RCP<const Symbol> y = symbol("y");
+    RCP<const Symbol> z = symbol("z");
+    RCP<const Basic> i2 = integer(2);
+    vec_basic r;
+
+    r = gradient(add(mul(x, y), pow(x, i2)), {x, y, z});
+    REQUIRE(r.size() == 3);
+    REQUIRE(eq(*r[0], *add(y, mul(i2, x))));
+    REQUIRE(eq(*r[1], *x));
+    REQUIRE(eq(*r[2], *zero));
+
+    r = gradient(y, {x, y});
+    REQUIRE(eq(*r[0], *zero));
+    REQUIRE(eq(*r[1], *one));
+    r = gradient(pi, {x});
+    REQUIRE(eq(*r[0], *zero));
+
+    // Nodes without a reverse mode rule are differentiated by `diff`
+    RCP<const Basic> f = function_symbol("f", {x, y});
+    r = gradient(add(mul(x, f), abs(x)), {x, y});
+    REQUIRE(eq(*r[0], *add(diff(mul(x, f), x), diff(abs(x), x))));
+    REQUIRE(eq(*r[1], *mul(x, diff(f, y))));
+
+    // A DAG whose tree is much larger
+    RCP<const Basic> e = add(sin(mul(x, y)), pow(y, x));
+    for (int i = 0; i < 5; i++) {
+        e = add(mul(e, cos(e)), div(sin(e), add(z, i2)));
+    }
+    r = gradient(e, {x, y, z});
+    map_basic_basic point = {{x, real_double(0.3)},
+                             {y, real_double(0.7)},
+                             {z, real_double(1.1)}};
+    REQUIRE(std::abs(eval_double(*sub(r[0], diff(e, x))->subs(point)))
+            < 1e-8);
+    REQUIRE(std::abs(eval_double(*sub(r[1], diff(e, y))->subs(point)))
+            < 1e-8);
+    REQUIRE(std::abs(eval_double(*sub(r[2], diff(e, z))->subs(point)))
+            < 1e-8);
+
+    // The terms of an Add are temporaries, freed ones must not be mistaken
+    // for later ones allocated at the same address
+    RCP<const Symbol> w = symbol("w");
+    e = mul(sin(add(mul(integer(3), z), w)),
+            cos(add(mul(i2, sin(x)), w)));
+    r = gradient(e, {x});
+    REQUIRE(eq(*r[0], *diff(e, x)));
+    REQUIRE(neq(*r[0], *zero));
+}
+
 TEST_CASE("compare: Basic", "[basic]")
 {
     RCP<const Basic> r1, r2;
@@ -1039,3 +1095,140 @@ TEST_CASE("args: Basic", "[basic]")
     r1 = log(pi);
     REQUIRE(vec_basic_eq_perm(r1->get_args(), {pi}));
 }
+
+TEST_CASE("intern: Basic", "[basic]")
+{
+    RCP<const Basic> x = symbol("x");
+    RCP<const Basic> y = symbol("y");
+    RCP<const Basic> r1, r2, i1, i2;
+    InternTable t;
+
+    r1 = add(mul(x, y), pow(x, integer(2)));
+    r2 = add(pow(x, integer(2)), mul(y, x));
+    REQUIRE(r1.get() != r2.get());
+    REQUIRE(eq(*r1, *r2));
+
+    i1 = t.intern(r1);
+    i2 = t.intern(r2);
+    REQUIRE(i1.get() == i2.get());
+    REQUIRE(i1.get() == r1.get());
+    REQUIRE(t.is_interned(*r1));
+    REQUIRE(not t.is_interned(*r2));
+
+    // Subexpressions are shared between interned expressions
+    r1 = sin(mul(symbol("x"), symbol("y")));
+    i1 = t.intern(r1);
+    REQUIRE(eq(*i1, *r1));
+    i2 = t.intern(mul(x, y));
+    REQUIRE(i2.get() == down_cast<const SymEngine::Sin &>(*i1).get_arg().get());
+    REQUIRE(t.lookup(pow(x, integer(2))).get() != nullptr);
+    REQUIRE(t.lookup(pow(y, integer(3))) == SymEngine::null);
+
+    size_t n = t.size();
+    t.intern(add(mul(y, x), pow(x, integer(2))));
+    REQUIRE(t.size() == n);
+
+    t.clear();
+    REQUIRE(t.size() == 0);
+
+    i1 = SymEngine::intern(add(x, y));
+    i2 = SymEngine::intern(add(y, x));
+    REQUIRE(i1.get() == i2.get());
+}
+
+TEST_CASE("dumps and loads: Basic", "[basic]")
+{
+    RCP<const Symbol> x = symbol("x");
+    RCP<const Basic> y = symbol("y");
+    RCP<const Basic> d = SymEngine::dummy("d");
+    RCP<const Integer> big
+        = integer(SymEngine::integer_class("-123456789012345678901234567890"));
+    vec_basic exprs = {
+        integer(0),
+        integer(-7),
+        big,
+        Rational::from_two_ints(*integer(-3), *integer(7)),
+        Complex::from_two_nums(*big, *integer(2)),
+        real_double(0.1),
+        complex_double(std::complex<double>(1.5, -2.25)),
+        SymEngine::Inf,
+        ComplexInf,
+        Nan,
+        pi,
+        EulerGamma,
+        add(mul(integer(3), pow(x, big)), div(y, x)),
+        pow(add(x, y), div(integer(1), integer(3))),
+        mul(sin(x), SymEngine::loggamma(SymEngine::abs(y))),
+        SymEngine::atan2(x, y),
+        SymEngine::max({x, y, integer(2)}),
+        SymEngine::levi_civita({x, y, integer(1)}),
+        function_symbol("f", {x, add(x, y)}),
+        diff(function_symbol("f", {x, y}), x),
+        SymEngine::Subs::create(diff(function_symbol("f", x), x), {{x, y}}),
+        SymEngine::piecewise({{x, SymEngine::Lt(x, y)},
+                              {y, SymEngine::boolTrue}}),
+        SymEngine::logical_and({SymEngine::Le(x, y),
+                                SymEngine::logical_not(SymEngine::Eq(x, y))}),
+        SymEngine::contains(x, SymEngine::interval(integer(0), integer(2),
+                                                   true, false)),
+        SymEngine::finiteset({x, y, integer(1)}),
+        SymEngine::emptyset(),
+    };
+    for (auto &e : exprs) {
+        RCP<const Basic> r = Basic::loads(e->dumps());
+        REQUIRE(eq(*r, *e));
+    }
+
+    // Dummies are loaded as new dummies
+    RCP<const Basic> r = Basic::loads(add(d, pow(d, x))->dumps());
+    REQUIRE(neq(*r, *add(d, pow(d, x))));
+    REQUIRE(free_symbols(*r).size() == 2);
+    // but distinct dummies stay distinct
+    r = Basic::loads(add(d, SymEngine::dummy("d"))->dumps());
+    REQUIRE(free_symbols(*r).size() == 2);
+
+    // Shared subexpressions are stored once
+    RCP<const Basic> e = x;
+    for (int i = 0; i < 16; i++) {
+        e = add(pow(e, integer(2)), sin(e));
+    }
+    std::string s = e->dumps();
+    REQUIRE(s.size() < 400);
+    REQUIRE(eq(*Basic::loads(s), *e));
+
+    CHECK_THROWS_AS(Basic::loads(""), SymEngine::SymEngineException &);
+    CHECK_THROWS_AS(Basic::loads("SyEn"), SymEngine::SymEngineException &);
+    CHECK_THROWS_AS(Basic::loads(s.substr(0, s.size() - 1)),
+                    SymEngine::SymEngineException &);
+    s[4] = 100;
+    CHECK_THROWS_AS(Basic::loads(s), SymEngine::SymEngineException &);
+
+    // Malformed data: the nodes x, 0 and 1, followed by a node that is not
+    // canonical or refers to a node that does not exist
+    auto node = [](SymEngine::TypeID id, const std::string &data) {
+        return std::string(1, static_cast<char>(id)) + data;
+    };
+    const std::string h
+        = std::string("SyEn\x01") + node(SymEngine::SYMBOL, "\x01x")
+          + node(SymEngine::INTEGER, std::string("\0\0", 2))
+          + node(SymEngine::INTEGER, std::string("\0\x02", 2));
+    REQUIRE(eq(*Basic::loads(h), *one));
+    // 0 + x
+    s = h + node(SymEngine::ADD, std::string("\x01\x01\0\x02", 4));
+    CHECK_THROWS_AS(Basic::loads(s), SymEngine::SymEngineException &);
+    // 1 * x**1
+    s = h + node(SymEngine::MUL, std::string("\x02\x01\0\x02", 4));
+    CHECK_THROWS_AS(Basic::loads(s), SymEngine::SymEngineException &);
+    // x**1
+    s = h + node(SymEngine::POW, std::string("\x02\0\x02", 3));
+    CHECK_THROWS_AS(Basic::loads(s), SymEngine::SymEngineException &);
+    // Derivative of x w.r.t. 1
+    s = h + node(SymEngine::DERIVATIVE, std::string("\0\x01\x02", 3));
+    CHECK_THROWS_AS(Basic::loads(s), SymEngine::SymEngineException &);
+    // sin of the node 3
+    s = h + node(SymEngine::SIN, std::string("\x01\x03", 2));
+    CHECK_THROWS_AS(Basic::loads(s), SymEngine::SymEngineException &);
+    // Integer with a truncated word
+    s = h + node(SymEngine::INTEGER, std::string("\x01\x01\xff", 3));
+    CHECK_THROWS_AS(Basic::loads(s), SymEngine::SymEngineException &);
+}
@@ -335,3 +335,34 @@ TEST_CASE("CSE: regression test gh-1463", "[cse]")
         cse(substs, reduced, {e1, e1, e3, e4, e4, e6, e7, e7, e9});
     }
 }
+
+TEST_CASE("CSE: deep expressions", "[cse]")
+{
+    RCP<const Basic> x = symbol("x");
+    RCP<const Basic> x0 = symbol("x0");
+    RCP<const Basic> y = symbol("y");
+    RCP<const Basic> i2 = integer(2);
+
+    // Deeper than the recursion limit of the former implementation. The
+    // destructors of the nodes still recurse, so the levels are kept in
+    // `chain` and released from the top one at a time.
+    vec_basic chain = {x};
+    for (int i = 0; i < 20000; i++) {
+        chain.push_back(sin(add(chain.back(), y)));
+    }
+    RCP<const Basic> e = chain.back();
+    vec_pair substs;
+    vec_basic reduced;
+    cse(substs, reduced, {add(e, one), mul(e, i2)});
+    REQUIRE(substs.size() == 1);
+    REQUIRE(eq(*substs[0].first, *x0));
+    // The expression is not rebuilt, as nothing in it is replaced
+    REQUIRE(substs[0].second.get() == e.get());
+    REQUIRE(unified_eq(reduced, {add(x0, one), mul(x0, i2)}));
+
+    substs.clear();
+    e.reset();
+    while (not chain.empty()) {
+        chain.pop_back();
+    }
+}
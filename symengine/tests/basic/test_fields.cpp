@@ -1001,3 +1001,43 @@ TEST_CASE("GaloisFieldDict eval : Basic", "[basic]")
     std::vector<integer_class> resa = {1_z, 6_z, 6_z, 1_z};
     REQUIRE(d1.gf_multi_eval({0_z, 1_z, 2_z, 3_z}) == resa);
 }
+
+TEST_CASE("GaloisFieldDict on machine words : Basic", "[basic]")
+{
+    // Mersenne prime 2**61 - 1, the arithmetic runs on words
+    const integer_class p = 2305843009213693951_z;
+    GaloisFieldDict f = GaloisFieldDict::from_vec(
+        {3_z, 1_z, 4_z, 1_z, 5_z, 9_z, 2_z, p - 6_z}, p);
+    GaloisFieldDict g
+        = GaloisFieldDict::from_vec({2_z, 7_z, 1_z, 8_z, 2_z, 8_z}, p);
+    GaloisFieldDict h = GaloisFieldDict::from_vec({p - 5_z, 0_z, 1_z}, p);
+    REQUIRE(f.has_word_modulo());
+
+    GaloisFieldDict fg = f * g;
+    REQUIRE(fg.degree() == 12);
+    std::vector<integer_class> x = {0_z, 1_z, 2_z, p - 1_z, p + 3_z, 10_z * p};
+    std::vector<integer_class> fgx = fg.gf_multi_eval(x);
+    for (size_t i = 0; i < x.size(); i++) {
+        REQUIRE(fgx[i] == fg.gf_eval(x[i]));
+        REQUIRE(fgx[i] == f.gf_eval(x[i]) * g.gf_eval(x[i]) % p);
+    }
+
+    GaloisFieldDict quo, rem;
+    (fg + h).gf_div(g, outArg(quo), outArg(rem));
+    REQUIRE(quo == f);
+    REQUIRE(rem == h);
+    REQUIRE(fg / g == f);
+    REQUIRE((fg + h) % g == h);
+    REQUIRE((f * h).gf_gcd(g * h) == h);
+    REQUIRE(f.gf_gcd(g).is_one());
+
+    // Odd moduli above 2**63 keep the integer_class arithmetic
+    const integer_class q = 170141183460469231731687303715884105727_z;
+    GaloisFieldDict F = GaloisFieldDict::from_vec(f.get_dict(), q);
+    GaloisFieldDict G = GaloisFieldDict::from_vec(g.get_dict(), q);
+    REQUIRE(not F.has_word_modulo());
+    (F * G).gf_div(G, outArg(quo), outArg(rem));
+    REQUIRE(quo == F);
+    REQUIRE(rem.empty());
+}
+
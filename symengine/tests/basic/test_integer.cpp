@@ -90,3 +90,45 @@ TEST_CASE("fix#461: integer", "[integer]")
     ir = integer(val);
     REQUIRE(val == ir->as_integer_class());
 }
+
+TEST_CASE("small integers: integer", "[integer]")
+{
+    RCP<const Integer> r1, r2;
+
+    // Small integers are preallocated
+    REQUIRE(integer(5).get() == integer(5).get());
+    REQUIRE(integer(-256).get() == integer(-256l).get());
+    REQUIRE(integer(1024u).get() == integer(integer_class(1024)).get());
+    REQUIRE(integer(1025).get() != integer(1025).get());
+    REQUIRE(integer(-257).get() != integer(-257).get());
+
+    r1 = integer(3)->addint(*integer(4));
+    REQUIRE(r1.get() == integer(7).get());
+    r1 = integer(3)->subint(*integer(4));
+    REQUIRE(r1.get() == integer(-1).get());
+    r1 = integer(-30)->mulint(*integer(40));
+    REQUIRE(eq(*r1, *integer(-1200)));
+    r1 = integer(40)->neg();
+    REQUIRE(r1.get() == integer(-40).get());
+
+    // Machine word arithmetic is promoted to integer_class on overflow
+    long lmax = std::numeric_limits<long>::max();
+    long lmin = std::numeric_limits<long>::min();
+    long b = SymEngine::small_int_bound;
+    r1 = integer(lmax)->addint(*integer(1));
+    REQUIRE(r1->as_integer_class() == integer_class(lmax) + 1);
+    r1 = integer(lmin)->subint(*integer(1));
+    REQUIRE(r1->as_integer_class() == integer_class(lmin) - 1);
+    r1 = integer(lmin)->neg();
+    REQUIRE(r1->as_integer_class() == -integer_class(lmin));
+    r1 = integer(b - 1)->mulint(*integer(b - 1));
+    REQUIRE(r1->as_integer_class()
+            == integer_class(b - 1) * integer_class(b - 1));
+    r1 = integer(b)->mulint(*integer(-b));
+    REQUIRE(r1->as_integer_class() == integer_class(b) * integer_class(-b));
+    r2 = integer(lmax)->mulint(*integer(lmax));
+    REQUIRE(r2->as_integer_class()
+            == integer_class(lmax) * integer_class(lmax));
+    r2 = r2->subint(*r2);
+    REQUIRE(r2.get() == integer(0).get());
+}
@@ -4,6 +4,7 @@
 #include <symengine/add.h>
 #include <symengine/pow.h>
 #include <symengine/rings.h>
+#include <symengine/functions.h>
 #include <symengine/monomials.h>
 #include <symengine/symengine_exception.h>
 
@@ -19,12 +20,18 @@ using SymEngine::Integer;
 using SymEngine::integer;
 using SymEngine::map_vec_mpz;
 using SymEngine::expr2poly;
+using SymEngine::poly2expr;
+using SymEngine::poly_gens;
+using SymEngine::vec_basic;
+using SymEngine::sqrt;
+using SymEngine::sin;
 using SymEngine::vec_int;
 using SymEngine::monomial_mul;
 using SymEngine::poly_mul;
 using SymEngine::umap_vec_mpz;
 using SymEngine::RCP;
 using SymEngine::rcp_dynamic_cast;
+using SymEngine::rcp_static_cast;
 using SymEngine::print_stack_on_segfault;
 
 TEST_CASE("monomial_mul: poly", "[poly]")
@@ -88,3 +95,146 @@ TEST_CASE("expand: poly", "[poly]")
                      .count()
               << "ms" << std::endl;
 }
+
+TEST_CASE("poly2expr: poly", "[poly]")
+{
+    RCP<const Basic> x = symbol("x");
+    RCP<const Basic> y = symbol("y");
+    RCP<const Basic> s2 = sqrt(integer(2));
+    RCP<const Basic> e, f, g, r;
+
+    e = expand(pow(add(add(x, sin(y)), integer(3)), integer(4)));
+    umap_basic_num syms;
+    REQUIRE(poly_gens(e, syms));
+    REQUIRE(syms.size() == 2);
+    vec_basic gens(2);
+    for (const auto &p : syms)
+        gens[rcp_static_cast<const Integer>(p.second)->as_int()] = p.first;
+    umap_vec_mpz P;
+    expr2poly(e, syms, P);
+    REQUIRE(P.size() == 15);
+    REQUIRE(eq(*poly2expr(P, gens), *e));
+
+    syms.clear();
+    REQUIRE(not poly_gens(add(x, div(y, integer(2))), syms));
+    REQUIRE(not poly_gens(add(x, pow(y, div(integer(1), integer(2)))), syms));
+
+    // Large products of sums are multiplied as sparse polynomials
+    f = expand(pow(add(x, integer(1)), integer(10)));
+    g = expand(pow(add(x, integer(-1)), integer(10)));
+    r = expand(mul(f, g));
+    REQUIRE(eq(*r, *expand(pow(add(pow(x, integer(2)), integer(-1)),
+                               integer(10)))));
+
+    f = expand(pow(add(add(x, y), s2), integer(6)));
+    g = expand(pow(sub(add(x, y), s2), integer(6)));
+    r = expand(mul(f, g));
+    e = expand(pow(add(x, y), integer(2)));
+    REQUIRE(eq(*r, *expand(pow(add(e, integer(-2)), integer(6)))));
+
+    f = expand(add(pow(add(x, y), integer(9)), div(x, y)));
+    r = expand(mul(f, sub(f, x)));
+    g = expand(mul(pow(add(x, y), integer(9)), sub(f, x)));
+    e = expand(mul(div(x, y), sub(f, x)));
+    REQUIRE(eq(*r, *add(g, e)));
+}
+
+TEST_CASE("poly_mul: threads", "[poly]")
+{
+    RCP<const Basic> x = symbol("x");
+    RCP<const Basic> y = symbol("y");
+    RCP<const Basic> z = symbol("z");
+    RCP<const Basic> w = symbol("w");
+    RCP<const Basic> e, f1, f2, r1, r2;
+
+    e = pow(add(add(add(x, y), z), w), integer(8));
+    f1 = expand(e);
+    f2 = expand(add(e, w));
+
+    umap_basic_num syms;
+    insert(syms, x, integer(0));
+    insert(syms, y, integer(1));
+    insert(syms, z, integer(2));
+    insert(syms, w, integer(3));
+    umap_vec_mpz P1, P2, C1, C2;
+    expr2poly(f1, syms, P1);
+    expr2poly(f2, syms, P2);
+    poly_mul(P1, P2, C1);
+    poly_mul(P1, P2, C2, 3);
+    REQUIRE(C1 == C2);
+
+    // Large enough to be split between threads when built with OpenMP
+    e = pow(add(add(add(x, y), z), w), integer(12));
+    f1 = expand(e);
+    f2 = expand(add(e, w));
+    e = pow(add(add(add(add(x, y), z), w), integer(1)), integer(16));
+    SymEngine::set_expand_num_threads(1);
+    r1 = expand(mul(f1, f2));
+    RCP<const Basic> p1 = expand(e);
+    SymEngine::set_expand_num_threads(4);
+    REQUIRE(SymEngine::get_expand_num_threads() == 4);
+    r2 = expand(mul(f1, f2));
+    REQUIRE(eq(*r1, *r2));
+    REQUIRE(eq(*expand(e), *p1));
+    SymEngine::set_expand_num_threads(0);
+}
+
+TEST_CASE("packed monomials: poly", "[poly]")
+{
+    using SymEngine::MonomialPacking;
+    using SymEngine::PackedMonomial;
+
+    MonomialPacking p;
+    REQUIRE(p.init({-3, 0, 5}, {4, 1000, 5}));
+    vec_int a = {-3, 17, 5}, b = {2, 1000, 5}, c(3);
+    PackedMonomial m = p.pack(a);
+    p.unpack(m, c);
+    REQUIRE(c == a);
+    REQUIRE(p.pack(b) != m);
+    p.unpack(p.pack(b), c);
+    REQUIRE(c == b);
+
+    // A product is a word addition of monomials packed relative to the lower
+    // bounds of the factors
+    MonomialPacking q;
+    REQUIRE(q.init({0, -2}, {60, 2}));
+    PackedMonomial x = q.with_offsets({0, -1}).pack(vec_int{20, 1});
+    PackedMonomial y = q.with_offsets({0, -1}).pack(vec_int{40, -1});
+    vec_int xy(2);
+    q.with_offsets({0, -2}).unpack(monomial_mul(x, y), xy);
+    REQUIRE(xy == (vec_int{60, 0}));
+
+    // 30 exponents of 4 bits need both words, 30 of 8 bits do not fit
+    std::vector<std::int64_t> lo(30, 0), hi(30, 15);
+    REQUIRE(p.init(lo, hi));
+    vec_int d(30), e(30);
+    for (int i = 0; i < 30; i++)
+        d[i] = i % 16;
+    p.unpack(p.pack(d), e);
+    REQUIRE(d == e);
+    hi.assign(30, 255);
+    REQUIRE(not p.init(lo, hi));
+
+    umap_vec_mpz P1, P2, C1, C2;
+    P1[{1, 0}] = 1;
+    P1[{0, 1}] = 1;
+    P2[{1, 0}] = 1;
+    P2[{0, -1}] = -1;
+    poly_mul(P1, P2, C1);
+    REQUIRE(C1.size() == 4);
+    REQUIRE(C1[vec_int({2, 0})] == 1);
+    REQUIRE(C1[vec_int({0, 0})] == -1);
+
+    // Exponents that do not fit in two words are multiplied as vectors
+    int big = 1 << 28;
+    P1.clear();
+    P2.clear();
+    P1[{1, 0, 0, 0, 0}] = 1;
+    P1[{0, big, big, big, big}] = 2;
+    P2[{big, 0, 0, 0, 0}] = 3;
+    P2[{0, big, big, big, big}] = -1;
+    poly_mul(P1, P2, C2);
+    REQUIRE(C2.size() == 4);
+    REQUIRE(C2[vec_int({big + 1, 0, 0, 0, 0})] == 3);
+    REQUIRE(C2[vec_int({0, 2 * big, 2 * big, 2 * big, 2 * big})] == -2);
+}
@@ -145,6 +145,21 @@ TEST_CASE("Multiplication of two UExprDict with precision",
 
     REQUIRE(e == c);
     REQUIRE(f == d);
+
+    // Rational coefficients and negative exponents
+    UExprDict g({{-1, Expression(rational(1, 2))}, {1, 3}, {3, 1}});
+    UExprDict h({{-2, 2}, {0, Expression(rational(-2, 3))}});
+    UExprDict i({{-3, 1}, {-1, Expression(rational(17, 3))}});
+    REQUIRE(UnivariateSeries::mul(g, h, 0) == i);
+    REQUIRE(UnivariateSeries::mul(g, h, 2) == i);
+
+    // Symbolic coefficients
+    Expression y(symbol("y"));
+    UExprDict j({{0, y}, {1, 1}, {2, y}});
+    UExprDict k({{0, y * y}, {1, 2 * y}, {2, 2 * y * y + 1}});
+    REQUIRE(UnivariateSeries::mul(j, j, 3) == k);
+    UExprDict l({{-2, 2 * y}, {-1, 2}});
+    REQUIRE(UnivariateSeries::mul(j, h, 0) == l);
 }
 
 TEST_CASE("Exponentiation of UExprDict with precision", "[UnivariateSeries]")
@@ -37,6 +37,8 @@ using SymEngine::finiteset;
 using SymEngine::E;
 using SymEngine::is_a;
 using SymEngine::down_cast;
+using SymEngine::SubsPlan;
+using SymEngine::vec_basic;
 
 TEST_CASE("Symbol: subs", "[subs]")
 {
@@ -551,3 +553,60 @@ TEST_CASE("SSubs: subs", "[ssubs]")
     auto t = ssubs(f->diff(x), {{f, g}});
     REQUIRE(eq(*t, *g->diff(x)));
 }
+
+TEST_CASE("Shared subexpressions: subs", "[subs]")
+{
+    RCP<const Basic> x = symbol("x");
+    RCP<const Basic> y = symbol("y");
+    RCP<const Basic> i2 = integer(2);
+
+    // Every level uses the one below twice, the tree has 2**depth paths
+    RCP<const Basic> e = x, r = y;
+    for (int i = 0; i < 10; i++) {
+        e = add(sin(e), mul(i2, pow(e, i2)));
+        r = add(sin(r), mul(i2, pow(r, i2)));
+    }
+    REQUIRE(eq(*e->subs({{x, y}}), *r));
+    REQUIRE(eq(*xreplace(e, {{x, y}}), *r));
+
+    for (int i = 10; i < 60; i++) {
+        e = add(sin(e), mul(i2, pow(e, i2)));
+        r = add(sin(r), mul(i2, pow(r, i2)));
+    }
+    // Comparing such DAGs with `eq` takes exponential time, compare hashes
+    REQUIRE(e->subs({{x, y}})->hash() == r->hash());
+
+    // Terms and factors that are substituted as a whole
+    e = add(mul(i2, x), mul(x, pow(y, i2)));
+    REQUIRE(eq(*e->subs({{mul(i2, x), y}}), *add(y, mul(x, pow(y, i2)))));
+    REQUIRE(eq(*e->subs({{pow(y, i2), x}}), *add(mul(i2, x), pow(x, i2))));
+}
+
+TEST_CASE("SubsPlan", "[subs]")
+{
+    RCP<const Basic> x = symbol("x");
+    RCP<const Basic> y = symbol("y");
+    RCP<const Basic> z = symbol("z");
+    RCP<const Basic> i2 = integer(2);
+
+    RCP<const Basic> s = sin(add(x, y));
+    vec_basic exprs = {add(s, z), mul(s, z), pow(z, i2), x};
+    map_basic_basic d = {{x, y}};
+    SubsPlan plan(d);
+    vec_basic r = plan.apply(exprs);
+    REQUIRE(r.size() == 4);
+    REQUIRE(eq(*r[0], *add(sin(mul(i2, y)), z)));
+    REQUIRE(eq(*r[1], *mul(sin(mul(i2, y)), z)));
+    // Expressions without `x` are returned as they are
+    REQUIRE(r[2] == exprs[2]);
+    REQUIRE(eq(*r[3], *y));
+    // The cache of the plan is kept between the calls
+    RCP<const Basic> t = plan.apply(s);
+    const auto &dict = down_cast<const Add &>(*r[0]).get_dict();
+    REQUIRE(dict.find(t) != dict.end());
+    REQUIRE(dict.find(t)->first.get() == t.get());
+
+    r = plan.apply(exprs, false);
+    REQUIRE(eq(*r[1], *mul(sin(mul(i2, y)), z)));
+    REQUIRE(eq(*plan.apply(add(s, x)), *add(sin(mul(i2, y)), y)));
+}
@@ -2149,6 +2149,34 @@ void test_cse()
     vecbasic_free(reduced_exprs);
 }
 
+void test_dumps_loads()
+{
+    basic x, y, r, s;
+    basic_new_stack(x);
+    basic_new_stack(y);
+    basic_new_stack(r);
+    basic_new_stack(s);
+
+    symbol_set(x, "x");
+    integer_set_str(y, "123456789012345678901234567890");
+    basic_pow(r, x, y);
+    basic_sin(y, r);
+    basic_add(r, r, y);
+
+    unsigned long size;
+    char *c;
+    SYMENGINE_C_ASSERT(basic_dumps(&c, &size, r) == SYMENGINE_NO_EXCEPTION);
+    SYMENGINE_C_ASSERT(basic_loads(s, c, size) == SYMENGINE_NO_EXCEPTION);
+    SYMENGINE_C_ASSERT(basic_eq(r, s));
+    SYMENGINE_C_ASSERT(basic_loads(s, c, size - 1) != SYMENGINE_NO_EXCEPTION);
+
+    basic_str_free(c);
+    basic_free_stack(x);
+    basic_free_stack(y);
+    basic_free_stack(r);
+    basic_free_stack(s);
+}
+
 int main(int argc, char *argv[])
 {
     symengine_print_stack_on_segfault();
@@ -2190,5 +2218,6 @@ int main(int argc, char *argv[])
     test_matrix();
     test_lambda_double();
     test_cse();
+    test_dumps_loads();
     return 0;
 }
@@ -5,6 +5,8 @@
 #include <symengine/symengine_exception.h>
 
 #ifdef HAVE_SYMENGINE_LLVM
+#include <llvm/ADT/SmallString.h>
+#include <llvm/Support/FileSystem.h>
 #include <symengine/llvm_double.h>
 using SymEngine::LLVMDoubleVisitor;
 #endif
@@ -23,6 +25,7 @@ using SymEngine::NegInf;
 using SymEngine::boolTrue;
 using SymEngine::LambdaRealDoubleVisitor;
 using SymEngine::LambdaComplexDoubleVisitor;
+using SymEngine::LambdaRealDoubleBatchVisitor;
 using SymEngine::max;
 using SymEngine::sin;
 using SymEngine::cos;
@@ -59,6 +62,8 @@ using SymEngine::piecewise;
 using SymEngine::Eq;
 using SymEngine::Ne;
 using SymEngine::Lt;
+using SymEngine::div;
+using SymEngine::sqrt;
 using SymEngine::Le;
 using SymEngine::NotImplementedError;
 using SymEngine::SymEngineException;
@@ -220,6 +225,55 @@ TEST_CASE("Evaluate functions", "[lambda_gamma]")
     }
 }
 
+TEST_CASE("Evaluate batches", "[lambda_double_batch]")
+{
+    RCP<const Basic> x, y, z, r;
+    x = symbol("x");
+    y = symbol("y");
+    z = symbol("z");
+
+    r = add(mul(sin(x), pow(y, integer(3))),
+            pow(add(x, z), div(integer(-1), integer(2))));
+    vec_basic outputs = {
+        r,
+        mul(r, add(r, pow(E, mul(x, y)))),
+        add(mul(integer(3), x), pow(y, z)),
+        mul(atan2(x, y), add(log(z), sqrt(y))),
+        add(max({x, y, z}), pow(x, integer(-1))),
+        piecewise({{x, Lt(x, y)}, {pow(x, integer(2)), boolTrue}}),
+        add(z, SymEngine::pi),
+        y,
+    };
+
+    const size_t n = 1000;
+    std::vector<double> inps(3 * n), outs(outputs.size() * n);
+    for (size_t i = 0; i < n; i++) {
+        inps[i] = 0.1 + 0.002 * i;
+        inps[n + i] = 1.5 - 0.001 * i;
+        inps[2 * n + i] = 0.5 + 0.003 * i;
+    }
+
+    LambdaRealDoubleVisitor v;
+    v.init({x, y, z}, outputs);
+    std::vector<double> d(outputs.size());
+    for (bool cse : {false, true}) {
+        LambdaRealDoubleBatchVisitor b;
+        b.init({x, y, z}, outputs, cse);
+        b.call(outs.data(), inps.data(), n);
+        for (size_t i = 0; i < n; i++) {
+            double point[] = {inps[i], inps[n + i], inps[2 * n + i]};
+            v.call(d.data(), point);
+            for (size_t k = 0; k < outputs.size(); k++) {
+                REQUIRE(::fabs(outs[k * n + i] - d[k])
+                        <= 1e-12 * ::fabs(d[k]));
+            }
+        }
+    }
+
+    LambdaRealDoubleBatchVisitor b;
+    CHECK_THROWS_AS(b.init({x}, *add(x, y)), SymEngineException &);
+}
+
 #ifdef HAVE_SYMENGINE_LLVM
 TEST_CASE("Check llvm and lambda are equal", "[llvm_double]")
 {
@@ -365,4 +419,97 @@ TEST_CASE("Check that our default LLVM passes give correct results",
         REQUIRE(::fabs((d - d2) / d) < 1e-12);
     }
 }
+
+TEST_CASE("Check llvm batches", "[llvm_double]")
+{
+    RCP<const Basic> x, y, z, r;
+    x = symbol("x");
+    y = symbol("y");
+    z = symbol("z");
+
+    r = add(mul(sin(x), pow(y, integer(3))), mul(cos(z), log(y)));
+    vec_basic outputs = {
+        r,
+        mul(r, add(r, pow(E, mul(x, y)))),
+        add(pow(y, z), tan(x)),
+        add(pow(integer(2), z), pow(x, integer(-1))),
+    };
+
+    // Not a multiple of any vector width, to check the remainder loop
+    const size_t n = 1001, stride = 1003;
+    std::vector<double> inps(3 * stride), outs(outputs.size() * stride);
+    for (size_t i = 0; i < n; i++) {
+        inps[i] = 0.1 + 0.002 * i;
+        inps[stride + i] = 1.5 - 0.001 * i;
+        inps[2 * stride + i] = 0.5 + 0.003 * i;
+    }
+
+    LLVMDoubleVisitor v;
+    v.init({x, y, z}, outputs);
+    std::vector<double> d(outputs.size());
+    CHECK_THROWS_AS(v.call(outs.data(), inps.data(), n), SymEngineException &);
+    for (unsigned width : {0, 2, 4}) {
+        LLVMDoubleVisitor b;
+        b.init({x, y, z}, outputs, true, 2, width);
+        b.call(outs.data(), inps.data(), n, stride, stride);
+        for (size_t i = 0; i < n; i++) {
+            double point[] = {inps[i], inps[stride + i], inps[2 * stride + i]};
+            v.call(d.data(), point);
+            for (size_t k = 0; k < outputs.size(); k++) {
+                REQUIRE(::fabs(outs[k * stride + i] - d[k])
+                        <= 1e-12 * ::fabs(d[k]));
+            }
+        }
+    }
+}
+
+TEST_CASE("Check llvm object cache", "[llvm_double]")
+{
+    RCP<const Basic> x, y, z, r;
+    x = symbol("x");
+    y = symbol("y");
+    z = symbol("z");
+
+    r = add(sin(x), add(mul(pow(y, integer(4)), mul(z, integer(2))),
+                        pow(sin(x), integer(2))));
+
+    llvm::SmallString<128> dir;
+    REQUIRE(not llvm::sys::fs::createUniqueDirectory("symengine_llvm_cache",
+                                                     dir));
+    LLVMDoubleVisitor::set_cache_directory(dir.str().str());
+    const size_t hits = LLVMDoubleVisitor::get_cache_hits();
+    LLVMDoubleVisitor v, v2, v3;
+    v.init({x, y, z}, *r);
+    REQUIRE(LLVMDoubleVisitor::get_cache_hits() == hits);
+    // Loaded from the cache
+    v2.init({x, y, z}, *r);
+    REQUIRE(LLVMDoubleVisitor::get_cache_hits() == hits + 1);
+    REQUIRE(v.dumps() == v2.dumps());
+    // Only differs in the 17th digit, compiled again
+    v3.init({x, y, z}, *add(r, real_double(0.10000000000000002)));
+    REQUIRE(LLVMDoubleVisitor::get_cache_hits() == hits + 1);
+    // The batch function is loaded from the cache too
+    LLVMDoubleVisitor b, b2;
+    b.init({x, y, z}, {r}, true, 2, 2);
+    REQUIRE(LLVMDoubleVisitor::get_cache_hits() == hits + 1);
+    b2.init({x, y, z}, {r}, true, 2, 2);
+    REQUIRE(LLVMDoubleVisitor::get_cache_hits() == hits + 2);
+    LLVMDoubleVisitor::set_cache_directory("");
+    llvm::sys::fs::remove_directories(dir);
+
+    double d = v.call({0.4, 2.0, 3.0});
+    double d2 = v2.call({0.4, 2.0, 3.0});
+    double d3 = v3.call({0.4, 2.0, 3.0});
+    REQUIRE(::fabs((d - d2) / d) < 1e-12);
+    REQUIRE(::fabs((d + 0.1 - d3) / d3) < 1e-12);
+
+    const double inps[] = {0.4, 0.5, 0.6, 2.0, 2.5, 3.0, 3.0, 3.5, 4.0};
+    double outs[3], outs2[3];
+    b.call(outs, inps, 3);
+    b2.call(outs2, inps, 3);
+    REQUIRE(::fabs((outs[0] - d) / d) < 1e-12);
+    for (unsigned i = 0; i < 3; i++) {
+        REQUIRE(outs[i] == outs2[i]);
+    }
+}
 #endif
@@ -2,6 +2,7 @@
 #include <chrono>
 
 #include <symengine/matrix.h>
+#include <symengine/numeric_matrix.h>
 #include <symengine/add.h>
 #include <symengine/pow.h>
 #include <symengine/symengine_exception.h>
@@ -31,6 +32,13 @@ using SymEngine::eigen_values;
 using SymEngine::finiteset;
 using SymEngine::one;
 using SymEngine::mul;
+using SymEngine::map_basic_basic;
+using SymEngine::JacobianPattern;
+using SymEngine::RealDoubleMatrix;
+using SymEngine::ComplexDoubleMatrix;
+using SymEngine::LambdaJacobian;
+using SymEngine::Complex;
+using SymEngine::real_double;
 
 TEST_CASE("test_get_set(): matrices", "[matrices]")
 {
@@ -1224,6 +1232,70 @@ TEST_CASE("test_determinant(): matrices", "[matrices]")
     REQUIRE(eq(*det_berkowitz(M), *integer(123)));
 }
 
+TEST_CASE("Multimodular det and solve", "[matrices]")
+{
+    unsigned seed = 12345;
+    auto next = [&seed]() {
+        seed = seed * 1103515245u + 12345u;
+        return static_cast<int>((seed >> 16) % 201) - 100;
+    };
+    vec_basic v;
+    for (unsigned k = 0; k < 36; k++) {
+        RCP<const Basic> e = integer(next());
+        if (k % 7 == 0)
+            e = mul(e, pow(integer(10), integer(20)));
+        v.push_back(e);
+    }
+    DenseMatrix A(6, 6, v);
+    REQUIRE(eq(*det_multimodular(A), *det_berkowitz(A)));
+    REQUIRE(eq(*A.det(), *det_berkowitz(A)));
+
+    v.clear();
+    for (unsigned k = 0; k < 25; k++) {
+        v.push_back(SymEngine::Rational::from_two_ints(next(), k % 5 + 1));
+    }
+    DenseMatrix R(5, 5, v);
+    REQUIRE(eq(*det_multimodular(R), *det_berkowitz(R)));
+
+    // Divisible by the first two primes used
+    DenseMatrix D(4, 4);
+    eye(D);
+    D.set(0, 0, integer(1073741827));
+    D.set(1, 1, integer(1073741831));
+    REQUIRE(eq(*det_multimodular(D),
+               *mul(integer(1073741827), integer(1073741831))));
+    REQUIRE(eq(*D.det(), *det_berkowitz(D)));
+    D.set(2, 2, SymEngine::Rational::from_two_ints(1, 3));
+    REQUIRE(eq(*D.det(), *det_berkowitz(D)));
+
+    // Singular
+    DenseMatrix S(4, 4, {integer(1), integer(2), integer(3), integer(4),
+                         integer(2), integer(4), integer(6), integer(8),
+                         integer(5), integer(-1), integer(0), integer(2),
+                         integer(7), integer(3), integer(1), integer(1)});
+    REQUIRE(eq(*det_multimodular(S), *integer(0)));
+    DenseMatrix b(4, 1, {integer(1), integer(2), integer(3), integer(4)});
+    DenseMatrix x(4, 1);
+    REQUIRE(not multimodular_solve(S, b, x));
+
+    b = DenseMatrix(6, 2);
+    for (unsigned i = 0; i < 6; i++) {
+        b.set(i, 0, integer(next()));
+        b.set(i, 1, SymEngine::Rational::from_two_ints(next(), 7));
+    }
+    x = DenseMatrix(6, 2);
+    DenseMatrix y(6, 2);
+    REQUIRE(multimodular_solve(A, b, x));
+    A.mul_matrix(x, y);
+    REQUIRE(y == b);
+    y = DenseMatrix(6, 2);
+    fraction_free_gaussian_elimination_solve(A, b, y);
+    REQUIRE(y == x);
+
+    CHECK_THROWS_AS(det_multimodular(DenseMatrix(1, 1, {symbol("x")})),
+                    SymEngineException &);
+}
+
 TEST_CASE("test_berkowitz(): matrices", "[matrices]")
 {
     std::vector<DenseMatrix> polys;
@@ -1777,6 +1849,31 @@ TEST_CASE("Test Jacobian", "[matrices]")
         == DenseMatrix(2, 2, {integer(1), integer(-1), y, x}));
 }
 
+TEST_CASE("Test JacobianPattern", "[matrices]")
+{
+    RCP<const Symbol> x = symbol("x"), y = symbol("y"), z = symbol("z");
+    JacobianPattern P({mul(x, y), sin(z), integer(1), add(z, x)}, {x, y, z});
+    REQUIRE(P.nrows() == 4);
+    REQUIRE(P.ncols() == 3);
+    REQUIRE(P.nnz() == 5);
+    REQUIRE(P.get_p() == std::vector<unsigned>({0, 2, 3, 3, 5}));
+    REQUIRE(P.get_j() == std::vector<unsigned>({0, 1, 2, 0, 2}));
+
+    REQUIRE(P.evaluate({mul(x, y), sin(z), integer(1), add(z, x)})
+            == DenseMatrix(4, 3, {y, x, integer(0), integer(0), integer(0),
+                                  cos(z), integer(0), integer(0), integer(0),
+                                  integer(1), integer(0), integer(1)}));
+    // Reused for a system with the same dependencies
+    CSRMatrix J = P.evaluate(
+        {add(x, y), mul(integer(2), z), integer(3), mul(x, pow(z, x))});
+    std::vector<unsigned> p, j;
+    vec_basic v;
+    std::tie(p, j, v) = J.as_vectors();
+    REQUIRE(p == P.get_p());
+    REQUIRE(j == P.get_j());
+    REQUIRE(eq(*v[2], *integer(2)));
+}
+
 TEST_CASE("Test Diff", "[matrices]")
 {
     DenseMatrix A, J;
@@ -1795,6 +1892,159 @@ TEST_CASE("Test Diff", "[matrices]")
     REQUIRE(J == DenseMatrix(2, 2, {integer(1), x, z, integer(1)}));
 }
 
+TEST_CASE("Test Subs", "[matrices]")
+{
+    DenseMatrix A, B;
+    RCP<const Symbol> x = symbol("x"), y = symbol("y"), z = symbol("z");
+    A = DenseMatrix(2, 2, {add(x, z), mul(y, z), sin(add(x, z)), y});
+    B = DenseMatrix(2, 2);
+    subs(A, {{x, integer(1)}, {z, integer(2)}}, B);
+    REQUIRE(B == DenseMatrix(2, 2, {integer(3), mul(y, integer(2)),
+                                    sin(integer(3)), y}));
+}
+
+TEST_CASE("Test CSRMatrix det and LU_solve", "[matrices]")
+{
+    RCP<const Symbol> x = symbol("x"), y = symbol("y");
+    // Arrowhead matrix with a zero pivot on the diagonal
+    vec_basic v = {integer(0), integer(1), integer(2), integer(3), integer(4),
+                   integer(1), integer(5), integer(0), integer(0), integer(0),
+                   integer(2), integer(0), integer(7), integer(0), integer(0),
+                   integer(3), integer(0), integer(0), integer(-2), integer(0),
+                   integer(4), integer(0), integer(0), integer(0), integer(9)};
+    std::vector<unsigned> ri, ci;
+    vec_basic nz;
+    for (unsigned k = 0; k < 25; k++) {
+        if (neq(*v[k], *integer(0))) {
+            ri.push_back(k / 5);
+            ci.push_back(k % 5);
+            nz.push_back(v[k]);
+        }
+    }
+    CSRMatrix A = CSRMatrix::from_coo(5, 5, ri, ci, nz);
+    DenseMatrix D(5, 5, v);
+    REQUIRE(eq(*A.det(), *D.det()));
+
+    DenseMatrix X(5, 2, {integer(1), integer(-1), integer(2), integer(0),
+                         integer(3), integer(5), integer(4), integer(1),
+                         integer(5), integer(2)});
+    DenseMatrix b(5, 2), s(5, 2);
+    D.mul_matrix(X, b);
+    A.LU_solve(b, s);
+    REQUIRE(s == X);
+
+    DenseMatrix inv(5, 5), I(5, 5), R(5, 5);
+    A.inv(inv);
+    D.mul_matrix(inv, R);
+    eye(I);
+    REQUIRE(R == I);
+
+    // Symbolic entries, checked at a point
+    A = CSRMatrix::from_coo(3, 3, {0, 0, 1, 1, 2, 2}, {0, 2, 1, 2, 0, 1},
+                            {x, integer(1), y, x, integer(2), integer(3)});
+    D = DenseMatrix(3, 3, {x, integer(0), integer(1), integer(0), y, x,
+                           integer(2), integer(3), integer(0)});
+    map_basic_basic m = {{x, integer(2)}, {y, integer(5)}};
+    REQUIRE(eq(*A.det()->subs(m), *D.det()->subs(m)));
+
+    // Singular matrices
+    A = CSRMatrix::from_coo(3, 3, {0, 1, 2}, {0, 0, 2},
+                            {integer(1), integer(2), integer(3)});
+    REQUIRE(eq(*A.det(), *integer(0)));
+    b = DenseMatrix(3, 1, {integer(1), integer(1), integer(1)});
+    s = DenseMatrix(3, 1);
+    CHECK_THROWS_AS(A.LU_solve(b, s), SymEngineException &);
+    A = CSRMatrix::from_coo(2, 2, {0, 0, 1, 1}, {0, 1, 0, 1},
+                            {integer(1), integer(2), integer(2), integer(4)});
+    REQUIRE(eq(*A.det(), *integer(0)));
+}
+
+TEST_CASE("NumericMatrix", "[matrices]")
+{
+    auto close = [](std::complex<double> a, std::complex<double> b) {
+        return std::abs(a - b) < 1e-10;
+    };
+    DenseMatrix A = DenseMatrix(
+        3, 3, {integer(4), integer(12), integer(-16), integer(12), integer(37),
+               integer(-43), integer(-16), integer(-43), real_double(98.0)});
+    RealDoubleMatrix N(A);
+    REQUIRE(N.nrows() == 3);
+    REQUIRE(N(2, 1) == -43.0);
+    REQUIRE(N.as_dense().get(2, 2)->__str__() == "98.0");
+    REQUIRE(std::abs(N.det() - 36.0) < 1e-10);
+
+    RealDoubleMatrix L = N.cholesky();
+    REQUIRE(L(0, 0) == 2.0);
+    REQUIRE(L(1, 0) == 6.0);
+    RealDoubleMatrix P = L.mul(L.transpose());
+    for (unsigned i = 0; i < 3; i++)
+        for (unsigned j = 0; j < 3; j++)
+            REQUIRE(close(P(i, j), N(i, j)));
+
+    RealDoubleMatrix b(3, 1);
+    b(0, 0) = 1;
+    b(1, 0) = 2;
+    b(2, 0) = 3;
+    RealDoubleMatrix x = N.solve(b), r = N.mul(x);
+    for (unsigned i = 0; i < 3; i++)
+        REQUIRE(close(r(i, 0), b(i, 0)));
+    P = N.mul(N.inv());
+    for (unsigned i = 0; i < 3; i++)
+        for (unsigned j = 0; j < 3; j++)
+            REQUIRE(close(P(i, j), i == j ? 1.0 : 0.0));
+
+    RealDoubleMatrix Q, R;
+    N.QR(Q, R);
+    REQUIRE(std::abs(R(2, 0)) < 1e-15);
+    P = Q.mul(R);
+    for (unsigned i = 0; i < 3; i++)
+        for (unsigned j = 0; j < 3; j++)
+            REQUIRE(close(P(i, j), N(i, j)));
+
+    // Rotation by 90 degrees, complex eigenvalues
+    RealDoubleMatrix M(DenseMatrix(
+        3, 3, {integer(0), integer(-1), integer(0), integer(1), integer(0),
+               integer(0), integer(0), integer(0), integer(5)}));
+    std::vector<std::complex<double>> e = M.eigenvalues();
+    REQUIRE(e.size() == 3);
+    std::sort(e.begin(), e.end(),
+              [](std::complex<double> a, std::complex<double> b) {
+                  return a.imag() < b.imag() or (a.imag() == b.imag()
+                                                 and a.real() < b.real());
+              });
+    REQUIRE(close(e[0], {0, -1}));
+    REQUIRE(close(e[2], {0, 1}));
+    REQUIRE(close(e[1], {5, 0}));
+
+    ComplexDoubleMatrix C(DenseMatrix(
+        2, 2, {Complex::from_two_nums(*integer(1), *integer(1)), integer(2),
+               integer(0), Complex::from_two_nums(*integer(0), *integer(3))}));
+    REQUIRE(close(C.det(), {-3, 3}));
+    e = C.eigenvalues();
+    REQUIRE(((close(e[0], {1, 1}) and close(e[1], {0, 3}))
+             or (close(e[1], {1, 1}) and close(e[0], {0, 3}))));
+
+    RCP<const Symbol> s = symbol("s"), t = symbol("t");
+    CHECK_THROWS_AS(RealDoubleMatrix(DenseMatrix(1, 1, {s})),
+                    SymEngineException &);
+    CHECK_THROWS_AS(RealDoubleMatrix(1, 1).cholesky(), SymEngineException &);
+    CHECK_THROWS_AS(RealDoubleMatrix(2, 2).solve(RealDoubleMatrix(2, 1)),
+                    SymEngineException &);
+
+    // Jacobian evaluated at a point
+    LambdaJacobian jac({mul(s, t), sin(s), add(t, integer(1))}, {s, t});
+    RealDoubleMatrix J;
+    const double point[] = {1.0, 2.0};
+    jac.call(J, point);
+    REQUIRE(J.nrows() == 3);
+    REQUIRE(J.ncols() == 2);
+    REQUIRE(J(0, 0) == 2.0);
+    REQUIRE(J(0, 1) == 1.0);
+    REQUIRE(close(J(1, 0), std::cos(1.0)));
+    REQUIRE(J(1, 1) == 0.0);
+    REQUIRE(J(2, 1) == 1.0);
+}
+
 TEST_CASE("free_symbols: MatrixBase", "[matrices]")
 {
     DenseMatrix A;
@@ -332,6 +332,51 @@ TEST_CASE("test_factor_pollard_rho_method(): ntheory", "[ntheory]")
 #endif
 }
 
+TEST_CASE("test_factor_ecm(): ntheory", "[ntheory]")
+{
+    RCP<const Integer> i1 = integer(1);
+    RCP<const Integer> i1001 = integer(1001);
+    RCP<const Integer> p = integer(integer_class("534439589207"));
+    RCP<const Integer> n = integer(
+        integer_class("450012202522411595091128006427434774892859"));
+    RCP<const Integer> f;
+
+    REQUIRE(factor_ecm(outArg(f), *n) > 0);
+    REQUIRE(eq(*f, *p));
+    REQUIRE(factor_ecm(outArg(f), *i1001, 100) > 0);
+    REQUIRE((divides(*i1001, *f) and not eq(*f, *i1) and not eq(*f, *i1001)));
+    // Needs the stage 2 primes between B1 and 2 * 210
+    n = integer(integer_class("101267000708869"));
+    REQUIRE(factor_ecm(outArg(f), *n, 50, 1) > 0);
+    REQUIRE(eq(*f, *integer(101267)));
+
+    CHECK_THROWS_AS(factor_ecm(outArg(f), *i1), SymEngineException &);
+}
+
+TEST_CASE("test_factor_siqs(): ntheory", "[ntheory]")
+{
+    RCP<const Integer> i1 = integer(1);
+    RCP<const Integer> i31 = integer(31);
+    RCP<const Integer> i900 = integer(900);
+    RCP<const Integer> n
+        = integer(integer_class("177414629690814939579005302357"));
+    RCP<const Integer> m = integer(
+        integer_class("929729977027117934816387551280601340919"));
+    RCP<const Integer> f;
+
+    REQUIRE(factor_siqs(outArg(f), *n) > 0);
+    REQUIRE((divides(*n, *f) and not eq(*f, *i1) and not eq(*f, *n)));
+    REQUIRE(factor_siqs(outArg(f), *m) > 0);
+    REQUIRE((divides(*m, *f) and not eq(*f, *i1) and not eq(*f, *m)));
+
+    CHECK_THROWS_AS(factor_siqs(outArg(f), *i31), SymEngineException &);
+    CHECK_THROWS_AS(factor_siqs(outArg(f), *i900), SymEngineException &);
+    // 2**400 + 1 is divisible by 2**80 + 1, but too large for the sieve
+    integer_class big = integer_class(1) << 400;
+    CHECK_THROWS_AS(factor_siqs(outArg(f), *integer(big + 1)),
+                    SymEngineException &);
+}
+
 TEST_CASE("test_sieve(): ntheory", "[ntheory]")
 {
     const int MAX = 100003;
@@ -364,6 +409,46 @@ TEST_CASE("test_sieve_iterator(): ntheory", "[ntheory]")
     REQUIRE(count == 9593);
 }
 
+TEST_CASE("test_sieve_segments(): ntheory", "[ntheory]")
+{
+    // Small segments, and extensions starting in the middle of them
+    SymEngine::Sieve::set_sieve_size(1);
+    SymEngine::Sieve::set_clear(false);
+    std::vector<unsigned> v;
+    for (unsigned limit : {1000u, 31000u, 31001u, 65537u, 1000000u}) {
+        v.clear();
+        SymEngine::Sieve::generate_primes(v, limit);
+    }
+    REQUIRE(v.size() == 78498);
+    for (unsigned i = 1; i < v.size(); i++) {
+        REQUIRE(v[i - 1] < v[i]);
+    }
+    for (unsigned n = 2, i = 0; n < 20000; n++) {
+        bool is_prime = true;
+        for (unsigned d = 2; d * d <= n; d++) {
+            if (n % d == 0) {
+                is_prime = false;
+                break;
+            }
+        }
+        REQUIRE(is_prime == (v[i] == n));
+        if (is_prime)
+            i++;
+    }
+
+    SymEngine::Sieve::iterator pi(2000000);
+    unsigned count = 0;
+    while (pi.next_prime() <= 2000000) {
+        count++;
+    }
+    REQUIRE(count == 148933);
+    REQUIRE(pi.next_prime() == 2000001);
+
+    SymEngine::Sieve::set_sieve_size(32);
+    SymEngine::Sieve::set_clear(true);
+    SymEngine::Sieve::clear();
+}
+
 // helper function for test_primefactors
 void _test_primefactors(const RCP<const Integer> &a, unsigned size)
 {
@@ -436,6 +521,22 @@ TEST_CASE("test_prime_factor_multiplicities(): ntheory", "[ntheory]")
     _test_prime_factor_multiplicities(i36);
     _test_prime_factor_multiplicities(i125);
     _test_prime_factor_multiplicities(i2357);
+
+    // Cofactors beyond trial division, split by Pollard's rho method and by
+    // the quadratic sieve
+    RCP<const Integer> n = integer(integer_class("8969607293875213171"));
+    RCP<const Integer> m = integer(
+        integer_class("929729977027117934816387551280601340919"));
+    RCP<const Integer> k
+        = rcp_dynamic_cast<const Integer>(mul(mul(n, n), mul(m, i12)));
+    _test_prime_factor_multiplicities(n);
+    _test_prime_factor_multiplicities(k);
+    map_integer_uint prime_mul;
+    prime_factor_multiplicities(prime_mul, *k);
+    REQUIRE(prime_mul.size() == 6);
+    REQUIRE(prime_mul[integer(2)] == 2);
+    REQUIRE(prime_mul[integer(2095513151)] == 2);
+    REQUIRE(prime_mul[integer(integer_class("88006894439558315659"))] == 1);
 }
 
 TEST_CASE("test_bernoulli(): ntheory", "[ntheory]")
@@ -721,6 +822,48 @@ TEST_CASE("test_powermod(): ntheory", "[ntheory]")
     REQUIRE(powms.size() == 6);
 }
 
+TEST_CASE("test_powermod_batch(): ntheory", "[ntheory]")
+{
+    std::vector<RCP<const Integer>> bases, powms;
+    for (int b = -3; b < 40; b += 3)
+        bases.push_back(integer(b));
+    // Odd and even moduli on words, and a modulus beyond them
+    std::vector<RCP<const Integer>> moduli
+        = {integer(105), integer(integer_class("9223372036854775783")),
+           integer(integer_class("4611686018427387904")),
+           integer(integer_class("18446744073709551557"))};
+    std::vector<RCP<const Integer>> exponents
+        = {integer(0), integer(1), integer(65537),
+           integer(integer_class("12345678901234567890"))};
+    integer_class t;
+    for (const auto &m : moduli) {
+        for (const auto &e : exponents) {
+            powms.clear();
+            powermod_batch(powms, bases, e, m);
+            REQUIRE(powms.size() == bases.size());
+            for (size_t i = 0; i < bases.size(); i++) {
+                const integer_class &b = bases[i]->as_integer_class();
+                SymEngine::mp_powm(t, b, e->as_integer_class(),
+                                   m->as_integer_class());
+                REQUIRE(powms[i]->as_integer_class() == t);
+            }
+        }
+    }
+    CHECK_THROWS_AS(powermod_batch(powms, bases, integer(-1), integer(7)),
+                    SymEngineException &);
+
+    // Mersenne prime 2**61 - 1
+    RCP<const Integer> p = integer(integer_class("2305843009213693951"));
+    RCP<const Integer> o;
+    REQUIRE(multiplicative_order(outArg(o), integer(2), p));
+    REQUIRE(eq(*o, *integer(61)));
+    std::vector<RCP<const Integer>> roots;
+    nthroot_mod_list(roots, integer(4), integer(2), p);
+    REQUIRE(roots.size() == 2);
+    REQUIRE(eq(*roots[0], *integer(2)));
+    REQUIRE(eq(*roots[1], *p->subint(*integer(2))));
+}
+
 TEST_CASE("test_quadratic_residues(): ntheory", "[ntheory]")
 {
 
@@ -159,6 +159,48 @@ TEST_CASE("Multiplication of two UIntPoly", "[UIntPoly]")
     CHECK_THROWS_AS(mul_upoly(*a, *c), SymEngineException &);
 }
 
+TEST_CASE("Dense multiplication of UIntPoly", "[UIntPoly]")
+{
+    // Signed coefficients of up to about 200 bits
+    integer_class seed(12345), big(1);
+    big <<= 200;
+    auto next = [&]() {
+        seed = (seed * 6364136223846793005_z + 1442695040888963407_z) % big;
+        integer_class r = seed % 180;
+        return (seed % 2 == 0) ? integer_class(seed >> mp_get_ui(r)) : -seed;
+    };
+    for (unsigned la : {1, 3, 17, 50, 130}) {
+        for (unsigned lb : {2, 16, 49, 150}) {
+            vec_integer_class a(la), b(lb);
+            for (auto &c : a)
+                c = next();
+            for (auto &c : b)
+                c = next();
+            vec_integer_class r = SymEngine::mul_dense_schoolbook(a, b);
+            REQUIRE(r.size() == la + lb - 1);
+            REQUIRE(SymEngine::mul_dense_karatsuba(a, b) == r);
+            REQUIRE(SymEngine::mul_dense_toom3(a, b) == r);
+            REQUIRE(SymEngine::mul_dense_kronecker(a, b) == r);
+            REQUIRE(SymEngine::mul_dense_upoly(a, b) == r);
+            for (size_t n : {1, 10, 64, 200}) {
+                vec_integer_class low(r.begin(),
+                                      r.begin() + std::min(n, r.size()));
+                REQUIRE(SymEngine::mullow_dense_upoly(a, b, n) == low);
+            }
+        }
+    }
+
+    RCP<const Symbol> x = symbol("x");
+    RCP<const UIntPoly> a = UIntPoly::from_dict(x, {{0, 1_z}, {1, 1_z}});
+    RCP<const UIntPoly> b = UIntPoly::from_dict(x, {{0, 1_z}, {1, -1_z}});
+    RCP<const UIntPoly> c = UIntPoly::from_dict(x, {{0, 1_z}, {2, -1_z}});
+    RCP<const UIntPoly> d
+        = mul_upoly(*pow_upoly(*a, 100), *pow_upoly(*b, 100));
+    REQUIRE(eq(*d, *pow_upoly(*c, 100)));
+    REQUIRE(d->get_poly().size() == 101);
+    REQUIRE(d->get_coeff(100) == 100891344545564193334812497256_z);
+}
+
 TEST_CASE("Comparing two UIntPoly", "[UIntPoly]")
 {
     RCP<const Symbol> x = symbol("x");
@@ -54,6 +54,9 @@ using SymEngine::C99CodePrinter;
 using SymEngine::JSCodePrinter;
 using SymEngine::ccode;
 using SymEngine::jscode;
+using SymEngine::ccode_function;
+using SymEngine::mul;
+using SymEngine::SymEngineException;
 
 TEST_CASE("C-code printers", "[CodePrinter]")
 {
@@ -204,3 +207,25 @@ TEST_CASE("JavaScript math functions", "[jscode]")
     JSCodePrinter JS;
     REQUIRE(JS.apply(pi) == "Math.PI");
 }
+
+TEST_CASE("Function with common subexpressions", "[ccode]")
+{
+    auto x = symbol("x");
+    auto y = symbol("y");
+    auto s = sin(add(x, y));
+    auto e1 = add(mul(s, s), x);
+    auto e2 = add(s, y);
+    auto e3 = cos(x);
+
+    std::string code = ccode_function("f", {x, y}, {e1, e2, e3});
+    REQUIRE(code == "void f(double *out, const double *in)\n"
+                    "{\n"
+                    "    const double x0 = sin(in[0] + in[1]);\n"
+                    "    out[0] = in[0] + pow(x0, 2);\n"
+                    "    out[1] = in[1] + x0;\n"
+                    "    out[2] = cos(in[0]);\n"
+                    "}\n");
+
+    CHECK_THROWS_AS(ccode_function("f", {add(x, y)}, {e1}),
+                    SymEngineException &);
+}
@@ -1,12 +1,22 @@
 #include "catch.hpp"
 
 #include <symengine/symengine_rcp.h>
+#include <symengine/allocator.h>
+#include <symengine/symbol.h>
+
+#ifdef WITH_SYMENGINE_THREAD_SAFE
+#include <thread>
+#include <vector>
+#endif
 
 using SymEngine::RCP;
 using SymEngine::make_rcp;
 using SymEngine::Ptr;
 using SymEngine::null;
 using SymEngine::EnableRCPFromThis;
+using SymEngine::node_allocate;
+using SymEngine::node_deallocate;
+using SymEngine::ArenaScope;
 
 // This is the canonical use of EnableRCPFromThis:
 
@@ -110,3 +120,109 @@ TEST_CASE("Test rcp_from_this const 2", "[rcp]")
     f2_hybrid(*m2);
     REQUIRE(m2->use_count() == 1);
 }
+
+class Node : public EnableRCPFromThis<Node>
+{
+public:
+    int x;
+    static void *operator new(std::size_t size)
+    {
+        return node_allocate(size);
+    }
+    static void operator delete(void *p, std::size_t size)
+    {
+        node_deallocate(p, size);
+    }
+};
+
+TEST_CASE("Test node pools", "[rcp]")
+{
+    void *p1 = node_allocate(40);
+    void *p2 = node_allocate(48);
+    REQUIRE(p1 != p2);
+    node_deallocate(p1, 40);
+    // The free block is reused for a request of the same size class
+    void *p3 = node_allocate(33);
+    REQUIRE(p3 == p1);
+    node_deallocate(p2, 48);
+    node_deallocate(p3, 33);
+
+    void *big = node_allocate(SymEngine::node_pool_max_size + 1);
+    node_deallocate(big, SymEngine::node_pool_max_size + 1);
+
+    RCP<Node> n = make_rcp<Node>();
+    n->x = 5;
+    RCP<Node> n2 = n;
+    n.reset();
+    REQUIRE(n2->x == 5);
+}
+
+TEST_CASE("Test arena scope", "[rcp]")
+{
+    RCP<Node> kept;
+    {
+        ArenaScope scope;
+        RCP<Node> n = make_rcp<Node>();
+        void *p = node_allocate(64);
+        REQUIRE(scope.allocated_bytes() >= 64 + sizeof(Node));
+        {
+            ArenaScope inner;
+            RCP<Node> m = make_rcp<Node>();
+            REQUIRE(inner.allocated_bytes() >= sizeof(Node));
+            REQUIRE(scope.allocated_bytes() < 64 + 2 * sizeof(Node) + 32);
+        }
+        node_deallocate(p, 64);
+        kept = make_rcp<Node>();
+        kept->x = 7;
+    }
+    // The arena is alive as long as one of its nodes is
+    REQUIRE(kept->x == 7);
+    kept.reset();
+
+    void *p = node_allocate(64);
+    REQUIRE(p != nullptr);
+    node_deallocate(p, 64);
+}
+
+#ifdef WITH_SYMENGINE_POOL_ALLOCATOR
+TEST_CASE("Test pool allocation of Basic", "[rcp]")
+{
+    const void *p;
+    {
+        RCP<const SymEngine::Symbol> x = SymEngine::symbol("x");
+        p = x.get();
+    }
+    // The block of the freed node is the first one reused
+    RCP<const SymEngine::Symbol> y = SymEngine::symbol("y");
+    REQUIRE(y.get() == p);
+    {
+        ArenaScope scope;
+        RCP<const SymEngine::Symbol> z = SymEngine::symbol("z");
+        REQUIRE(scope.allocated_bytes() >= sizeof(SymEngine::Symbol));
+    }
+}
+#endif
+
+#ifdef WITH_SYMENGINE_THREAD_SAFE
+TEST_CASE("Test node pools with threads", "[rcp]")
+{
+    const std::size_t size = 200;
+    std::vector<void *> blocks(100);
+    std::thread([&]() {
+        for (auto &p : blocks)
+            p = node_allocate(size);
+    }).join();
+    // This thread only frees blocks allocated by the one above, its free
+    // list is handed over when it exits
+    std::thread([&]() {
+        for (auto p : blocks)
+            node_deallocate(p, size);
+    }).join();
+    void *q = nullptr;
+    std::thread([&]() {
+        q = node_allocate(size);
+        node_deallocate(q, size);
+    }).join();
+    REQUIRE(q == blocks.back());
+}
+#endif